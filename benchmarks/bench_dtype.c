@@ -0,0 +1,79 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* Reduced-precision storage: the same kernels fed float32, float16 and bfloat16 operands. The
+ * figure of merit for memory-bound shapes is bytes moved, which halves with 16-bit storage. */
+
+typedef struct {
+    Tensor a, b;
+} DtypeCtx;
+
+static void run_matmul(void* p) {
+    DtypeCtx* ctx = p;
+    Tensor_matmul(ctx->a, ctx->b);
+}
+
+static void run_add(void* p) {
+    DtypeCtx* ctx = p;
+    Tensor_add(ctx->a, ctx->b);
+}
+
+static void run_sum(void* p) {
+    DtypeCtx* ctx = p;
+    Tensor_sum(ctx->a);
+}
+
+static const char* dtype_name(TensorDType dtype) {
+    switch(dtype) {
+        case TensorDType_F16: return "f16";
+        case TensorDType_BF16: return "bf16";
+        default: return "f32";
+    }
+}
+
+void bench_dtype() {
+    const char* suite = "dtype";
+    PoolId pool_id = 1;
+    const TensorDType dtypes[] = {TensorDType_F32, TensorDType_F16, TensorDType_BF16};
+    const int k = 1024, n = 1024, numel = 1 << 20;
+
+    for(int d = 0; d < 3; d++) {
+        TensorDType dtype = dtypes[d];
+        double mib = (double)numel * (dtype == TensorDType_F32 ? 4 : 2) / (1 << 20);
+        char name[64];
+
+        // batch-1 inference: streaming the weight matrix dominates
+        cten_begin_malloc(pool_id);
+        DtypeCtx gemv;
+        gemv.a = Tensor_new((TensorShape){1, k}, false);
+        gemv.b = Tensor_new((TensorShape){k, n}, false);
+        bench_fill_random(gemv.a);
+        bench_fill_random(gemv.b);
+        gemv.b = Tensor_to(gemv.b, dtype);
+
+        DtypeCtx elem;
+        elem.a = Tensor_new((TensorShape){numel}, false);
+        elem.b = Tensor_new((TensorShape){numel}, false);
+        bench_fill_random(elem.a);
+        bench_fill_random(elem.b);
+        elem.a = Tensor_to(elem.a, dtype);
+        elem.b = Tensor_to(elem.b, dtype);
+        cten_end_malloc();
+
+        snprintf(name,
+                 sizeof(name),
+                 "gemv [1,%d]@[%d,%d] W=%s %.0fMiB",
+                 k,
+                 k,
+                 n,
+                 dtype_name(dtype),
+                 mib);
+        bench_report(suite, name, bench_measure(run_matmul, &gemv, 2, 200), 2.0 * k * n, "GFLOPS");
+        snprintf(name, sizeof(name), "add n=%d %s %.0fMiB/operand", numel, dtype_name(dtype), mib);
+        bench_report(suite, name, bench_measure(run_add, &elem, 2, 200), numel, "Gelem/s");
+        snprintf(name, sizeof(name), "sum n=%d %s", numel, dtype_name(dtype));
+        bench_report(suite, name, bench_measure(run_sum, &elem, 2, 200), numel, "Gelem/s");
+
+        cten_free(pool_id);
+    }
+}
@@ -0,0 +1,99 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* Throughput of elementwise kernels on tensors large enough that loop code, not bookkeeping,
+ * dominates. */
+
+typedef struct {
+    Tensor a, b;
+} ElementwiseCtx;
+
+static void run_add(void* p) {
+    ElementwiseCtx* ctx = p;
+    Tensor_add(ctx->a, ctx->b);
+}
+
+static void run_mul(void* p) {
+    ElementwiseCtx* ctx = p;
+    Tensor_mul(ctx->a, ctx->b);
+}
+
+static void run_relu(void* p) {
+    ElementwiseCtx* ctx = p;
+    nn_relu(ctx->a);
+}
+
+static void run_div(void* p) {
+    ElementwiseCtx* ctx = p;
+    Tensor_div(ctx->a, ctx->b);
+}
+
+static void run_sum(void* p) {
+    ElementwiseCtx* ctx = p;
+    Tensor_sum(ctx->a);
+}
+
+void bench_elementwise() {
+    const char* suite = "elementwise";
+    PoolId pool_id = 1;
+    const int sizes[] = {1024, 65536, 1048576};
+
+    for(int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        cten_begin_malloc(pool_id);
+        ElementwiseCtx ctx;
+        ctx.a = Tensor_new((TensorShape){sizes[s]}, false);
+        ctx.b = Tensor_new((TensorShape){sizes[s]}, false);
+        bench_fill_random(ctx.a);
+        bench_fill_random(ctx.b);
+        cten_end_malloc();
+
+        int batch = sizes[s] >= 1048576 ? 2 : 20;
+        double n = sizes[s];
+        char name[64];
+        snprintf(name, sizeof(name), "add n=%d", sizes[s]);
+        bench_report(suite, name, bench_measure(run_add, &ctx, batch, 200), n, "Gelem/s");
+        snprintf(name, sizeof(name), "mul n=%d", sizes[s]);
+        bench_report(suite, name, bench_measure(run_mul, &ctx, batch, 200), n, "Gelem/s");
+        snprintf(name, sizeof(name), "relu n=%d", sizes[s]);
+        bench_report(suite, name, bench_measure(run_relu, &ctx, batch, 200), n, "Gelem/s");
+        snprintf(name, sizeof(name), "sum n=%d", sizes[s]);
+        bench_report(suite, name, bench_measure(run_sum, &ctx, batch, 200), n, "Gelem/s");
+
+        cten_free(pool_id);
+    }
+
+    // the same kernels at every instruction set level this CPU supports, on L2-resident data
+    cten_SimdLevel best = cten_simd_level();
+    cten_begin_malloc(pool_id);
+    ElementwiseCtx ctx;
+    int n = 65536;
+    ctx.a = Tensor_new((TensorShape){n}, false);
+    ctx.b = Tensor_new((TensorShape){n}, false);
+    bench_fill_random(ctx.a);
+    bench_fill_random(ctx.b);
+    cten_end_malloc();
+    const struct {
+        const char* name;
+        void (*run)(void*);
+    } ops[] = {
+        {"add",      run_add          },
+        {"mul",      run_mul          },
+        {"relu",     run_relu         },
+        {"div",      run_div          },
+    };
+    for(int level = cten_SimdLevel_Scalar; level <= (int)best; level++) {
+        cten_set_simd_level((cten_SimdLevel)level);
+        for(int i = 0; i < (int)(sizeof(ops) / sizeof(ops[0])); i++) {
+            char name[64];
+            snprintf(name,
+                     sizeof(name),
+                     "%s n=%d %s",
+                     ops[i].name,
+                     n,
+                     cten_simd_level_name((cten_SimdLevel)level));
+            bench_report(suite, name, bench_measure(ops[i].run, &ctx, 20, 200), n, "Gelem/s");
+        }
+    }
+    cten_set_simd_level(best);
+    cten_free(pool_id);
+}
@@ -0,0 +1,197 @@
+#include "bench_utils.h"
+#include <math.h>
+#include <stdio.h>
+
+/* Convergence against throughput of Hogwild training. Each task trains the same initial model for
+ * a fixed number of minibatch steps, once with optim_sgd on one graph per step and then with
+ * nn_hogwild from one worker per thread up to the hardware count (at least two), and reports the
+ * samples per second along with the quality reached: the full-dataset loss of the src2/main.c
+ * sine regression, and the training accuracy of an Iris classifier. */
+
+typedef struct {
+    Tensor w1, b1;
+    Tensor w2, b2;
+    Tensor w3, b3;
+} HogwildModel;
+
+typedef struct {
+    const char* name;
+    int sizes[4];  // inputs, hidden layers and outputs
+    nn_ShardLoss loss_fn;
+    float (*quality)(HogwildModel* m, Tensor x, Tensor y);
+    const char* quality_name;
+    int batch;
+    int n_steps;
+    float lr;
+    float momentum;
+    Tensor x, y;
+} HogwildTask;
+
+static Tensor forward(HogwildModel* m, Tensor x) {
+    x = nn_elu(nn_linear(x, m->w1, m->b1), 1.0f);
+    x = nn_elu(nn_linear(x, m->w2, m->b2), 1.0f);
+    return nn_linear(x, m->w3, m->b3);
+}
+
+static Tensor sine_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    (void)user;
+    Tensor y_pred = forward((HogwildModel*)params, x);
+    return Tensor_add(nn_huber_loss(y, y_pred, 1.0f), Tensor_mulf(nn_mae_loss(y, y_pred), 0.3f));
+}
+
+static float sine_quality(HogwildModel* m, Tensor x, Tensor y) {
+    return sine_loss((Tensor*)m, x, y, NULL).data->flex[0];
+}
+
+static Tensor iris_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    (void)user;
+    return nn_softmax_crossentropy(y, forward((HogwildModel*)params, x));
+}
+
+static float iris_quality(HogwildModel* m, Tensor x, Tensor y) {
+    int pred[150];
+    Tensor_argmax(forward(m, x), pred);
+    int correct = 0;
+    for(int i = 0; i < x.shape[0]; i++) {
+        correct += pred[i] == y.data->flexi[i];
+    }
+    return (float)correct / (float)x.shape[0];
+}
+
+static HogwildModel new_model(const int* sizes) {
+    cten_seed(1);
+    HogwildModel m;
+    m.w1 = Glorot_init((TensorShape){sizes[0], sizes[1]}, true);
+    m.b1 = Tensor_zeros((TensorShape){1, sizes[1]}, true);
+    m.w2 = Glorot_init((TensorShape){sizes[1], sizes[2]}, true);
+    m.b2 = Tensor_zeros((TensorShape){1, sizes[2]}, true);
+    m.w3 = Glorot_init((TensorShape){sizes[2], sizes[3]}, true);
+    m.b3 = Tensor_zeros((TensorShape){1, sizes[3]}, true);
+    return m;
+}
+
+// Minibatch SGD over the batches in the order nn_hogwild_train() takes them with one worker
+static void train_serial(HogwildTask* t, HogwildModel* m, optim_sgd* opt, PoolId step_pool) {
+    int n = t->x.shape[0], n_batches = (n + t->batch - 1) / t->batch;
+    int row = t->x.numel / n;
+    for(int s = 0; s < t->n_steps; s++) {
+        int lo = s % n_batches * t->batch, hi = lo + t->batch < n ? lo + t->batch : n;
+        cten_begin_malloc(step_pool);
+        Tensor x = Tensor_from_buffer((TensorShape){hi - lo, row},
+                                      t->x.data->flex + lo * row,
+                                      FloatBuffer_ReadOnly);
+        Tensor y = t->y.data->dtype == TensorDType_I32
+                       ? Tensor_from_int_buffer((TensorShape){hi - lo},
+                                                t->y.data->flexi + lo,
+                                                FloatBuffer_ReadOnly)
+                       : Tensor_from_buffer((TensorShape){hi - lo, 1},
+                                            t->y.data->flex + lo,
+                                            FloatBuffer_ReadOnly);
+        optim_sgd_zerograd(opt);
+        Tensor_backward(t->loss_fn((Tensor*)m, x, y, NULL), (Tensor){0});
+        optim_sgd_step(opt);
+        cten_end_malloc();
+        cten_free(step_pool);
+    }
+}
+
+static void report(HogwildTask* t, HogwildModel* m, const char* name, int64_t ns) {
+    cten_begin_eval();
+    float quality = t->quality(m, t->x, t->y);
+    cten_end_eval();
+    char full[64];
+    snprintf(full, sizeof(full), "%s %s", t->name, name);
+    bench_report("hogwild", full, (double)ns / t->n_steps, t->batch * 1e3, "Msample/s");
+    printf("%-12s %-36s %s %.4f after %d steps\n",
+           "hogwild",
+           full,
+           t->quality_name,
+           quality,
+           t->n_steps);
+}
+
+static void run_task(HogwildTask* t, PoolId pool_id, int max_threads) {
+    cten_begin_malloc(pool_id);
+    HogwildModel m = new_model(t->sizes);
+    optim_sgd* opt = optim_sgd_new(6, (Tensor*)&m, 0.0f);
+    optim_sgd_config(opt, t->lr, t->momentum);
+    cten_end_malloc();
+    cten_set_num_threads(1);
+    int64_t start = bench_now_ns();
+    train_serial(t, &m, opt, pool_id + 1);
+    report(t, &m, "sgd one graph", bench_now_ns() - start);
+
+    for(int threads = 1; threads <= max_threads;
+        threads = bench_next_threads(threads, max_threads)) {
+        cten_set_num_threads(threads);
+        cten_begin_malloc(pool_id);
+        m = new_model(t->sizes);
+        cten_end_malloc();
+        nn_hogwild* hw = nn_hogwild_new(6, (Tensor*)&m, threads, 0.0f);
+        nn_hogwild_config(hw, t->lr, t->momentum);
+        start = bench_now_ns();
+        nn_hogwild_train(hw, t->loss_fn, NULL, t->x, t->y, t->batch, t->n_steps);
+        int64_t ns = bench_now_ns() - start;
+        nn_hogwild_free(hw);
+        char name[32];
+        snprintf(name, sizeof(name), "workers=%d", threads);
+        report(t, &m, name, ns);
+    }
+}
+
+void bench_hogwild() {
+    PoolId pool_id = 1;
+    int saved_threads = cten_num_threads();
+    int max_threads = cten_set_num_threads(0);
+    if(max_threads < 2) max_threads = 2;
+
+    // the src2/main.c regression: sin(x) on [-2pi, 2pi)
+    cten_begin_malloc(pool_id);
+    HogwildTask sine = {
+        .name = "sine",
+        .sizes = {1, 64, 32, 1},
+        .loss_fn = sine_loss,
+        .quality = sine_quality,
+        .quality_name = "loss",
+        .batch = 64,
+        .n_steps = 2000,
+        .lr = 0.01f,
+        .momentum = 0.9f,
+        .x = Tensor_new((TensorShape){2048, 1}, false),
+        .y = Tensor_new((TensorShape){2048, 1}, false),
+    };
+    bench_fill_random(sine.x);
+    for(int i = 0; i < 2048; i++) {
+        sine.x.data->flex[i] *= 6.2831853f;
+        sine.y.data->flex[i] = sinf(sine.x.data->flex[i]);
+    }
+    cten_end_malloc();
+    run_task(&sine, pool_id, max_threads);
+
+    // Iris, normalized and shuffled once
+    const float(*X)[4];
+    const int* labels;
+    int n = load_iris_dataset(&X, &labels);
+    float X_norm[150][4], X_shuffled[150][4];
+    int y_shuffled[150];
+    Tensor_normalize_dataset(X, X_norm, n, n, 4);
+    cten_seed(2);
+    Tensor_shuffle_dataset((const float(*)[4])X_norm, labels, X_shuffled, y_shuffled, n, 4);
+    HogwildTask iris = {
+        .name = "iris",
+        .sizes = {4, 16, 16, 3},
+        .loss_fn = iris_loss,
+        .quality = iris_quality,
+        .quality_name = "accuracy",
+        .batch = 10,
+        .n_steps = 3000,
+        .lr = 0.1f,
+        .momentum = 0.5f,
+        .x = Tensor_from_buffer((TensorShape){n, 4}, (float*)X_shuffled, FloatBuffer_ReadOnly),
+        .y = Tensor_from_int_buffer((TensorShape){n}, (int32_t*)y_shuffled, FloatBuffer_ReadOnly),
+    };
+    run_task(&iris, pool_id, max_threads);
+
+    cten_free(pool_id);
+    cten_set_num_threads(saved_threads);
+}
@@ -0,0 +1,99 @@
+#include "bench_utils.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+/* exp, log and the activations built on them in both accuracy modes: throughput on L1-resident
+ * data, where the math rather than memory sets the pace, and the largest error of each mode
+ * against a double-precision reference. */
+
+typedef struct {
+    Tensor x;
+    int op;
+} MathCtx;
+
+static const char* const op_names[] = {"exp", "log", "sigmoid", "tanh", "elu"};
+
+static Tensor apply(int op, Tensor x) {
+    switch(op) {
+        case 0: return nn_exp(x);
+        case 1: return nn_log(x);
+        case 2: return nn_sigmoid(x);
+        case 3: return nn_tanh(x);
+        default: return nn_elu(x, 1.0f);
+    }
+}
+
+static double reference(int op, double x) {
+    switch(op) {
+        case 0: return exp(x);
+        case 1: return log(x);
+        case 2: return 1.0 / (1.0 + exp(-x));
+        case 3: return tanh(x);
+        default: return x > 0 ? x : expm1(x);
+    }
+}
+
+static void run_op(void* p) {
+    MathCtx* ctx = p;
+    apply(ctx->op, ctx->x);
+}
+
+// largest error in units in the last place, over outputs in the normal range
+static double max_ulp_error(int op, Tensor x) {
+    Tensor y = apply(op, x);
+    double max_err = 0.0;
+    for(size_t i = 0; i < x.numel; i++) {
+        double ref = reference(op, x.data->flex[i]);
+        if(fabs(ref) < FLT_MIN) continue;
+        int exponent;
+        frexp(ref, &exponent);
+        max_err = fmax(max_err, fabs(y.data->flex[i] - ref) / ldexp(1.0, exponent - 24));
+    }
+    return max_err;
+}
+
+void bench_math() {
+    const char* suite = "math";
+    PoolId pool_id = 1;
+    const int n = 4096;
+    cten_MathMode mode = cten_math_mode();
+
+    for(int op = 0; op < 5; op++) {
+        cten_begin_malloc(pool_id);
+        MathCtx ctx = {Tensor_new((TensorShape){n}, false), op};
+        bench_fill_random(ctx.x);
+        for(int i = 0; i < n; i++) {
+            float u = ctx.x.data->flex[i];
+            // log takes positive inputs spread over 1e-9..1e9, the others span their curved range
+            ctx.x.data->flex[i] = op == 1 ? expf(20.0f * u) : 10.0f * u;
+        }
+
+        double ns[2], err[2];
+        for(int m = 0; m < 2; m++) {
+            cten_set_math_mode(m == 0 ? cten_MathMode_Precise : cten_MathMode_Fast);
+            err[m] = max_ulp_error(op, ctx.x);
+            ns[m] = bench_measure(run_op, &ctx, 20, 200);
+            char name[64];
+            snprintf(name,
+                     sizeof(name),
+                     "%s n=%d %s",
+                     op_names[op],
+                     n,
+                     m == 0 ? "precise" : "fast");
+            bench_report(suite, name, ns[m], n, "Gelem/s");
+        }
+        cten_end_malloc();
+
+        char name[64];
+        snprintf(name, sizeof(name), "%s n=%d", op_names[op], n);
+        printf("%-12s %-36s speedup %.2fx max_err precise %.2f ulp fast %.2f ulp\n",
+               suite,
+               name,
+               ns[0] / ns[1],
+               err[0],
+               err[1]);
+        cten_free(pool_id);
+    }
+    cten_set_math_mode(mode);
+}
@@ -0,0 +1,203 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* GEMM throughput for square and MLP-style skinny shapes, then batched products of many small
+ * matrices and of a batch against one shared weight, then nn_linear forward and backward,
+ * alone and with a ReLU either as a separate op or fused into the GEMM epilogue. */
+
+typedef struct {
+    Tensor a, b;
+} MatmulCtx;
+
+typedef struct LinearCtx {
+    Tensor x, w, b;
+    Tensor (*layer)(struct LinearCtx* ctx);
+    optim_sgd* optimizer;
+} LinearCtx;
+
+static void run_matmul(void* p) {
+    MatmulCtx* ctx = p;
+    Tensor_matmul(ctx->a, ctx->b);
+}
+
+static Tensor layer_linear(LinearCtx* ctx) { return nn_linear(ctx->x, ctx->w, ctx->b); }
+
+static Tensor layer_relu_unfused(LinearCtx* ctx) {
+    return nn_relu(Tensor_add(Tensor_matmul(ctx->x, ctx->w), ctx->b));
+}
+
+static Tensor layer_relu_fused(LinearCtx* ctx) {
+    return nn_linear_act(ctx->x, ctx->w, ctx->b, nn_Activation_ReLU);
+}
+
+static void run_linear_forward(void* p) {
+    LinearCtx* ctx = p;
+    ctx->layer(ctx);
+}
+
+static void run_linear_step(void* p) {
+    LinearCtx* ctx = p;
+    optim_sgd_zerograd(ctx->optimizer);
+    Tensor_backward(Tensor_sum(ctx->layer(ctx)), (Tensor){0});
+}
+
+// backward time is reported as forward+backward minus forward, both measured on the same layer
+static void bench_linear(const char* suite, PoolId pool_id) {
+    // {batch, in, out}
+    const int shapes[][3] = {
+        {1,   64,  32 },
+        {64,  64,  32 },
+        {64,  784, 256},
+        {256, 256, 256},
+    };
+    const struct {
+        const char* name;
+        Tensor (*layer)(LinearCtx* ctx);
+    } layers[] = {
+        {"linear",      layer_linear      },
+        {"linear+relu", layer_relu_unfused},
+        {"fused relu",  layer_relu_fused  },
+    };
+    for(int s = 0; s < (int)(sizeof(shapes) / sizeof(shapes[0])); s++) {
+        int batch = shapes[s][0], in = shapes[s][1], out = shapes[s][2];
+        cten_begin_malloc(pool_id);
+        LinearCtx ctx;
+        ctx.x = Tensor_new((TensorShape){batch, in}, true);
+        ctx.w = Glorot_init((TensorShape){in, out}, true);
+        ctx.b = Tensor_zeros((TensorShape){1, out}, true);
+        bench_fill_random(ctx.x);
+        Tensor params[] = {ctx.x, ctx.w, ctx.b};
+        ctx.optimizer = optim_sgd_new(3, params, 0.0f);
+        cten_end_malloc();
+
+        double flops = 2.0 * batch * in * out;
+        int calls = flops > 1e7 ? 1 : 20;
+        for(int l = 0; l < (int)(sizeof(layers) / sizeof(layers[0])); l++) {
+            ctx.layer = layers[l].layer;
+            double fwd_ns = bench_measure(run_linear_forward, &ctx, calls, 200);
+            double step_ns = bench_measure(run_linear_step, &ctx, calls, 200);
+            char shape[32], name[64];
+            snprintf(shape, sizeof(shape), "[%d,%d]x[%d,%d]", batch, in, in, out);
+            snprintf(name, sizeof(name), "%s %s fwd", layers[l].name, shape);
+            bench_report(suite, name, fwd_ns, flops, "GFLOPS");
+            // the backward computes both dX and dW, twice the forward's work
+            snprintf(name, sizeof(name), "%s %s bwd", layers[l].name, shape);
+            bench_report(suite, name, step_ns - fwd_ns, 2.0 * flops, "GFLOPS");
+        }
+
+        cten_free(pool_id);
+    }
+}
+
+// inference through the same weight, repacked on every call and then kept packed
+static void bench_linear_packed(const char* suite, PoolId pool_id) {
+    // {batch, in, out}
+    const int shapes[][3] = {
+        {1,  64,  32 },
+        {1,  784, 256},
+        {8,  784, 256},
+        {64, 784, 256},
+    };
+    for(int s = 0; s < (int)(sizeof(shapes) / sizeof(shapes[0])); s++) {
+        int batch = shapes[s][0], in = shapes[s][1], out = shapes[s][2];
+        cten_begin_malloc(pool_id);
+        LinearCtx ctx;
+        ctx.x = Tensor_new((TensorShape){batch, in}, false);
+        ctx.w = Glorot_init((TensorShape){in, out}, false);
+        ctx.b = Tensor_zeros((TensorShape){1, out}, false);
+        ctx.layer = layer_linear;
+        bench_fill_random(ctx.x);
+        cten_end_malloc();
+
+        double flops = 2.0 * batch * in * out;
+        int calls = flops > 1e7 ? 1 : 20;
+        char shape[32], name[64];
+        snprintf(shape, sizeof(shape), "[%d,%d]x[%d,%d]", batch, in, in, out);
+        cten_begin_eval();
+        double plain_ns = bench_measure(run_linear_forward, &ctx, calls, 200);
+        cten_begin_malloc(pool_id);
+        Tensor_pack_weight(ctx.w, false);
+        cten_end_malloc();
+        double packed_ns = bench_measure(run_linear_forward, &ctx, calls, 200);
+        cten_end_eval();
+        snprintf(name, sizeof(name), "eval linear %s", shape);
+        bench_report(suite, name, plain_ns, flops, "GFLOPS");
+        snprintf(name, sizeof(name), "eval packed %s", shape);
+        bench_report(suite, name, packed_ns, flops, "GFLOPS");
+
+        cten_free(pool_id);
+    }
+}
+
+void bench_matmul() {
+    const char* suite = "matmul";
+    PoolId pool_id = 1;
+    // {m, k, n}: square sizes, then batch x features shapes typical of small MLPs
+    const int shapes[][3] = {
+        {8,    8,   8  },
+        {32,   32,  32 },
+        {128,  128, 128},
+        {256,  256, 256},
+        {512,  512, 512},
+        {64,   1,   64 },
+        {64,   64,  32 },
+        {256,  64,  3  },
+        {1,    64,  32 },
+        {4,    256, 256},
+        {1024, 128, 64 },
+        {64,   784, 256},
+        {2048, 64,  64 },
+    };
+
+    for(int s = 0; s < (int)(sizeof(shapes) / sizeof(shapes[0])); s++) {
+        int m = shapes[s][0], k = shapes[s][1], n = shapes[s][2];
+        cten_begin_malloc(pool_id);
+        MatmulCtx ctx;
+        ctx.a = Tensor_new((TensorShape){m, k}, false);
+        ctx.b = Tensor_new((TensorShape){k, n}, false);
+        bench_fill_random(ctx.a);
+        bench_fill_random(ctx.b);
+        cten_end_malloc();
+
+        double flops = 2.0 * m * k * n;
+        int batch = flops > 1e7 ? 1 : 20;
+        char name[64];
+        snprintf(name, sizeof(name), "[%d,%d]@[%d,%d]", m, k, k, n);
+        bench_report(suite, name, bench_measure(run_matmul, &ctx, batch, 200), flops, "GFLOPS");
+
+        cten_free(pool_id);
+    }
+
+    // {batch, m, k, n, shared}: shared multiplies every batch by one [k, n] weight
+    const int batched[][5] = {
+        {256, 8,  8,  8,  0},
+        {64,  16, 64, 16, 0},
+        {16,  32, 64, 64, 1},
+    };
+    for(int s = 0; s < (int)(sizeof(batched) / sizeof(batched[0])); s++) {
+        int bs = batched[s][0], m = batched[s][1], k = batched[s][2], n = batched[s][3];
+        bool shared = batched[s][4];
+        cten_begin_malloc(pool_id);
+        MatmulCtx ctx;
+        ctx.a = Tensor_new((TensorShape){bs, m, k}, false);
+        ctx.b = shared ? Tensor_new((TensorShape){k, n}, false)
+                       : Tensor_new((TensorShape){bs, k, n}, false);
+        bench_fill_random(ctx.a);
+        bench_fill_random(ctx.b);
+        cten_end_malloc();
+
+        double flops = 2.0 * bs * m * k * n;
+        char name[64];
+        if(shared) {
+            snprintf(name, sizeof(name), "[%d,%d,%d]@[%d,%d]", bs, m, k, k, n);
+        } else {
+            snprintf(name, sizeof(name), "[%d,%d,%d]@[%d,%d,%d]", bs, m, k, bs, k, n);
+        }
+        bench_report(suite, name, bench_measure(run_matmul, &ctx, 20, 200), flops, "GFLOPS");
+
+        cten_free(pool_id);
+    }
+
+    bench_linear(suite, pool_id);
+    bench_linear_packed(suite, pool_id);
+}
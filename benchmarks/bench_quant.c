@@ -0,0 +1,164 @@
+#include "bench_utils.h"
+#include <math.h>
+#include <stdio.h>
+
+/* Int8 post-training quantization against the float model it came from: accuracy on Iris after
+ * calibrating on the training data, then latency, output error and weight memory of a wider MLP
+ * at batch 1 and batch 64. */
+
+typedef struct {
+    Tensor x;
+    Tensor w1, b1, w2, b2;
+    nn_qlinear *q1, *q2;
+} QuantCtx;
+
+static Tensor forward_float(QuantCtx* ctx, Tensor x) {
+    Tensor h = nn_relu(nn_linear(x, ctx->w1, ctx->b1));
+    return nn_linear(h, ctx->w2, ctx->b2);
+}
+
+static Tensor forward_int8(QuantCtx* ctx, Tensor x) {
+    Tensor h = nn_relu(nn_qlinear_forward(ctx->q1, x));
+    return nn_qlinear_forward(ctx->q2, h);
+}
+
+// calibration pass: run representative data through the float model and record layer inputs
+static void quantize_model(QuantCtx* ctx, Tensor calib) {
+    nn_qrange r1 = nn_qrange_new(), r2 = nn_qrange_new();
+    nn_qrange_observe(&r1, calib);
+    Tensor h = nn_relu(nn_linear(calib, ctx->w1, ctx->b1));
+    nn_qrange_observe(&r2, h);
+    ctx->q1 = nn_qlinear_new(ctx->w1, ctx->b1, r1);
+    ctx->q2 = nn_qlinear_new(ctx->w2, ctx->b2, r2);
+}
+
+static void run_float(void* p) {
+    QuantCtx* ctx = p;
+    forward_float(ctx, ctx->x);
+}
+
+static void run_int8(void* p) {
+    QuantCtx* ctx = p;
+    forward_int8(ctx, ctx->x);
+}
+
+static float accuracy(Tensor logits, const int* y) {
+    int n = logits.shape[0], hits = 0;
+    for(int i = 0; i < n; i++) {
+        const float* row = logits.data->flex + i * 3;
+        int pred = 0;
+        for(int c = 1; c < 3; c++) {
+            if(row[c] > row[pred]) pred = c;
+        }
+        hits += pred == y[i];
+    }
+    return (float)hits / n;
+}
+
+static void bench_iris(PoolId pool_id) {
+    const float(*X)[4];
+    const int* y;
+    int n = load_iris_dataset(&X, &y);
+    static float X_shuf[150][4], X_norm[150][4];
+    static int y_shuf[150];
+    Tensor_shuffle_dataset(X, y, X_shuf, y_shuf, n, 4);
+    Tensor_normalize_dataset((const float(*)[4])X_shuf, X_norm, n, n, 4);
+
+    cten_begin_malloc(pool_id);
+    QuantCtx ctx;
+    ctx.w1 = Glorot_init((TensorShape){4, 32}, true);
+    ctx.b1 = Tensor_zeros((TensorShape){1, 32}, true);
+    ctx.w2 = Glorot_init((TensorShape){32, 3}, true);
+    ctx.b2 = Tensor_zeros((TensorShape){1, 3}, true);
+    Tensor x = Tensor_from_buffer((TensorShape){n, 4}, &X_norm[0][0], FloatBuffer_ReadOnly);
+    // train on the first 120 samples with class-index labels, hold out the last 30
+    int n_train = 120;
+    Tensor x_train = Tensor_from_buffer((TensorShape){n_train, 4}, &X_norm[0][0], 0);
+    Tensor y_train =
+        Tensor_from_int_buffer((TensorShape){n_train}, (int32_t*)y_shuf, FloatBuffer_ReadOnly);
+    optim_adam* optimizer = optim_adam_new(4, &ctx.w1, 0.01f, 0.9f, 0.999f, 1e-8f, 0.0f);
+    cten_end_malloc();
+
+    for(int epoch = 0; epoch < 200; epoch++) {
+        cten_begin_malloc(pool_id + 1);
+        optim_adam_zerograd(optimizer);
+        Tensor loss = nn_softmax_crossentropy(y_train, forward_float(&ctx, x_train));
+        Tensor_backward(loss, (Tensor){0});
+        optim_adam_step(optimizer);
+        cten_end_malloc();
+        cten_free(pool_id + 1);
+    }
+
+    cten_begin_malloc(pool_id);
+    cten_begin_eval();
+    quantize_model(&ctx, x_train);
+    float acc_f32 = accuracy(forward_float(&ctx, x), y_shuf);
+    float acc_int8 = accuracy(forward_int8(&ctx, x), y_shuf);
+    cten_end_eval();
+    cten_end_malloc();
+
+    printf("%-12s %-36s f32 %.3f int8 %.3f delta %+.3f\n",
+           "quant",
+           "iris 4-32-3 accuracy (150 samples)",
+           acc_f32,
+           acc_int8,
+           acc_int8 - acc_f32);
+    cten_free(pool_id);
+}
+
+static void bench_mlp(PoolId pool_id, int batch) {
+    const int in = 512, hidden = 1024, out = 256;
+    cten_begin_malloc(pool_id);
+    QuantCtx ctx;
+    ctx.w1 = Glorot_init((TensorShape){in, hidden}, false);
+    ctx.b1 = Tensor_new((TensorShape){1, hidden}, false);
+    ctx.w2 = Glorot_init((TensorShape){hidden, out}, false);
+    ctx.b2 = Tensor_new((TensorShape){1, out}, false);
+    ctx.x = Tensor_new((TensorShape){batch, in}, false);
+    bench_fill_random(ctx.b1);
+    bench_fill_random(ctx.b2);
+    bench_fill_random(ctx.x);
+
+    Tensor calib = Tensor_new((TensorShape){64, in}, false);
+    bench_fill_random(calib);
+    quantize_model(&ctx, calib);
+
+    // output error relative to the float model's RMS output
+    Tensor ref = forward_float(&ctx, ctx.x);
+    Tensor got = forward_int8(&ctx, ctx.x);
+    double err = 0.0, mag = 0.0;
+    for(size_t i = 0; i < ref.numel; i++) {
+        double d = got.data->flex[i] - ref.data->flex[i];
+        err += d * d;
+        mag += (double)ref.data->flex[i] * ref.data->flex[i];
+    }
+    cten_end_malloc();
+
+    double flops = 2.0 * batch * ((double)in * hidden + (double)hidden * out);
+    double f32_ns = bench_measure(run_float, &ctx, 2, 200);
+    double int8_ns = bench_measure(run_int8, &ctx, 2, 200);
+    char name[64];
+    snprintf(name, sizeof(name), "mlp %d-%d-%d batch=%d f32", in, hidden, out, batch);
+    bench_report("quant", name, f32_ns, flops, "GFLOPS");
+    snprintf(name, sizeof(name), "mlp %d-%d-%d batch=%d int8", in, hidden, out, batch);
+    bench_report("quant", name, int8_ns, flops, "GOPS");
+
+    size_t f32_bytes = sizeof(float) * (ctx.w1.numel + ctx.b1.numel + ctx.w2.numel + ctx.b2.numel);
+    size_t int8_bytes = nn_qlinear_nbytes(ctx.q1) + nn_qlinear_nbytes(ctx.q2);
+    printf("%-12s %-36s speedup %.2fx rel_rms_err %.4f weights %.2fMiB -> %.2fMiB (%.2fx)\n",
+           "quant",
+           name,
+           f32_ns / int8_ns,
+           sqrt(err / mag),
+           f32_bytes / 1048576.0,
+           int8_bytes / 1048576.0,
+           (double)f32_bytes / int8_bytes);
+    cten_free(pool_id);
+}
+
+void bench_quant() {
+    PoolId pool_id = 1;
+    bench_iris(pool_id);
+    bench_mlp(pool_id, 1);
+    bench_mlp(pool_id, 64);
+}
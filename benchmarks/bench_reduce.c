@@ -0,0 +1,96 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* Reductions along the contiguous and the strided axis of a matrix, max with its backward, and
+ * sums over several axes of a 4-d tensor in one call against the chain of single-axis sums it
+ * replaces. */
+
+typedef struct {
+    Tensor x;
+    Tensor x_grad;  // tracked by autograd
+    int dim;
+} ReduceCtx;
+
+static void run_sum(void* p) {
+    ReduceCtx* ctx = p;
+    Tensor_sum(ctx->x, ctx->dim);
+}
+
+static void run_max(void* p) {
+    ReduceCtx* ctx = p;
+    Tensor_max(ctx->x, ctx->dim);
+}
+
+static void run_max_step(void* p) {
+    ReduceCtx* ctx = p;
+    ctx->x_grad.node->grad = (Tensor){0};
+    Tensor_backward(Tensor_sum(Tensor_max(ctx->x_grad, ctx->dim).values), (Tensor){0});
+}
+
+static void run_logsumexp(void* p) {
+    ReduceCtx* ctx = p;
+    Tensor_reduce(ctx->x, TensorReduceOp_LogSumExp, &ctx->dim, 1, false);
+}
+
+// sum over N, H and W of an NCHW tensor, as batch norm statistics need
+static void run_sum_nhw(void* p) {
+    ReduceCtx* ctx = p;
+    int dims[] = {0, 2, 3};
+    Tensor_reduce(ctx->x, TensorReduceOp_Sum, dims, 3, false);
+}
+
+static void run_sum_nhw_chained(void* p) {
+    ReduceCtx* ctx = p;
+    Tensor_sum(Tensor_sum(Tensor_sum(ctx->x, 3), 2), 0);
+}
+
+void bench_reduce() {
+    const char* suite = "reduce";
+    PoolId pool_id = 1;
+    const int rows = 256, cols = 4096;
+    double n = (double)rows * cols;
+
+    cten_begin_malloc(pool_id);
+    ReduceCtx ctx = {
+        .x = Tensor_new((TensorShape){rows, cols}, false),
+        .x_grad = Tensor_new((TensorShape){rows, cols}, true),
+    };
+    bench_fill_random(ctx.x);
+    bench_fill_random(ctx.x_grad);
+    cten_end_malloc();
+    const struct {
+        const char* name;
+        void (*run)(void*);
+    } ops[] = {
+        {"sum",       run_sum      },
+        {"max",       run_max      },
+        {"logsumexp", run_logsumexp},
+    };
+    for(int op = 0; op < (int)(sizeof(ops) / sizeof(ops[0])); op++) {
+        for(ctx.dim = 0; ctx.dim < 2; ctx.dim++) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s [%d,%d] dim=%d", ops[op].name, rows, cols, ctx.dim);
+            bench_report(suite, name, bench_measure(ops[op].run, &ctx, 5, 200), n, "Gelem/s");
+        }
+    }
+    for(ctx.dim = 0; ctx.dim < 2; ctx.dim++) {
+        char name[64];
+        snprintf(name, sizeof(name), "max+backward [%d,%d] dim=%d", rows, cols, ctx.dim);
+        bench_report(suite, name, bench_measure(run_max_step, &ctx, 5, 200), n, "Gelem/s");
+    }
+    cten_free(pool_id);
+
+    cten_begin_malloc(pool_id);
+    ctx.x = Tensor_new((TensorShape){32, 64, 16, 32}, false);
+    bench_fill_random(ctx.x);
+    cten_end_malloc();
+    double ns_one = bench_measure(run_sum_nhw, &ctx, 5, 200);
+    double ns_chained = bench_measure(run_sum_nhw_chained, &ctx, 5, 200);
+    bench_report(suite, "sum [32,64,16,32] dims={0,2,3}", ns_one, ctx.x.numel, "Gelem/s");
+    bench_report(suite, "sum [32,64,16,32] chained", ns_chained, ctx.x.numel, "Gelem/s");
+    printf("%-12s %-36s speedup %.2fx\n",
+           suite,
+           "sum [32,64,16,32] dims={0,2,3}",
+           ns_chained / ns_one);
+    cten_free(pool_id);
+}
@@ -0,0 +1,154 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* Per-op overhead on tiny tensors, where shape bookkeeping rather than arithmetic dominates. */
+
+typedef struct {
+    Tensor a, b, row;
+    Tensor w1, b1, w2, b2;
+    Tensor x, y;
+    optim_sgd* optimizer;
+    // sine regression model of src2/main.c (1-64-32-1) and a 4-4-3 classifier, run per sample
+    Tensor s_w1, s_b1, s_w2, s_b2, s_w3, s_b3;
+    Tensor c_w1, c_b1, c_w2, c_b2;
+    Tensor sample1, sample4;
+} SmallOpsCtx;
+
+static void run_add(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor_add(ctx->a, ctx->b);
+}
+
+static void run_mul(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor_mul(ctx->a, ctx->b);
+}
+
+static void run_add_broadcast(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor_add(ctx->a, ctx->row);
+}
+
+static void run_sum_dim(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor_sum(ctx->a, 1);
+}
+
+static void run_max_dim(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor_max(ctx->a, 1);
+}
+
+static void run_softmax(void* p) {
+    SmallOpsCtx* ctx = p;
+    nn_softmax(ctx->a, 1);
+}
+
+static void run_matmul(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor_matmul(ctx->a, ctx->b);
+}
+
+static void run_sine_sample(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor h = nn_elu(nn_linear(ctx->sample1, ctx->s_w1, ctx->s_b1), 1.0f);
+    h = nn_elu(nn_linear(h, ctx->s_w2, ctx->s_b2), 1.0f);
+    nn_linear(h, ctx->s_w3, ctx->s_b3);
+}
+
+static void run_classifier_sample(void* p) {
+    SmallOpsCtx* ctx = p;
+    Tensor h = nn_relu(nn_linear(ctx->sample4, ctx->c_w1, ctx->c_b1));
+    nn_softmax(nn_linear(h, ctx->c_w2, ctx->c_b2), 1);
+}
+
+static void run_get_set(void* p) {
+    SmallOpsCtx* ctx = p;
+    for(int i = 0; i < 4; i++) {
+        for(int j = 0; j < 4; j++) {
+            Tensor_set(ctx->b, i, j, 0, 0, Tensor_get(ctx->a, i, j, 0, 0) + 1.0f);
+        }
+    }
+}
+
+static void run_mlp_step(void* p) {
+    SmallOpsCtx* ctx = p;
+    optim_sgd_zerograd(ctx->optimizer);
+    Tensor h = nn_elu(nn_linear(ctx->x, ctx->w1, ctx->b1), 1.0f);
+    Tensor y_pred = nn_linear(h, ctx->w2, ctx->b2);
+    Tensor loss = nn_mse_loss(ctx->y, y_pred);
+    Tensor_backward(loss, (Tensor){0});
+}
+
+void bench_small_ops() {
+    const char* suite = "small_ops";
+    PoolId pool_id = 1;
+    cten_begin_malloc(pool_id);
+
+    SmallOpsCtx ctx;
+    ctx.a = Tensor_new((TensorShape){4, 4}, false);
+    ctx.b = Tensor_new((TensorShape){4, 4}, false);
+    ctx.row = Tensor_new((TensorShape){4}, false);
+    ctx.w1 = Glorot_init((TensorShape){1, 8}, true);
+    ctx.b1 = Tensor_zeros((TensorShape){1, 8}, true);
+    ctx.w2 = Glorot_init((TensorShape){8, 1}, true);
+    ctx.b2 = Tensor_zeros((TensorShape){1, 1}, true);
+    ctx.x = Tensor_new((TensorShape){1, 1}, false);
+    ctx.y = Tensor_new((TensorShape){1, 1}, false);
+    bench_fill_random(ctx.a);
+    bench_fill_random(ctx.b);
+    bench_fill_random(ctx.row);
+    bench_fill_random(ctx.x);
+    bench_fill_random(ctx.y);
+    ctx.s_w1 = Glorot_init((TensorShape){1, 64}, false);
+    ctx.s_b1 = Tensor_zeros((TensorShape){1, 64}, false);
+    ctx.s_w2 = Glorot_init((TensorShape){64, 32}, false);
+    ctx.s_b2 = Tensor_zeros((TensorShape){1, 32}, false);
+    ctx.s_w3 = Glorot_init((TensorShape){32, 1}, false);
+    ctx.s_b3 = Tensor_zeros((TensorShape){1, 1}, false);
+    ctx.c_w1 = Glorot_init((TensorShape){4, 4}, false);
+    ctx.c_b1 = Tensor_zeros((TensorShape){1, 4}, false);
+    ctx.c_w2 = Glorot_init((TensorShape){4, 3}, false);
+    ctx.c_b2 = Tensor_zeros((TensorShape){1, 3}, false);
+    ctx.sample1 = Tensor_new((TensorShape){1, 1}, false);
+    ctx.sample4 = Tensor_new((TensorShape){1, 4}, false);
+    bench_fill_random(ctx.sample1);
+    bench_fill_random(ctx.sample4);
+    Tensor params[] = {ctx.w1, ctx.b1, ctx.w2, ctx.b2};
+    ctx.optimizer = optim_sgd_new(4, params, 0.0f);
+    cten_end_malloc();
+
+    bench_report(suite, "add [4,4]", bench_measure(run_add, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite, "mul [4,4]", bench_measure(run_mul, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite,
+                 "add broadcast [4,4]+[4]",
+                 bench_measure(run_add_broadcast, &ctx, 1000, 200),
+                 0,
+                 NULL);
+    bench_report(suite, "sum dim=1 [4,4]", bench_measure(run_sum_dim, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite, "max dim=1 [4,4]", bench_measure(run_max_dim, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite, "softmax dim=1 [4,4]", bench_measure(run_softmax, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite, "matmul [4,4]@[4,4]", bench_measure(run_matmul, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite, "16x get+set [4,4]", bench_measure(run_get_set, &ctx, 1000, 200), 0, NULL);
+    bench_report(suite,
+                 "mlp 1-8-1 fwd+bwd batch 1",
+                 bench_measure(run_mlp_step, &ctx, 100, 200),
+                 0,
+                 NULL);
+
+    // per-sample inference latency, as in the eval loops of src2/main.c and the Iris demo
+    cten_begin_eval();
+    bench_report(suite,
+                 "eval mlp 1-64-32-1 per sample",
+                 bench_measure(run_sine_sample, &ctx, 100, 200),
+                 0,
+                 NULL);
+    bench_report(suite,
+                 "eval mlp 4-4-3 per sample",
+                 bench_measure(run_classifier_sample, &ctx, 100, 200),
+                 0,
+                 NULL);
+    cten_end_eval();
+
+    cten_free(pool_id);
+}
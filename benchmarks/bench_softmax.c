@@ -0,0 +1,107 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* Softmax, log-softmax (against the log(softmax) chain it replaces) and softmax cross-entropy
+ * against class-index labels, over the class dimension of [rows, classes] logits, from a handful
+ * of classes to a large vocabulary. Rows are chosen so every case touches about the same number
+ * of elements, few enough that the results come from the heap rather than fresh pages. */
+
+typedef struct {
+    Tensor x;       // logits
+    Tensor x_grad;  // the same shape, tracked by autograd
+    Tensor upstream;
+    Tensor labels;  // int32 class index per row
+} SoftmaxCtx;
+
+static void run_softmax(void* p) {
+    SoftmaxCtx* ctx = p;
+    nn_softmax(ctx->x, 1);
+}
+
+static void run_softmax_step(void* p) {
+    SoftmaxCtx* ctx = p;
+    ctx->x_grad.node->grad = (Tensor){0};
+    Tensor_backward(nn_softmax(ctx->x_grad, 1), ctx->upstream);
+}
+
+static void run_log_softmax(void* p) {
+    SoftmaxCtx* ctx = p;
+    nn_log_softmax(ctx->x, 1);
+}
+
+static void run_log_of_softmax(void* p) {
+    SoftmaxCtx* ctx = p;
+    nn_log(nn_softmax(ctx->x, 1));
+}
+
+static void run_log_softmax_step(void* p) {
+    SoftmaxCtx* ctx = p;
+    ctx->x_grad.node->grad = (Tensor){0};
+    Tensor_backward(nn_log_softmax(ctx->x_grad, 1), ctx->upstream);
+}
+
+static void run_loss(void* p) {
+    SoftmaxCtx* ctx = p;
+    nn_softmax_crossentropy(ctx->labels, ctx->x);
+}
+
+static void run_loss_step(void* p) {
+    SoftmaxCtx* ctx = p;
+    ctx->x_grad.node->grad = (Tensor){0};
+    Tensor_backward(nn_softmax_crossentropy(ctx->labels, ctx->x_grad), (Tensor){0});
+}
+
+// backward time is reported as forward+backward minus forward
+void bench_softmax() {
+    const char* suite = "softmax";
+    PoolId pool_id = 1;
+    const int classes[] = {3, 10, 100, 1000, 10000, 50000};
+    const int elements = 1 << 15;
+
+    for(int c = 0; c < (int)(sizeof(classes) / sizeof(classes[0])); c++) {
+        int cols = classes[c], rows = cols < elements ? elements / cols : 1;
+        TensorShape shape = {rows, cols};
+        cten_begin_malloc(pool_id);
+        SoftmaxCtx ctx;
+        ctx.x = Tensor_new(shape, false);
+        ctx.x_grad = Tensor_new(shape, true);
+        ctx.upstream = Tensor_new(shape, false);
+        bench_fill_random(ctx.x);
+        bench_fill_random(ctx.x_grad);
+        bench_fill_random(ctx.upstream);
+        ctx.labels = Tensor_new((TensorShape){rows}, false);
+        for(int r = 0; r < rows; r++) {
+            ctx.labels.data->flex[r] = (float)((r * 7919) % cols);
+        }
+        ctx.labels = Tensor_to(ctx.labels, TensorDType_I32);
+        cten_end_malloc();
+
+        double n = (double)rows * cols;
+        double fwd_ns = bench_measure(run_softmax, &ctx, 10, 200);
+        double step_ns = bench_measure(run_softmax_step, &ctx, 10, 200);
+        char name[64];
+        snprintf(name, sizeof(name), "softmax [%d,%d] fwd", rows, cols);
+        bench_report(suite, name, fwd_ns, n, "Gelem/s");
+        snprintf(name, sizeof(name), "softmax [%d,%d] bwd", rows, cols);
+        bench_report(suite, name, step_ns - fwd_ns, n, "Gelem/s");
+
+        fwd_ns = bench_measure(run_log_softmax, &ctx, 10, 200);
+        step_ns = bench_measure(run_log_softmax_step, &ctx, 10, 200);
+        double chain_ns = bench_measure(run_log_of_softmax, &ctx, 10, 200);
+        snprintf(name, sizeof(name), "log_softmax [%d,%d] fwd", rows, cols);
+        bench_report(suite, name, fwd_ns, n, "Gelem/s");
+        snprintf(name, sizeof(name), "log_softmax [%d,%d] bwd", rows, cols);
+        bench_report(suite, name, step_ns - fwd_ns, n, "Gelem/s");
+        snprintf(name, sizeof(name), "log(softmax) [%d,%d] fwd", rows, cols);
+        bench_report(suite, name, chain_ns, n, "Gelem/s");
+
+        fwd_ns = bench_measure(run_loss, &ctx, 10, 200);
+        step_ns = bench_measure(run_loss_step, &ctx, 10, 200);
+        snprintf(name, sizeof(name), "softmax_ce [%d,%d] fwd", rows, cols);
+        bench_report(suite, name, fwd_ns, n, "Gelem/s");
+        snprintf(name, sizeof(name), "softmax_ce [%d,%d] bwd", rows, cols);
+        bench_report(suite, name, step_ns - fwd_ns, n, "Gelem/s");
+
+        cten_free(pool_id);
+    }
+}
@@ -0,0 +1,104 @@
+#include "bench_utils.h"
+#include <stdio.h>
+
+/* Scaling of the ops the thread pool splits, from one thread up to the hardware thread count
+ * (at least two, so the pool's overhead shows even on one core), as speedup over one thread. */
+
+typedef struct {
+    Tensor x, y;        // [rows, cols]
+    Tensor a, b;        // square matrices
+    Tensor param;       // [rows * cols], tracked by autograd
+    optim_adam* optim;  // over `param`
+} ThreadsCtx;
+
+static void run_add(void* p) {
+    ThreadsCtx* ctx = p;
+    Tensor_add(ctx->x, ctx->y);
+}
+
+static void run_exp(void* p) {
+    ThreadsCtx* ctx = p;
+    nn_exp(ctx->x);
+}
+
+static void run_matmul(void* p) {
+    ThreadsCtx* ctx = p;
+    Tensor_matmul(ctx->a, ctx->b);
+}
+
+static void run_softmax(void* p) {
+    ThreadsCtx* ctx = p;
+    nn_softmax(ctx->x, 1);
+}
+
+static void run_sum_rows(void* p) {
+    ThreadsCtx* ctx = p;
+    Tensor_sum(ctx->x, 1);
+}
+
+static void run_sum_cols(void* p) {
+    ThreadsCtx* ctx = p;
+    Tensor_sum(ctx->x, 0);
+}
+
+static void run_adam(void* p) {
+    ThreadsCtx* ctx = p;
+    optim_adam_step(ctx->optim);
+}
+
+void bench_threads() {
+    const char* suite = "threads";
+    PoolId pool_id = 1;
+    const int rows = 1024, cols = 1000, dim = 512;
+    int saved_threads = cten_num_threads();
+    int max_threads = cten_set_num_threads(0);
+    if(max_threads < 2) max_threads = 2;
+
+    cten_begin_malloc(pool_id);
+    ThreadsCtx ctx;
+    ctx.x = Tensor_new((TensorShape){rows, cols}, false);
+    ctx.y = Tensor_new((TensorShape){rows, cols}, false);
+    ctx.a = Tensor_new((TensorShape){dim, dim}, false);
+    ctx.b = Tensor_new((TensorShape){dim, dim}, false);
+    ctx.param = Tensor_new((TensorShape){rows * cols}, true);
+    ctx.param.node->grad = Tensor_new((TensorShape){rows * cols}, false);
+    bench_fill_random(ctx.x);
+    bench_fill_random(ctx.y);
+    bench_fill_random(ctx.a);
+    bench_fill_random(ctx.b);
+    bench_fill_random(ctx.param);
+    bench_fill_random(ctx.param.node->grad);
+    ctx.optim = optim_adam_new(1, &ctx.param, 1e-3f, 0.9f, 0.999f, 1e-8f, 0.0f);
+    cten_end_malloc();
+
+    const struct {
+        const char* name;
+        void (*run)(void*);
+        double work;
+        const char* unit;
+    } ops[] = {
+        {"add [1024,1000]",           run_add,      (double)rows * cols,   "Gelem/s"},
+        {"exp [1024,1000]",           run_exp,      (double)rows * cols,   "Gelem/s"},
+        {"matmul 512x512x512",        run_matmul,   2.0 * dim * dim * dim, "GFLOP/s"},
+        {"softmax [1024,1000] dim=1", run_softmax,  (double)rows * cols,   "Gelem/s"},
+        {"sum [1024,1000] dim=1",     run_sum_rows, (double)rows * cols,   "Gelem/s"},
+        {"sum [1024,1000] dim=0",     run_sum_cols, (double)rows * cols,   "Gelem/s"},
+        {"adam step 1024000",         run_adam,     (double)rows * cols,   "Gelem/s"},
+    };
+    for(int op = 0; op < (int)(sizeof(ops) / sizeof(ops[0])); op++) {
+        double serial_ns = 0;
+        for(int threads = 1; threads <= max_threads;
+            threads = bench_next_threads(threads, max_threads)) {
+            cten_set_num_threads(threads);
+            double ns = bench_measure(ops[op].run, &ctx, 5, 200);
+            if(threads == 1) serial_ns = ns;
+            char name[64];
+            snprintf(name, sizeof(name), "%s threads=%d", ops[op].name, threads);
+            bench_report(suite, name, ns, ops[op].work, ops[op].unit);
+            if(threads > 1) printf("%-12s %-36s speedup %.2fx\n", suite, name, serial_ns / ns);
+        }
+    }
+
+    cten_set_num_threads(saved_threads);
+    cten_free(pool_id);
+}
@@ -0,0 +1,91 @@
+#include "bench_utils.h"
+#include <math.h>
+#include <stdio.h>
+
+/* Training throughput of the src2/main.c sine regression model (1-64-32-1, ELU, Huber + MAE,
+ * Adam) with one graph per minibatch, against nn_data_parallel with one shard per thread, from
+ * one thread up to the hardware count (at least two). */
+
+typedef struct {
+    Tensor w1, b1;
+    Tensor w2, b2;
+    Tensor w3, b3;
+} SineModel;
+
+typedef struct {
+    SineModel model;
+    optim_adam* optim;
+    nn_data_parallel* dp;
+    Tensor x, y;
+} TrainCtx;
+
+static Tensor sine_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    SineModel* m = (SineModel*)params;
+    (void)user;
+    x = nn_elu(nn_linear(x, m->w1, m->b1), 1.0f);
+    x = nn_elu(nn_linear(x, m->w2, m->b2), 1.0f);
+    x = nn_linear(x, m->w3, m->b3);
+    return Tensor_add(nn_huber_loss(y, x, 1.0f), Tensor_mulf(nn_mae_loss(y, x), 0.3f));
+}
+
+static void run_serial_step(void* p) {
+    TrainCtx* ctx = p;
+    optim_adam_zerograd(ctx->optim);
+    Tensor_backward(sine_loss((Tensor*)&ctx->model, ctx->x, ctx->y, NULL), (Tensor){0});
+    optim_adam_step(ctx->optim);
+}
+
+static void run_parallel_step(void* p) {
+    TrainCtx* ctx = p;
+    optim_adam_zerograd(ctx->optim);
+    nn_data_parallel_backward(ctx->dp, sine_loss, NULL, ctx->x, ctx->y);
+    optim_adam_step(ctx->optim);
+}
+
+void bench_trainer() {
+    const char* suite = "trainer";
+    PoolId pool_id = 1;
+    const int batches[] = {64, 1024};
+    int saved_threads = cten_num_threads();
+    int max_threads = cten_set_num_threads(0);
+    if(max_threads < 2) max_threads = 2;
+
+    for(int b = 0; b < (int)(sizeof(batches) / sizeof(batches[0])); b++) {
+        int batch = batches[b];
+        cten_begin_malloc(pool_id);
+        TrainCtx ctx;
+        cten_seed(1);
+        ctx.model.w1 = Glorot_init((TensorShape){1, 64}, true);
+        ctx.model.b1 = Tensor_zeros((TensorShape){1, 64}, true);
+        ctx.model.w2 = Glorot_init((TensorShape){64, 32}, true);
+        ctx.model.b2 = Tensor_zeros((TensorShape){1, 32}, true);
+        ctx.model.w3 = Glorot_init((TensorShape){32, 1}, true);
+        ctx.model.b3 = Tensor_zeros((TensorShape){1, 1}, true);
+        ctx.optim = optim_adam_new(6, (Tensor*)&ctx.model, 1e-3f, 0.9f, 0.999f, 1e-8f, 0.0f);
+        ctx.x = Tensor_new((TensorShape){batch, 1}, false);
+        ctx.y = Tensor_new((TensorShape){batch, 1}, false);
+        bench_fill_random(ctx.x);
+        for(int i = 0; i < batch; i++) {
+            ctx.y.data->flex[i] = sinf(ctx.x.data->flex[i] * 6.0f);
+        }
+        cten_end_malloc();
+
+        char name[64];
+        cten_set_num_threads(1);
+        double serial_ns = bench_measure(run_serial_step, &ctx, 5, 200);
+        snprintf(name, sizeof(name), "mlp step batch=%d one graph", batch);
+        bench_report(suite, name, serial_ns, batch * 1e3, "Msample/s");
+        for(int threads = 1; threads <= max_threads;
+            threads = bench_next_threads(threads, max_threads)) {
+            cten_set_num_threads(threads);
+            ctx.dp = nn_data_parallel_new(6, (Tensor*)&ctx.model, threads);
+            double ns = bench_measure(run_parallel_step, &ctx, 5, 200);
+            nn_data_parallel_free(ctx.dp);
+            snprintf(name, sizeof(name), "mlp step batch=%d threads=%d", batch, threads);
+            bench_report(suite, name, ns, batch * 1e3, "Msample/s");
+            printf("%-12s %-36s speedup %.2fx\n", suite, name, serial_ns / ns);
+        }
+        cten_free(pool_id);
+    }
+    cten_set_num_threads(saved_threads);
+}
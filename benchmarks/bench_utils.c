@@ -0,0 +1,63 @@
+#include "bench_utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_POOL_ID 1000
+
+int64_t bench_now_ns() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void bench_fill_random(Tensor t) {
+    for(size_t i = 0; i < t.data->numel; i++) {
+        t.data->flex[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    }
+}
+
+double bench_measure(void (*fn)(void* ctx), void* ctx, int batch, double min_ms) {
+    // warm up caches and the allocator once
+    cten_begin_malloc(BENCH_POOL_ID);
+    fn(ctx);
+    cten_end_malloc();
+    cten_free(BENCH_POOL_ID);
+
+    int64_t budget = (int64_t)(min_ms * 1e6);
+    int64_t elapsed = 0;
+    int64_t calls = 0;
+    while(elapsed < budget) {
+        cten_begin_malloc(BENCH_POOL_ID);
+        int64_t start = bench_now_ns();
+        for(int i = 0; i < batch; i++) {
+            fn(ctx);
+        }
+        elapsed += bench_now_ns() - start;
+        calls += batch;
+        cten_end_malloc();
+        cten_free(BENCH_POOL_ID);
+    }
+    return (double)elapsed / (double)calls;
+}
+
+void bench_report(const char* suite,
+                  const char* name,
+                  double ns_per_call,
+                  double work_per_call,
+                  const char* work_unit) {
+    if(work_unit != NULL && ns_per_call > 0) {
+        printf("%-12s %-36s %12.1f ns/call %10.3f %s\n",
+               suite,
+               name,
+               ns_per_call,
+               work_per_call / ns_per_call,
+               work_unit);
+    } else {
+        printf("%-12s %-36s %12.1f ns/call\n", suite, name, ns_per_call);
+    }
+}
+
+int bench_next_threads(int threads, int max_threads) {
+    return threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2;
+}
@@ -0,0 +1,28 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include "../include/cten.h"
+#include <stdint.h>
+
+/* Monotonic wall clock in nanoseconds. */
+int64_t bench_now_ns();
+
+/* Fills a tensor with uniform values in [-1, 1). */
+void bench_fill_random(Tensor t);
+
+/* Runs `fn` in rounds of `batch` calls until at least `min_ms` elapsed and returns the mean cost
+ * of one call in nanoseconds. Tensors allocated by `fn` are freed between rounds. */
+double bench_measure(void (*fn)(void* ctx), void* ctx, int batch, double min_ms);
+
+/* Prints one result row: suite, case, mean time per call and an optional throughput figure. */
+void bench_report(const char* suite,
+                  const char* name,
+                  double ns_per_call,
+                  double work_per_call,
+                  const char* work_unit);
+
+/* Thread count after `threads` when sweeping up to `max_threads`: powers of two, then
+ * `max_threads` itself. */
+int bench_next_threads(int threads, int max_threads);
+
+#endif
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <string.h>
+#include "../include/cten.h"
+
+void bench_small_ops();
+void bench_elementwise();
+void bench_matmul();
+void bench_dtype();
+void bench_quant();
+void bench_math();
+void bench_reduce();
+void bench_softmax();
+void bench_threads();
+void bench_trainer();
+void bench_hogwild();
+
+typedef struct {
+    const char* name;
+    void (*run)();
+} BenchSuite;
+
+static const BenchSuite suites[] = {
+    {"small_ops",   bench_small_ops  },
+    {"elementwise", bench_elementwise},
+    {"matmul",      bench_matmul     },
+    {"dtype",       bench_dtype      },
+    {"quant",       bench_quant      },
+    {"math",        bench_math       },
+    {"reduce",      bench_reduce     },
+    {"softmax",     bench_softmax    },
+    {"threads",     bench_threads    },
+    {"trainer",     bench_trainer    },
+    {"hogwild",     bench_hogwild    },
+};
+
+int main(int argc, char** argv) {
+    cten_initilize();
+    printf("cTensor benchmarks (pass suite names to run a subset), %s kernels\n",
+           cten_simd_level_name(cten_simd_level()));
+    for(int i = 0; i < (int)(sizeof(suites) / sizeof(suites[0])); i++) {
+        bool selected = argc < 2;
+        for(int j = 1; j < argc; j++) {
+            if(strcmp(argv[j], suites[i].name) == 0) selected = true;
+        }
+        if(selected) suites[i].run();
+    }
+    cten_finalize();
+    return 0;
+}
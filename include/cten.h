@@ -23,32 +23,74 @@
 #define Tensor_mean(...) _CTEN_PICK(__VA_ARGS__, Tensor_mean_dim, Tensor_mean_all)(__VA_ARGS__)
 #define Tensor_sum(...) _CTEN_PICK(__VA_ARGS__, Tensor_sum_dim, Tensor_sum_all)(__VA_ARGS__)
 
-/** @brief Tensor shape type supporting up to 4 dimensions */
-typedef int TensorShape[4];
+/** @brief Maximum number of tensor dimensions */
+#define CTEN_MAX_DIMS 8
+
+/** @brief Tensor shape type supporting up to CTEN_MAX_DIMS dimensions, terminated by 0 */
+typedef int TensorShape[CTEN_MAX_DIMS];
 typedef struct GradNode GradNode;
+typedef struct PackedWeight PackedWeight;
 
 /**
- * @brief Float buffer structure with flexible array member
- * @details Stores tensor data with element count and flexible array
+ * @brief Storage flags of a FloatBuffer
+ * @details Buffers created by Tensor_new() own their storage and carry no flags
+ */
+typedef enum FloatBufferFlags {
+    FloatBuffer_External = 1 << 0, /**< Storage is owned by the caller and never freed */
+    FloatBuffer_ReadOnly = 1 << 1, /**< Storage must not be written (e.g. const data in ROM) */
+} FloatBufferFlags;
+
+/**
+ * @brief Element storage type of a FloatBuffer
+ * @details Reduced-precision buffers are widened to float32 as operators load them, and all
+ * arithmetic and accumulation happens in float32. Operator results are always float32, except
+ * the indices of Tensor_max_dim()/Tensor_min_dim(), which are int32. Int32 buffers hold indices
+ * and class labels; index-aware code reads them exactly, other operators see them as floats.
+ */
+typedef enum TensorDType {
+    TensorDType_F32 = 0, /**< IEEE 754 single precision (default) */
+    TensorDType_F16,     /**< IEEE 754 half precision */
+    TensorDType_BF16,    /**< bfloat16: float32 with the mantissa truncated to 7 bits */
+    TensorDType_I32,     /**< 32-bit signed integers (indices and class labels) */
+} TensorDType;
+
+/**
+ * @brief Float buffer structure
+ * @details Stores tensor data with element count, storage flags and element type. Pool-allocated
+ * buffers keep their elements inline right after the header, external buffers point at caller
+ * memory.
  */
 typedef struct FloatBuffer {
-    int numel;    /**< Number of elements in the buffer */
-    float flex[]; /**< Flexible array member containing the actual data */
+    size_t numel; /**< Number of elements in the buffer */
+    int flags;    /**< Combination of FloatBufferFlags */
+    int dtype;    /**< TensorDType of the elements */
+    union {
+        float* flex;      /**< float32 elements (TensorDType_F32) */
+        uint16_t* flex16; /**< 16-bit elements (TensorDType_F16 / TensorDType_BF16) */
+        int32_t* flexi;   /**< int32 elements (TensorDType_I32) */
+    };
+    PackedWeight* packed; /**< GEMM panels cached by Tensor_pack_weight(), or NULL */
 } FloatBuffer;
 
 /**
  * @brief Main tensor structure
- * @details Contains tensor shape, data buffer, and gradient computation node
+ * @details Contains tensor shape, data buffer, and gradient computation node. The number of
+ * dimensions and element count are derived from `shape` once by the constructors, so operators
+ * never rescan the zero-terminated shape.
  */
 typedef struct Tensor {
-    TensorShape shape; /**< Tensor dimensions [dim0, dim1, dim2, dim3] */
+    TensorShape shape; /**< Tensor dimensions [dim0, dim1, ...], 0 past ndim */
+    int ndim;          /**< Number of dimensions, cached from shape */
+    size_t numel;      /**< Number of elements, cached from shape */
     FloatBuffer* data; /**< Pointer to data buffer */
     GradNode* node;    /**< Gradient computation node (NULL if no gradients) */
 } Tensor;
 
 /**
  * @brief Gradient computation node for automatic differentiation
- * @details Stores gradient function, inputs, and metadata for backpropagation
+ * @details Stores gradient function, inputs, and metadata for backpropagation. `saved` holds
+ * what grad_fn needs beyond the inputs, kept by the forward or by the gradient of an earlier
+ * input; autograd never visits it.
  */
 typedef struct GradNode {
     struct Tensor grad;                                  /**< Accumulated gradient */
@@ -57,6 +99,7 @@ typedef struct GradNode {
     int n_inputs;                                        /**< Number of inputs */
     const char* name;                                    /**< Operation name for debugging */
     int params[4];                                       /**< Additional parameters */
+    struct Tensor saved[2];                              /**< Tensors kept for grad_fn */
 } GradNode;
 
 /**
@@ -65,15 +108,107 @@ typedef struct GradNode {
  */
 typedef struct {
     Tensor values;  /**< Maximum/minimum values */
-    Tensor indices; /**< Indices of maximum/minimum values */
+    Tensor indices; /**< Indices of maximum/minimum values (TensorDType_I32) */
 } TensorMaxMinResult;
 
+/**
+ * @brief Reductions computed by Tensor_reduce()
+ */
+typedef enum TensorReduceOp {
+    TensorReduceOp_Sum = 0,   /**< Sum of the elements */
+    TensorReduceOp_Mean,      /**< Arithmetic mean */
+    TensorReduceOp_Max,       /**< Largest element, NaNs ignored */
+    TensorReduceOp_Min,       /**< Smallest element, NaNs ignored */
+    TensorReduceOp_ArgMax,    /**< Position of the first largest element (TensorDType_I32) */
+    TensorReduceOp_LogSumExp, /**< log(sum(exp(x))), computed without overflow */
+} TensorReduceOp;
+
 /**
  * @brief Initialize the CTensor library
- * @details Sets up internal memory management system. Must be called before using CTensor.
+ * @details Sets up internal memory management system and selects the elementwise kernels for
+ * the CPU. Must be called before using CTensor.
  */
 void cten_initilize();
 
+/**
+ * @brief Instruction set levels of the elementwise kernels
+ * @details cten_initilize() selects the widest level the CPU supports. Setting the environment
+ * variable CTEN_SIMD to scalar, sse2, avx2 or avx512 caps it, e.g. to test a narrower path. Every
+ * level computes the same results; only x86-64 builds have vector levels.
+ */
+typedef enum cten_SimdLevel {
+    cten_SimdLevel_Scalar = 0, /**< Portable C loops */
+    cten_SimdLevel_SSE2,       /**< 4-wide SSE2 */
+    cten_SimdLevel_AVX2,       /**< 8-wide AVX2 */
+    cten_SimdLevel_AVX512,     /**< 16-wide AVX-512F */
+} cten_SimdLevel;
+
+/**
+ * @brief Get the instruction set level the elementwise kernels run at
+ * @return The active level
+ */
+cten_SimdLevel cten_simd_level();
+
+/**
+ * @brief Switch the elementwise kernels to another instruction set level
+ * @param level Requested level; levels the CPU lacks fall back to the widest supported one
+ * @return The level actually selected
+ */
+cten_SimdLevel cten_set_simd_level(cten_SimdLevel level);
+
+/**
+ * @brief Get the name of an instruction set level, as accepted by CTEN_SIMD
+ * @param level The level
+ * @return "scalar", "sse2", "avx2" or "avx512"
+ */
+const char* cten_simd_level_name(cten_SimdLevel level);
+
+/**
+ * @brief Accuracy modes of exp, log and the activations built on them
+ * @details Applies to nn_exp, nn_log, nn_sigmoid, nn_tanh, nn_elu, nn_selu, nn_softmax,
+ * nn_log_softmax, the cross-entropy losses and the fused nn_linear_act epilogue. Setting the
+ * environment variable CTEN_MATH to precise or fast selects the mode at cten_initilize().
+ */
+typedef enum cten_MathMode {
+    cten_MathMode_Precise = 0, /**< C library expf/logf/tanhf, one value at a time (default) */
+    cten_MathMode_Fast,        /**< Vectorized polynomials, see cten_set_math_mode() for bounds */
+} cten_MathMode;
+
+/**
+ * @brief Get the active accuracy mode
+ * @return The active mode
+ */
+cten_MathMode cten_math_mode();
+
+/**
+ * @brief Switch exp, log and the activations between libm and fast approximations
+ * @details Fast mode evaluates polynomials that vectorize at every cten_SimdLevel; levels with
+ * fused multiply-add may round the last bit differently. Maximum errors against the exact results
+ * over normal float inputs and outputs: exp and log 1.5 ULP, sigmoid 3 ULP, tanh 2 ULP, and
+ * e^x - 1 inside ELU/SELU 2 ULP. exp overflows to inf above 88.376 (libm: 88.722) and flushes
+ * results below FLT_MIN to zero.
+ * @param mode cten_MathMode_Precise or cten_MathMode_Fast
+ */
+void cten_set_math_mode(cten_MathMode mode);
+
+/**
+ * @brief Set the number of threads that large operations are split across
+ * @details cten_initilize() starts a persistent pool sized by the environment variable
+ * CTEN_NUM_THREADS, or to the number of online CPUs when it is unset or 0. Elementwise ops, matrix
+ * products, reductions, softmax and the optimizer steps split across the pool once their size pays
+ * for it; smaller tensors stay on the calling thread. Every thread count computes the same results.
+ * Must not be called while another thread is running an operation.
+ * @param n Number of threads including the caller; 0 or less selects the number of online CPUs
+ * @return The number of threads actually used (at most 64)
+ */
+int cten_set_num_threads(int n);
+
+/**
+ * @brief Get the number of threads operations are split across
+ * @return The active thread count, including the calling thread
+ */
+int cten_num_threads();
+
 /**
  * @brief Finalize and cleanup the CTensor library
  * @details Frees all allocated memory and cleans up internal structures.
@@ -88,7 +223,7 @@ void cten_finalize();
  * @param shape The tensor shape
  * @return Number of elements (product of all dimensions)
  */
-int TensorShape_numel(TensorShape shape);
+size_t TensorShape_numel(TensorShape shape);
 
 /**
  * @brief Get the number of dimensions in a tensor shape
@@ -140,6 +275,52 @@ Tensor Tensor_zeros(TensorShape shape, bool requires_grad);
  */
 Tensor Tensor_ones(TensorShape shape, bool requires_grad);
 
+/**
+ * @brief Wrap caller-owned memory as a tensor without copying
+ * @param shape The tensor shape
+ * @param data Pointer to at least TensorShape_numel(shape) floats
+ * @param flags FloatBuffer_ReadOnly for storage that must not be written, or 0
+ * @return Tensor viewing `data`, without gradient tracking
+ * @details Only the buffer header is taken from the current pool; the elements are neither
+ * copied nor freed by cten_free(). Operations never write into read-only storage, so const
+ * tables (e.g. in flash) can be wrapped directly; without FloatBuffer_ReadOnly the caller vouches
+ * that `data` is writable.
+ */
+Tensor Tensor_from_buffer(TensorShape shape, const float* data, int flags);
+
+/**
+ * @brief Wrap caller-owned integers as an int32 tensor without copying
+ * @param shape The tensor shape
+ * @param data Pointer to at least TensorShape_numel(shape) int32 values
+ * @param flags FloatBuffer_ReadOnly for storage that must not be written, or 0
+ * @return TensorDType_I32 tensor viewing `data`, e.g. class labels for the cross-entropy losses
+ */
+Tensor Tensor_from_int_buffer(TensorShape shape, const int32_t* data, int flags);
+
+/**
+ * @brief Check whether a tensor's storage may be written
+ * @param self The tensor
+ * @return true if the tensor views read-only storage
+ */
+bool Tensor_is_readonly(Tensor self);
+
+/**
+ * @brief Get the storage type of a tensor
+ * @param self The tensor
+ * @return TensorDType of the tensor's buffer
+ */
+TensorDType Tensor_dtype(Tensor self);
+
+/**
+ * @brief Convert a tensor to another storage type
+ * @details Rounds to nearest-even when narrowing. The result is a new tensor without gradient
+ * tracking; returns `self` unchanged when it already has the requested type.
+ * @param self The tensor to convert
+ * @param dtype Target storage type
+ * @return Tensor holding the same values stored as `dtype`
+ */
+Tensor Tensor_to(Tensor self, TensorDType dtype);
+
 /**
  * @brief Transpose a 2D tensor
  * @param self The input tensor (must be 2D)
@@ -149,6 +330,7 @@ Tensor Tensor_transpose(Tensor self);
 
 /**
  * @brief Get element value at specified indices
+ * @details Addresses the first four dimensions; higher dimensions are read at index 0.
  * @param self The tensor
  * @param i First dimension index
  * @param j Second dimension index
@@ -160,6 +342,7 @@ float Tensor_get(Tensor self, int i, int j, int k, int l);
 
 /**
  * @brief Set element value at specified indices
+ * @details Addresses the first four dimensions; higher dimensions are written at index 0.
  * @param self The tensor
  * @param i First dimension index
  * @param j Second dimension index
@@ -281,6 +464,20 @@ Tensor Tensor_powf(Tensor self, float other);
  */
 Tensor Tensor_matmul(Tensor self, Tensor other);
 
+/**
+ * @brief Keep a 2-D weight packed in the layout the matrix multiply kernels read
+ * @details Tensor_matmul() and nn_linear()/nn_linear_act() normally repack their right operand on
+ * every call. After this call they reuse the weight's cached panels instead whenever it is the
+ * shared right operand, and with `with_transpose` the backward passes reuse a packed transpose for
+ * the input gradient. Optimizer steps and Tensor_set() mark the cache stale and the next product
+ * repacks it in place; code that writes the data directly must call this function again. The
+ * panels are allocated in the current pool, which must outlive the weight's use (normally the
+ * pool that holds the weight). Calling it again on a packed weight only refreshes the panels.
+ * @param weight Weight of shape [in, out]
+ * @param with_transpose Also keep the transposed panels used by the backward pass
+ */
+void Tensor_pack_weight(Tensor weight, bool with_transpose);
+
 /**
  * @brief Element-wise negation
  * @param self The tensor
@@ -350,6 +547,8 @@ Tensor Tensor_max_all(Tensor self);
 
 /**
  * @brief Find maximum values and indices along a specific dimension
+ * @details Values and indices come from one pass. Backward adds the upstream gradient at the
+ * indices only, the first maximum of each slice on ties.
  * @param self The tensor
  * @param dim The dimension to reduce
  * @return TensorMaxMinResult containing values and indices
@@ -365,12 +564,31 @@ Tensor Tensor_min_all(Tensor self);
 
 /**
  * @brief Find minimum values and indices along a specific dimension
+ * @details Values and indices come from one pass. Backward adds the upstream gradient at the
+ * indices only, the first minimum of each slice on ties.
  * @param self The tensor
  * @param dim The dimension to reduce
  * @return TensorMaxMinResult containing values and indices
  */
 TensorMaxMinResult Tensor_min_dim(Tensor self, int dim);
 
+/**
+ * @brief Reduce over any set of dimensions in one pass
+ * @param self The tensor
+ * @param op The reduction
+ * @param dims Dimensions to reduce, negative values counting from the end
+ * @param n_dims Number of entries in dims; 0 reduces every dimension
+ * @param keepdim Keep the reduced dimensions with size 1 instead of dropping them
+ * @return The reduced tensor, of shape (1) when every dimension is dropped
+ * @details Adjacent dimensions that are all kept or all reduced are walked as one and the
+ * innermost runs through the vector kernels, so e.g. reducing a [N, C, H, W] tensor over
+ * {0, 2, 3} reads it once and builds no intermediate tensors. ArgMax counts positions over the
+ * reduced dimensions flattened in row-major order (along a single dimension, the index along it)
+ * and has no gradient. The gradient of Max and Min goes to the first extreme element, that of
+ * LogSumExp is the softmax of the input over the reduced dimensions.
+ */
+Tensor Tensor_reduce(Tensor self, TensorReduceOp op, const int* dims, int n_dims, bool keepdim);
+
 /**
  * @brief Find indices of maximum values
  * @param self The tensor
@@ -424,6 +642,31 @@ Tensor nn_tan(Tensor self);
  */
 Tensor nn_linear(Tensor input, Tensor weight, Tensor bias);
 
+/**
+ * @brief Activation applied by nn_linear_act()
+ */
+typedef enum nn_Activation {
+    nn_Activation_None = 0, /**< Identity */
+    nn_Activation_ReLU,     /**< max(0, x) */
+    nn_Activation_Sigmoid,  /**< 1 / (1 + exp(-x)) */
+    nn_Activation_Tanh,     /**< tanh(x) */
+    nn_Activation_ELU,      /**< ELU with alpha = 1 */
+    nn_Activation_SELU,     /**< SELU with the standard alpha and lambda */
+} nn_Activation;
+
+/**
+ * @brief Fused linear layer and activation: act(input @ weight + bias)
+ * @details The bias add and the activation run in the GEMM epilogue on each output tile, and the
+ * backward applies the activation derivative and reduces the bias gradient in one pass. Leading
+ * dimensions of input are flattened into the batch.
+ * @param input Input tensor [..., in_features]
+ * @param weight Weight tensor [in_features, out_features]
+ * @param bias Bias tensor with out_features elements ([out_features] or [1, out_features])
+ * @param act Activation to apply
+ * @return Result tensor [..., out_features]
+ */
+Tensor nn_linear_act(Tensor input, Tensor weight, Tensor bias, nn_Activation act);
+
 /**
  * @brief ReLU activation function
  * @param input The input tensor
@@ -468,8 +711,18 @@ Tensor nn_selu(Tensor self);
  */
 Tensor nn_softmax(Tensor input, int dim);
 
+/**
+ * @brief Log-softmax function along a specified dimension
+ * @param input The input tensor
+ * @param dim The dimension to apply log-softmax
+ * @return Log-probabilities, input - logsumexp(input) along dim
+ * @details Stays finite where log(nn_softmax(input, dim)) underflows to -inf.
+ */
+Tensor nn_log_softmax(Tensor input, int dim);
+
 /**
  * @brief Initialize tensor with Glorot/Xavier initialization
+ * @details Draws from the random generator of the calling thread's cten_Context
  * @param shape The tensor shape (typically [fan_in, fan_out])
  * @param requires_grad Whether to track gradients
  * @return Tensor initialized with Glorot distribution
@@ -478,20 +731,35 @@ Tensor Glorot_init(TensorShape shape, bool requires_grad);
 
 /**
  * @brief Cross-entropy loss function
- * @param y_true True labels (one-hot encoded) [batch_size, num_classes]
+ * @param y_true True labels, one-hot encoded [batch_size, num_classes] or class indices as a
+ *               TensorDType_I32 tensor [batch_size]
  * @param y_pred Predicted probabilities [batch_size, num_classes]
- * @return Scalar tensor containing the cross-entropy loss
+ * @return Scalar tensor containing the mean cross-entropy loss over the batch
  */
 Tensor nn_crossentropy(Tensor y_true, Tensor y_pred);
 
 /**
  * @brief Softmax followed by cross-entropy loss (numerically stable)
- * @param y_true True labels (one-hot encoded) [batch_size, num_classes]
+ * @param y_true True labels, one-hot encoded [batch_size, num_classes] or class indices as a
+ *               TensorDType_I32 tensor [batch_size]
  * @param logits Raw logits [batch_size, num_classes]
- * @return Scalar tensor containing the softmax cross-entropy loss
+ * @return Scalar tensor containing the mean softmax cross-entropy loss over the batch
+ * @details Only the log-sum-exp of each row is kept for the backward pass, which produces
+ *          (softmax - onehot) / batch_size in a single pass over the logits.
  */
 Tensor nn_softmax_crossentropy(Tensor y_true, Tensor logits);
 
+/**
+ * @brief Negative log-likelihood loss over log-probabilities
+ * @param y_true True labels, one-hot encoded [batch_size, num_classes] or class indices as a
+ *               TensorDType_I32 tensor [batch_size]
+ * @param log_probs Log-probabilities [batch_size, num_classes], e.g. from nn_log_softmax
+ * @return Scalar tensor containing the mean negative log-likelihood
+ * @details nn_nll_loss(y_true, nn_log_softmax(logits, last_dim)) matches
+ *          nn_softmax_crossentropy(y_true, logits), gradients included.
+ */
+Tensor nn_nll_loss(Tensor y_true, Tensor log_probs);
+
 /**
  * @brief Mean Squared Error loss function
  * @param y_true True values
@@ -525,7 +793,8 @@ typedef int64_t PoolId;
 /**
  * @brief Begin memory allocation in a specific pool
  * @param id Pool identifier
- * @details All subsequent tensor allocations will be assigned to this pool
+ * @details All subsequent tensor allocations will be assigned to this pool. Each cten_Context keeps
+ * its own pool stack, so pools with the same id in different contexts are unrelated.
  */
 void cten_begin_malloc(PoolId id);
 
@@ -541,6 +810,51 @@ void cten_end_malloc();
  */
 void cten_free(PoolId id);
 
+/* Context */
+
+/**
+ * @brief Per-session library state
+ * @details Holds the allocation pools and their tensors, the eval mode depth and the random
+ * generator used by Glorot_init() and Tensor_shuffle_dataset(). Every thread starts on the default
+ * context created by cten_initilize(). Threads that bind their own contexts can run independent
+ * inference or training sessions at the same time; a context must be used by one thread at a
+ * time. The SIMD level, math mode and thread count remain process-wide.
+ */
+typedef struct cten_Context cten_Context;
+
+/**
+ * @brief Create an empty context, with no pools and the default random seed
+ * @return New context, released with cten_context_free()
+ */
+cten_Context* cten_context_new();
+
+/**
+ * @brief Free a context and every tensor allocated in its pools
+ * @details The calling thread returns to the default context if it was bound to `self`; no other
+ * thread may still be bound to it. The default context is freed by cten_finalize().
+ * @param self Context from cten_context_new()
+ */
+void cten_context_free(cten_Context* self);
+
+/**
+ * @brief Bind a context to the calling thread
+ * @param self Context to use for subsequent calls on this thread, or NULL for the default context
+ * @return The previously bound context
+ */
+cten_Context* cten_set_context(cten_Context* self);
+
+/**
+ * @brief Get the context bound to the calling thread
+ * @return The bound context, the default context if none was bound
+ */
+cten_Context* cten_context();
+
+/**
+ * @brief Seed the random generator of the calling thread's context
+ * @param seed Any value; equal seeds give equal initializations and shuffles
+ */
+void cten_seed(uint64_t seed);
+
 /* Optimizer */
 
 /** @brief SGD optimizer structure */
@@ -669,6 +983,113 @@ void optim_adam_zerograd(optim_adam* self);
  */
 void optim_adam_step(optim_adam* self);
 
+/* Data-parallel training */
+
+/**
+ * @brief Loss of one shard of a minibatch, built by nn_data_parallel_backward()
+ * @details Called concurrently from worker threads, each in its own cten_Context. `params` has
+ * the layout of the array given to nn_data_parallel_new() (so it can be cast to the model
+ * struct), with the same data but separate gradients; `x` and `y` are views of the shard's rows.
+ * @return Scalar loss, the mean over the shard's samples
+ */
+typedef Tensor (*nn_ShardLoss)(Tensor* params, Tensor x, Tensor y, void* user);
+
+/** @brief Data-parallel trainer structure */
+typedef struct nn_data_parallel nn_data_parallel;
+
+/**
+ * @brief Create a data-parallel trainer over shared parameters
+ * @details Each shard keeps its own context with a gradient-tracking view of every parameter.
+ * Shards are split across the thread pool (see cten_set_num_threads()).
+ * @param n_params Number of parameter tensors
+ * @param params Array of parameter tensors, updated in place by any optimizer
+ * @param n_shards Number of pieces each minibatch is split into; 0 or less uses the thread count
+ * @return Trainer, released with nn_data_parallel_free()
+ */
+nn_data_parallel* nn_data_parallel_new(int n_params, Tensor* params, int n_shards);
+
+/**
+ * @brief Compute a minibatch's loss and accumulate its gradient into the parameters
+ * @details Splits the rows of `x` and `y` into contiguous shards, runs `loss_fn` forward and
+ * backward on each shard in parallel, weighting shard k's loss by its share of the rows, then sums
+ * the shards' gradients in a fixed tree and adds the result to each parameter's gradient,
+ * allocated in the current pool as Tensor_backward() would. The gradients are those of the mean
+ * loss over the whole batch, and do not depend on the thread count.
+ * @param self Trainer instance
+ * @param loss_fn Builds the loss of one shard
+ * @param user Passed through to `loss_fn`
+ * @param x Inputs, samples along the first dimension
+ * @param y Targets (float or int32), samples along the first dimension
+ * @return Loss of the whole batch
+ */
+float nn_data_parallel_backward(nn_data_parallel* self,
+                                nn_ShardLoss loss_fn,
+                                void* user,
+                                Tensor x,
+                                Tensor y);
+
+/**
+ * @brief Free a trainer and the shards' contexts
+ * @param self Trainer instance
+ */
+void nn_data_parallel_free(nn_data_parallel* self);
+
+/** @brief Hogwild (lock-free asynchronous SGD) trainer structure */
+typedef struct nn_hogwild nn_hogwild;
+
+/**
+ * @brief Create a Hogwild trainer over shared parameters
+ * @details Each worker keeps its own context with a private, gradient-tracking copy of every
+ * trainable parameter (one with a GradNode). Parameters without one are shared read-only.
+ * @param n_params Number of parameter tensors
+ * @param params Array of parameter tensors, updated in place by nn_hogwild_train()
+ * @param n_workers Number of concurrent workers; 0 or less uses the thread count
+ * @param weight_decay L2 regularization factor
+ * @return Trainer with a learning rate of 0.001 and no momentum, released with nn_hogwild_free()
+ */
+nn_hogwild* nn_hogwild_new(int n_params, Tensor* params, int n_workers, float weight_decay);
+
+/**
+ * @brief Configure the learning rate and momentum of a Hogwild trainer
+ * @param self Trainer instance
+ * @param lr Learning rate
+ * @param momentum Momentum factor, with a velocity kept per worker
+ */
+void nn_hogwild_config(nn_hogwild* self, float lr, float momentum);
+
+/**
+ * @brief Train with lock-free asynchronous SGD steps
+ * @details Runs `n_steps` minibatch steps split across the workers, worker k taking steps k,
+ * k + n_workers, ... on the thread pool; step s trains on minibatch b = s modulo the minibatch
+ * count, rows [b * batch_size, (b + 1) * batch_size) of `x` and `y`. A step copies the
+ * parameters, computes the gradient of `loss_fn` on the copy and applies the optim_sgd_step()
+ * update to the shared parameters, while other workers do the same without any lock. All
+ * concurrent accesses to the parameters are relaxed atomics per element: no value is torn and
+ * no update is lost, but a step may see part of another's update. With one thread this is plain
+ * minibatch SGD in step order. The parameters' own gradients are not touched.
+ * @param self Trainer instance
+ * @param loss_fn Builds the mean loss of one minibatch, as for nn_data_parallel_backward()
+ * @param user Passed through to `loss_fn`
+ * @param x Inputs, samples along the first dimension
+ * @param y Targets (float or int32), samples along the first dimension
+ * @param batch_size Rows per minibatch; the last batch of the dataset may be shorter
+ * @param n_steps Total number of steps over all workers
+ * @return Mean minibatch loss over the steps, each taken before its own update
+ */
+float nn_hogwild_train(nn_hogwild* self,
+                       nn_ShardLoss loss_fn,
+                       void* user,
+                       Tensor x,
+                       Tensor y,
+                       int batch_size,
+                       int n_steps);
+
+/**
+ * @brief Free a Hogwild trainer and the workers' contexts
+ * @param self Trainer instance
+ */
+void nn_hogwild_free(nn_hogwild* self);
+
 /* Gradient Clipping */
 
 /**
@@ -712,11 +1133,66 @@ void cten_clip_grad_positive(Tensor* params, int n_params, float max_value);
  */
 void cten_clip_grad_negative(Tensor* params, int n_params, float min_value);
 
+/* Quantization */
+
+/** @brief Running minimum and maximum of the activations fed to one layer */
+typedef struct nn_qrange {
+    float min_val;
+    float max_val;
+} nn_qrange;
+
+/** @brief Int8 linear layer produced by post-training quantization */
+typedef struct nn_qlinear nn_qlinear;
+
+/**
+ * @brief Create an empty activation range for calibration
+ * @return Range that every observed value will widen
+ */
+nn_qrange nn_qrange_new();
+
+/**
+ * @brief Widen a range to cover the values of a tensor
+ * @param self Range to update
+ * @param x Activations from a representative batch
+ * @details Call it on the input of each layer while running calibration batches through the
+ *          float model; the final range fixes the layer's input scale and zero point.
+ */
+void nn_qrange_observe(nn_qrange* self, Tensor x);
+
+/**
+ * @brief Quantize the parameters of an nn_linear layer to int8
+ * @param weight Float weight tensor [in_features, out_features]
+ * @param bias Float bias with out_features elements
+ * @param input_range Calibrated range of the layer input
+ * @return Pointer to the quantized layer, allocated in the current pool
+ * @details Weights get a symmetric scale per output channel; inputs use one asymmetric scale and
+ *          zero point derived from input_range.
+ */
+nn_qlinear* nn_qlinear_new(Tensor weight, Tensor bias, nn_qrange input_range);
+
+/**
+ * @brief Run a quantized linear layer
+ * @param self Quantized layer
+ * @param input Float input whose last dimension is in_features
+ * @return Float output with the last dimension replaced by out_features
+ * @details Quantizes the input, multiplies with int32 accumulation and requantizes to float with
+ *          the scales and bias in one pass. Inference only: the result carries no gradient.
+ */
+Tensor nn_qlinear_forward(nn_qlinear* self, Tensor input);
+
+/**
+ * @brief Memory held by a quantized layer
+ * @param self Quantized layer
+ * @return Size in bytes of the int8 weights, per-channel constants and layer header
+ */
+size_t nn_qlinear_nbytes(nn_qlinear* self);
+
 /* Misc */
 
 /**
  * @brief Enter evaluation mode (disables gradient computation)
- * @details Gradients will not be computed for operations in eval mode
+ * @details Gradients will not be computed for operations in eval mode. The mode belongs to the
+ * calling thread's cten_Context.
  */
 void cten_begin_eval();
 
@@ -765,6 +1241,8 @@ Tensor Tensor_detach(Tensor self);
 
 /**
  * @brief Shuffle dataset randomly
+ * @details Draws from the random generator of the calling thread's cten_Context, so the order is
+ * reproducible for a given cten_seed().
  * @param X Input features [n_samples][n_features]
  * @param y Input labels [n_samples]
  * @param X_shuffled Output shuffled features [n_samples][n_features]
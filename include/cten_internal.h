@@ -2,5 +2,294 @@
 
 #include "cten.h"
 
+#include <string.h>
+
 void* _cten_malloc(size_t size);
-void _cten_zero_grad(Tensor* params, int n_params);
\ No newline at end of file
+void _cten_zero_grad(Tensor* params, int n_params);
+void _cten_set_shape(Tensor* self, const int* shape);
+size_t _cten_stride(Tensor self, int dim);
+void _cten_assert_writable(const char* title, Tensor self);
+void _cten_mark_modified(Tensor self);
+
+/* Library context (src/context.c, src/pool.c) */
+
+// The pool stack and the tensors allocated in each pool; one per cten_Context
+typedef struct PoolAllocator PoolAllocator;
+PoolAllocator* _cten_pools_new();
+// frees every allocation made in the pools, then the allocator itself
+void _cten_pools_free(PoolAllocator* self);
+// the pools of the calling thread's context
+PoolAllocator* _cten_current_pools();
+void _cten_context_init();
+void _cten_context_shutdown();
+// uniform draws from the calling thread's context generator: 32 random bits, and [0, 1)
+uint32_t _cten_rand_u32();
+float _cten_rand_uniform();
+
+// Float op hyperparameters kept in GradNode.params for the backward pass
+static inline void _cten_set_param_f32(GradNode* node, int i, float value) {
+    _Static_assert(sizeof(float) == sizeof(node->params[0]), "params[] must hold a float");
+    memcpy(&node->params[i], &value, sizeof(float));
+}
+
+static inline float _cten_param_f32(const GradNode* node, int i) {
+    float value;
+    memcpy(&value, &node->params[i], sizeof(float));
+    return value;
+}
+
+/* Reduced-precision storage (src/dtype.c) */
+#define _CTEN_LOAD_BLOCK 256
+
+float _cten_f16_to_f32(uint16_t h);
+uint16_t _cten_f32_to_f16(float f);
+float _cten_bf16_to_f32(uint16_t h);
+uint16_t _cten_f32_to_bf16(float f);
+size_t _cten_dtype_size(TensorDType dtype);
+Tensor _cten_new_dtype(const int* shape, TensorDType dtype);
+void _cten_widen(const FloatBuffer* buf, size_t start, size_t n, float* dst);
+void _cten_narrow(const float* src, FloatBuffer* buf, size_t start, size_t n);
+Tensor _cten_as_f32(Tensor self);
+
+// Elements [start, start + n) of `buf` as float32: a direct pointer for float32 storage, otherwise
+// the elements widened into `scratch` (at least `n` floats).
+static inline const float* _cten_load_f32(const FloatBuffer* buf,
+                                          size_t start,
+                                          size_t n,
+                                          float* scratch) {
+    if(buf->dtype == TensorDType_F32) return buf->flex + start;
+    _cten_widen(buf, start, n, scratch);
+    return scratch;
+}
+
+// Largest run _cten_load_f32() may be asked for at once: unbounded for float32 storage, one
+// scratch block otherwise.
+static inline size_t _cten_load_span(const FloatBuffer* buf) {
+    return buf->dtype == TensorDType_F32 ? SIZE_MAX : _CTEN_LOAD_BLOCK;
+}
+
+/* Elementwise kernels (src/simd.c) */
+
+// One entry per kernel, pointing at the implementation for the active cten_SimdLevel and, for
+// exp, log, sigmoid, tanh and elu, cten_MathMode. Kernels read n floats from each input and write
+// n to `out` (the reduce_ kernels return one value instead); outputs may alias inputs.
+typedef struct ElemwiseKernels {
+    void (*add)(const float* x, const float* y, float* out, size_t n);
+    void (*sub)(const float* x, const float* y, float* out, size_t n);
+    void (*mul)(const float* x, const float* y, float* out, size_t n);
+    void (*div)(const float* x, const float* y, float* out, size_t n);
+    // the larger (smaller) of x and y, y where x is NaN
+    void (*max)(const float* x, const float* y, float* out, size_t n);
+    void (*min)(const float* x, const float* y, float* out, size_t n);
+    void (*abs)(const float* x, float* out, size_t n);
+    void (*square)(const float* x, float* out, size_t n);
+    void (*reciprocal)(const float* x, float* out, size_t n);
+    void (*relu)(const float* x, float* out, size_t n);
+    void (*sigmoid)(const float* x, float* out, size_t n);
+    void (*tanh)(const float* x, float* out, size_t n);
+    void (*exp)(const float* x, float* out, size_t n);
+    void (*log)(const float* x, float* out, size_t n);
+    // one value at a time, for loops over strided data
+    float (*scalar_exp)(float x);
+    float (*scalar_log)(float x);
+    // scale * x for x > 0, scale * alpha * (e^x - 1) otherwise (ELU, and SELU with its constants)
+    void (*elu)(const float* x, float alpha, float scale, float* out, size_t n);
+    void (*scale)(const float* x, float s, float* out, size_t n);
+    // derivatives: of abs and relu from the input, of sigmoid and tanh from the output y
+    void (*abs_grad)(const float* x, float* out, size_t n);
+    void (*relu_grad)(const float* x, float* out, size_t n);
+    void (*reciprocal_grad)(const float* x, float* out, size_t n);
+    void (*sigmoid_grad)(const float* y, float* out, size_t n);
+    void (*tanh_grad)(const float* y, float* out, size_t n);
+    // a for x > 0, y + b otherwise, with y the ELU/SELU output
+    void (*elu_grad)(const float* x, const float* y, float a, float b, float* out, size_t n);
+    // d(x / y)/dy = -x / y^2
+    void (*div_grad_y)(const float* x, const float* y, float* out, size_t n);
+    // where x[i] > best[i] (x[i] < best[i]), best[i] = x[i] and idx[i] = pos
+    void (*max_index)(const float* x, float* best, int32_t* idx, int32_t pos, size_t n);
+    void (*min_index)(const float* x, float* best, int32_t* idx, int32_t pos, size_t n);
+    // x[0] + ... + x[n-1] and x[0] * y[0] + ... + x[n-1] * y[n-1], summed pairwise; the largest
+    // (smallest) x[i] ignoring NaNs, -inf (inf) if none
+    float (*reduce_sum)(const float* x, size_t n);
+    float (*dot)(const float* x, const float* y, size_t n);
+    float (*reduce_max)(const float* x, size_t n);
+    float (*reduce_min)(const float* x, size_t n);
+    // reduce_max (reduce_min) that also sets *pos to the first position holding the result, 0 if
+    // there is none
+    float (*reduce_max_index)(const float* x, size_t n, size_t* pos);
+    float (*reduce_min_index)(const float* x, size_t n, size_t* pos);
+} ElemwiseKernels;
+
+extern ElemwiseKernels _cten_kernels;
+void _cten_simd_init();
+
+/* Thread pool (src/parallel.c) */
+
+// Runs fn(ctx, begin, end) over consecutive ranges that cover [0, n), one range per thread with at
+// least `grain` units each, on the calling thread alone when n < 2 * grain. Ranges run
+// concurrently, so they must write disjoint memory and may not allocate from the tensor pools; a
+// loop started inside one runs serially.
+typedef void (*_cten_RangeFn)(void* ctx, size_t begin, size_t end);
+void _cten_parallel_for(size_t n, size_t grain, _cten_RangeFn fn, void* ctx);
+void _cten_threads_init();
+void _cten_threads_shutdown();
+
+// Elements per thread below which splitting a loop costs more than it saves: for arithmetic that
+// streams memory, and for exp, log and the activations built on them
+#define _CTEN_GRAIN 32768
+#define _CTEN_GRAIN_MATH 4096
+
+// kernel(x, out, n) and kernel(x, y, out, n) with the elements split across the thread pool
+void _cten_parallel_map(void (*kernel)(const float* x, float* out, size_t n),
+                        const float* x,
+                        float* out,
+                        size_t n,
+                        size_t grain);
+void _cten_parallel_zip(void (*kernel)(const float* x, const float* y, float* out, size_t n),
+                        const float* x,
+                        const float* y,
+                        float* out,
+                        size_t n,
+                        size_t grain);
+
+/* Reductions (src/reduce.c) */
+
+// `op` of a float32 tensor over the axes set in the bitmask `axes`, with no gradient wiring beyond
+// the node Tensor_new() gives the result when `requires_grad`. For Max and Min, `indices` (if not
+// NULL) receives the position of each extreme within the reduced axes.
+Tensor _cten_reduce(Tensor self,
+                    TensorReduceOp op,
+                    int axes,
+                    bool keepdim,
+                    bool requires_grad,
+                    Tensor* indices);
+// _cten_reduce() with the autograd node of Tensor_reduce(), whose backward sends the upstream
+// gradient of Max and Min straight to the positions that won
+Tensor _cten_reduce_autograd(Tensor self,
+                             TensorReduceOp op,
+                             int axes,
+                             bool keepdim,
+                             Tensor* indices);
+
+/* Dense kernels (src/gemm.c) */
+
+#define _CTEN_SELU_ALPHA 1.67326324f
+#define _CTEN_SELU_LAMBDA 1.05070098f
+
+// C[M,N] = A[M,K] @ B[K,N], or C += A @ B when `accumulate`. Operands are addressed through a row
+// and a column stride, so a transposed operand is the same data with its strides swapped.
+void _cten_gemm(size_t M,
+                size_t N,
+                size_t K,
+                const float* A,
+                size_t rs_a,
+                size_t cs_a,
+                const float* B,
+                size_t rs_b,
+                size_t cs_b,
+                float* C,
+                size_t ldc,
+                bool accumulate);
+
+// BLAS-style entry point: C[M,N] (+)= op(A) @ op(B) for row-major A and B with leading dimensions
+// lda and ldb, where op() transposes in place (no copy) when its flag is set. Products too small to
+// pay for packing run unpacked.
+void _cten_sgemm(bool trans_a,
+                 bool trans_b,
+                 size_t M,
+                 size_t N,
+                 size_t K,
+                 const float* A,
+                 size_t lda,
+                 const float* B,
+                 size_t ldb,
+                 float* C,
+                 size_t ldc,
+                 bool accumulate);
+
+// _cten_sgemm() over `count` same-shaped products C[b] (+)= op(A[b]) @ op(B[b]), split across the
+// thread pool by whole products with one packing allocation per thread. When `c_distinct` is false
+// some products share a C, and they all run in order on the calling thread.
+void _cten_sgemm_batched(bool trans_a,
+                         bool trans_b,
+                         size_t count,
+                         size_t M,
+                         size_t N,
+                         size_t K,
+                         const float* const* A,
+                         size_t lda,
+                         const float* const* B,
+                         size_t ldb,
+                         float* const* C,
+                         size_t ldc,
+                         bool accumulate,
+                         bool c_distinct);
+
+// C[M,N] = act(A[M,K] @ B[K,N] + bias[N]), with the bias add (skipped when bias is NULL) and the
+// activation applied to each tile of C as the GEMM finishes it
+void _cten_sgemm_bias_act(size_t M,
+                          size_t N,
+                          size_t K,
+                          const float* A,
+                          size_t lda,
+                          const float* B,
+                          size_t ldb,
+                          float* C,
+                          size_t ldc,
+                          const float* bias,
+                          nn_Activation act);
+
+/* Prepacked weights (Tensor_pack_weight) */
+
+// Panels of a [rows, cols] weight as _cten_gemm_pack_panels() lays them out, and of its transpose
+// when requested. `stale` is set by anything that writes the weight.
+struct PackedWeight {
+    size_t rows, cols;
+    bool stale;
+    float* panels;
+    float* panels_t;
+};
+
+// Floats needed to hold all of a K x N right operand as packed panels
+size_t _cten_gemm_panels_size(size_t K, size_t N);
+// Packs the whole K x N operand B (addressed like _cten_gemm's B) into `panels`
+void _cten_gemm_pack_panels(size_t K,
+                            size_t N,
+                            const float* B,
+                            size_t rs_b,
+                            size_t cs_b,
+                            float* panels);
+// _cten_sgemm_bias_act() for op(B) (transposed in place when `trans_b`) that may already be packed
+// by _cten_gemm_pack_panels() into `b_panels`; NULL packs as usual. Products too small to pack
+// read B directly either way; larger ones never touch B when panels are given, so it may be NULL.
+void _cten_sgemm_prepacked(bool trans_b,
+                           size_t M,
+                           size_t N,
+                           size_t K,
+                           const float* A,
+                           size_t lda,
+                           const float* B,
+                           size_t ldb,
+                           const float* b_panels,
+                           float* C,
+                           size_t ldc,
+                           const float* bias,
+                           nn_Activation act);
+// Current panels of `weight` (of its transpose when `transposed`), repacked first if stale, or
+// NULL when the weight has none to match its last two dimensions
+const float* _cten_weight_panels(Tensor weight, bool transposed);
+// c[x] = act(c[x] + bias[x]) over one row segment, the epilogue of _cten_sgemm_bias_act(); no bias
+// add when `bias` is NULL
+void _cten_bias_act(float* c, const float* bias, size_t n, nn_Activation act);
+// res[rows, p] = act(self @ other + bias) for a single [n, p] `other` (e.g. a weight) shared by all
+// `rows` rows of `self`, either of them in any float dtype. Float32 operands go to the GEMM, as do
+// reduced-precision ones with enough rows to pay for widening them once; fewer rows stream the
+// stored elements. A weight with prepacked panels is never widened for the packed GEMM.
+void _cten_matmul_shared(Tensor self,
+                         Tensor other,
+                         Tensor res,
+                         size_t rows,
+                         size_t n,
+                         size_t p,
+                         const float* bias,
+                         nn_Activation act);
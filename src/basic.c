@@ -8,8 +8,8 @@
 #include <math.h>
 #include <time.h>
 
-int TensorShape_numel(TensorShape shape) {
-    int numel = 1;
+size_t TensorShape_numel(TensorShape shape) {
+    size_t numel = 1;
     for(int i = 0; i < sizeof(TensorShape) / sizeof(shape[0]); i++) {
         if(shape[i] == 0) break;
         numel *= shape[i];
@@ -32,24 +32,65 @@ int TensorShape_asdim(TensorShape shape, int dim) {
 }
 
 int TensorShape_tostring(TensorShape shape, char* buf, int size) {
-    return snprintf(buf, size, "(%d, %d, %d, %d)", shape[0], shape[1], shape[2], shape[3]);
+    int len = snprintf(buf, size, "(");
+    for(int i = 0; i < CTEN_MAX_DIMS && shape[i] != 0; i++) {
+        len += snprintf(buf + len, len < size ? size - len : 0, i ? ", %d" : "%d", shape[i]);
+    }
+    len += snprintf(buf + len, len < size ? size - len : 0, ")");
+    return len;
+}
+
+void _cten_set_shape(Tensor* self, const int* shape) {
+    int ndim = 0;
+    while(ndim < CTEN_MAX_DIMS && shape[ndim] != 0) {
+        self->shape[ndim] = shape[ndim];
+        ndim++;
+    }
+    size_t numel = 1;
+    for(int i = 0; i < CTEN_MAX_DIMS; i++) {
+        if(i >= ndim) {
+            self->shape[i] = 0;
+        } else {
+            numel *= self->shape[i];
+        }
+    }
+    self->ndim = ndim;
+    self->numel = numel;
+}
+
+size_t _cten_stride(Tensor self, int dim) {
+    size_t stride = 1;
+    for(int i = dim + 1; i < self.ndim; i++) {
+        stride *= self.shape[i];
+    }
+    return stride;
+}
+
+static size_t _cten_offset4(const Tensor* self, int i, int j, int k, int l) {
+    // absent dimensions have index 0, so they can be treated as size 1
+    const int* s = self->shape;
+    size_t offset = (size_t)i;
+    offset = offset * (s[1] ? s[1] : 1) + j;
+    offset = offset * (s[2] ? s[2] : 1) + k;
+    offset = offset * (s[3] ? s[3] : 1) + l;
+    // dimensions past the fourth are addressed at index 0
+    for(int d = 4; d < self->ndim; d++) {
+        offset *= s[d];
+    }
+    return offset;
 }
 
 Tensor Tensor_new(TensorShape shape, bool requires_grad) {
     Tensor self;
-    memset(self.shape, 0, sizeof(TensorShape));
-    int ndims = TensorShape_dim(shape);
-    memcpy(self.shape, shape, ndims * sizeof(int));
+    _cten_set_shape(&self, shape);
 
-    int numel = TensorShape_numel(self.shape);
+    size_t numel = self.numel;
     self.data = _cten_malloc(sizeof(FloatBuffer) + sizeof(float) * numel);
     self.data->numel = numel;
-
-    // Initialize tensor with random values
-    float* data_ptr = self.data->flex;
-    for(int i = 0; i < numel; i++) {
-        data_ptr[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-    }
+    self.data->flags = 0;
+    self.data->dtype = TensorDType_F32;
+    self.data->packed = NULL;
+    self.data->flex = (float*)(self.data + 1);
 
     if(requires_grad) {
         self.node = _cten_malloc(sizeof(GradNode));
@@ -68,26 +109,70 @@ Tensor Tensor_zeros(TensorShape shape, bool requires_grad) {
 
 Tensor Tensor_ones(TensorShape shape, bool requires_grad) {
     Tensor self = Tensor_new(shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
+    for(size_t i = 0; i < self.data->numel; i++) {
         self.data->flex[i] = 1.0f;
     }
     return self;
 }
 
+Tensor Tensor_from_buffer(TensorShape shape, const float* data, int flags) {
+    cten_assert(data != NULL, "Tensor_from_buffer() got a NULL data pointer");
+    Tensor self;
+    _cten_set_shape(&self, shape);
+
+    self.data = _cten_malloc(sizeof(FloatBuffer));
+    self.data->numel = self.numel;
+    self.data->flags = (flags & FloatBuffer_ReadOnly) | FloatBuffer_External;
+    self.data->dtype = TensorDType_F32;
+    self.data->packed = NULL;
+    // the storage is only written through when the caller left out FloatBuffer_ReadOnly
+    self.data->flex = (float*)data;
+    self.node = NULL;
+    return self;
+}
+
+Tensor Tensor_from_int_buffer(TensorShape shape, const int32_t* data, int flags) {
+    cten_assert(data != NULL, "Tensor_from_int_buffer() got a NULL data pointer");
+    Tensor self;
+    _cten_set_shape(&self, shape);
+
+    self.data = _cten_malloc(sizeof(FloatBuffer));
+    self.data->numel = self.numel;
+    self.data->flags = (flags & FloatBuffer_ReadOnly) | FloatBuffer_External;
+    self.data->dtype = TensorDType_I32;
+    self.data->packed = NULL;
+    self.data->flexi = (int32_t*)data;
+    self.node = NULL;
+    return self;
+}
+
+bool Tensor_is_readonly(Tensor self) {
+    return self.data != NULL && (self.data->flags & FloatBuffer_ReadOnly) != 0;
+}
+
+void _cten_assert_writable(const char* title, Tensor self) {
+    cten_assert(!Tensor_is_readonly(self), "%s: tensor storage is read-only", title);
+}
+
+void _cten_mark_modified(Tensor self) {
+    if(self.data->packed != NULL) self.data->packed->stale = true;
+}
+
 Tensor Tensor_transpose(Tensor self) {
-    int dim = TensorShape_dim(self.shape);
+    int dim = self.ndim;
     if(dim < 2) { return self; }
+    self = _cten_as_f32(self);
     TensorShape new_shape;
     new_shape[0] = self.shape[1];
     new_shape[1] = self.shape[0];
-    for(int i = 2; i < 4; i++) {
+    for(int i = 2; i < CTEN_MAX_DIMS; i++) {
         new_shape[i] = self.shape[i];
     }
     Tensor result = Tensor_new(new_shape, false);
-    int rows = self.shape[0];
-    int cols = self.shape[1];
-    for(int i = 0; i < rows; i++) {
-        for(int j = 0; j < cols; j++) {
+    size_t rows = self.shape[0];
+    size_t cols = self.shape[1];
+    for(size_t i = 0; i < rows; i++) {
+        for(size_t j = 0; j < cols; j++) {
             result.data->flex[j * rows + i] = self.data->flex[i * cols + j];
         }
     }
@@ -99,17 +184,23 @@ float Tensor_get(Tensor self, int i, int j, int k, int l) {
     assert((self.shape[1] == 0 && j == 0) || (j >= 0 && j < self.shape[1]));
     assert((self.shape[2] == 0 && k == 0) || (k >= 0 && k < self.shape[2]));
     assert((self.shape[3] == 0 && l == 0) || (l >= 0 && l < self.shape[3]));
-    return self.data->flex[i * self.shape[1] * self.shape[2] * self.shape[3] +
-                           j * self.shape[2] * self.shape[3] + k * self.shape[3] + l];
+    float value;
+    return *_cten_load_f32(self.data, _cten_offset4(&self, i, j, k, l), 1, &value);
 }
 
 void Tensor_set(Tensor self, int i, int j, int k, int l, float value) {
+    _cten_assert_writable("Tensor_set()", self);
     assert((self.shape[0] == 0 && i == 0) || (i >= 0 && i < self.shape[0]));
     assert((self.shape[1] == 0 && j == 0) || (j >= 0 && j < self.shape[1]));
     assert((self.shape[2] == 0 && k == 0) || (k >= 0 && k < self.shape[2]));
     assert((self.shape[3] == 0 && l == 0) || (l >= 0 && l < self.shape[3]));
-    self.data->flex[i * self.shape[1] * self.shape[2] * self.shape[3] +
-                    j * self.shape[2] * self.shape[3] + k * self.shape[3] + l] = value;
+    size_t offset = _cten_offset4(&self, i, j, k, l);
+    _cten_mark_modified(self);
+    if(self.data->dtype == TensorDType_F32) {
+        self.data->flex[offset] = value;
+    } else {
+        _cten_narrow(&value, self.data, offset, 1);
+    }
 }
 
 Tensor Tensor_detach(Tensor self) {
@@ -145,11 +236,10 @@ void Tensor_backward(Tensor self, Tensor grad) {
 
         // This is the gradient flowing from the output, which we need to propagate backwards.
         Tensor grad = self.node->grad;
-        int input_ndim = TensorShape_dim(input_tensor.shape);
-        int grad_ndim = TensorShape_dim(grad.shape);
+        int input_ndim = input_tensor.ndim;
+        int grad_ndim = grad.ndim;
 
-        if((strcmp(self.node->name, "Sum") == 0 || strcmp(self.node->name, "Mean") == 0 ||
-            strcmp(self.node->name, "MaxDim") == 0 || strcmp(self.node->name, "MinDim") == 0) &&
+        if((strcmp(self.node->name, "Sum") == 0 || strcmp(self.node->name, "Mean") == 0) &&
            input_ndim > grad_ndim) {
             // Find the dimension that was reduced. We assume the non-reduced dimensions match in
             // size.
@@ -173,14 +263,12 @@ void Tensor_backward(Tensor self, Tensor grad) {
 
         // Step 2: Apply the chain rule (upstream_grad * local_grad)
         Tensor combined_grad;
-        if(strcmp(self.node->name, "Softmax") == 0) {
+        if(strcmp(self.node->name, "Softmax") == 0 || strcmp(self.node->name, "Matmul") == 0 ||
+           strcmp(self.node->name, "LinearAct") == 0 || strcmp(self.node->name, "Reduce") == 0 ||
+           strcmp(self.node->name, "SoftmaxCrossEntropy") == 0 ||
+           strcmp(self.node->name, "LogSoftmax") == 0 || strcmp(self.node->name, "NLLLoss") == 0) {
+            // these grad_fns already apply the upstream gradient
             combined_grad = input_grad;
-        } else if(strcmp(self.node->name, "Matmul") == 0) {
-            if(i == 0) {
-                combined_grad = Tensor_matmul(grad, input_grad);
-            } else {
-                combined_grad = Tensor_matmul(input_grad, grad);
-            }
         } else {
             combined_grad = Tensor_mul(grad, input_grad);
         }
@@ -188,13 +276,8 @@ void Tensor_backward(Tensor self, Tensor grad) {
         // Step 3: Handle broadcasting. --> If the original input was broadcasted, the resulting
         // gradient will have the broadcasted shape, it must be reduced back down to the original
         // input's shape.
-        bool needs_reduction = false;
-        for(int dim = 0; dim < 4; dim++) {
-            if(combined_grad.shape[dim] != input_tensor.shape[dim]) {
-                needs_reduction = true;
-                break;
-            }
-        }
+        bool needs_reduction =
+            memcmp(combined_grad.shape, input_tensor.shape, sizeof(TensorShape)) != 0;
 
         if(needs_reduction) {
             combined_grad =
@@ -219,13 +302,14 @@ void Tensor_print(Tensor self) {
         printf("Tensor()\n");
         return;
     }
+    self.data = _cten_as_f32(self).data;
     printf("Tensor([");
-    for(int i = 0; i < self.data->numel; i++) {
+    for(size_t i = 0; i < self.data->numel; i++) {
         printf("%.4f", self.data->flex[i]);
-        if(i < self.data->numel - 1) printf(", ");
+        if(i + 1 < self.data->numel) printf(", ");
     }
     printf("], shape=(");
-    for(int i = 0; i < 4; i++) {
+    for(int i = 0; i < CTEN_MAX_DIMS; i++) {
         if(self.shape[i] == 0) {
             break;
         } else {
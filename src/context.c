@@ -1,10 +1,80 @@
 #include "cten.h"
 #include "cten_internal.h"
 
-static int _eval_depth = 0;
+#include <stdlib.h>
 
-void cten_begin_eval() { _eval_depth++; }
+/* Everything an inference or training session changes as it runs (the allocation pools, the eval
+ * depth and the random generator) lives in a cten_Context. Each thread works on the context it
+ * bound with cten_set_context(), or on the default context created by cten_initilize(), so threads
+ * on different contexts never share mutable state. Settings that are chosen once per process (the
+ * SIMD level, math mode and thread count) stay global. */
 
-bool cten_is_eval() { return _eval_depth > 0; }
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
 
-void cten_end_eval() { _eval_depth--; }
\ No newline at end of file
+// seed of every new context, so unseeded runs stay reproducible
+#define DEFAULT_SEED 0x853c49e6748fea9bULL
+
+struct cten_Context {
+    PoolAllocator* pools;
+    int eval_depth;
+    uint64_t rng_state;
+};
+
+static cten_Context g_default_context;
+static THREAD_LOCAL cten_Context* t_context = &g_default_context;
+
+void _cten_context_init() {
+    g_default_context = (cten_Context){_cten_pools_new(), 0, DEFAULT_SEED};
+}
+
+void _cten_context_shutdown() {
+    _cten_pools_free(g_default_context.pools);
+    g_default_context.pools = NULL;
+    t_context = &g_default_context;
+}
+
+PoolAllocator* _cten_current_pools() { return t_context->pools; }
+
+cten_Context* cten_context_new() {
+    cten_Context* self = malloc(sizeof(cten_Context));
+    cten_assert(self != NULL, "out of memory allocating a context");
+    *self = (cten_Context){_cten_pools_new(), 0, DEFAULT_SEED};
+    return self;
+}
+
+void cten_context_free(cten_Context* self) {
+    cten_assert(self != &g_default_context, "cten_context_free(): cannot free the default context");
+    if(t_context == self) t_context = &g_default_context;
+    _cten_pools_free(self->pools);
+    free(self);
+}
+
+cten_Context* cten_set_context(cten_Context* self) {
+    cten_Context* prev = t_context;
+    t_context = self != NULL ? self : &g_default_context;
+    return prev;
+}
+
+cten_Context* cten_context() { return t_context; }
+
+void cten_begin_eval() { t_context->eval_depth++; }
+
+bool cten_is_eval() { return t_context->eval_depth > 0; }
+
+void cten_end_eval() { t_context->eval_depth--; }
+
+void cten_seed(uint64_t seed) { t_context->rng_state = seed; }
+
+// splitmix64: one add and a mixing function per draw, every seed giving a full-period stream
+uint32_t _cten_rand_u32() {
+    uint64_t z = (t_context->rng_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+float _cten_rand_uniform() { return (float)(_cten_rand_u32() >> 8) * 0x1p-24f; }
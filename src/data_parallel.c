@@ -0,0 +1,508 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Data-parallel training. Every shard owns a cten_Context whose pools hold its graph, and a view
+ * of each parameter that shares the parameter's data but has its own GradNode, so shards build
+ * and backpropagate their graphs concurrently without touching each other's state. The
+ * parameters are only read until all shards finish.
+ *
+ * The shards' gradients are then summed block by block: for each block of REDUCE_BLOCK elements
+ * the shards are added pairwise in a fixed tree (0 += 1, 2 += 3, ..., then 0 += 2, ...) while the
+ * block is still in cache, and the total is added to the parameter's gradient. Blocks are
+ * independent, so they split across the thread pool, and the tree does not depend on how. */
+
+#define REDUCE_BLOCK 4096
+
+// pools inside each shard's context
+#define POOL_REPLICAS 0
+#define POOL_STEP 1
+
+typedef struct nn_data_parallel {
+    int n_params;
+    Tensor* params;
+    int n_shards;
+    cten_Context** contexts;
+    Tensor* replicas;  // [n_shards][n_params]
+    float* losses;     // each shard's weighted loss from the last step
+} nn_data_parallel;
+
+nn_data_parallel* nn_data_parallel_new(int n_params, Tensor* params, int n_shards) {
+    cten_assert(n_params >= 0, "DataParallel: n_params cannot be negative, but got %d.", n_params);
+    if(n_params > 0) {
+        cten_assert(params != NULL, "DataParallel: params cannot be NULL when n_params > 0.");
+    }
+    if(n_shards <= 0) n_shards = cten_num_threads();
+
+    nn_data_parallel* self = malloc(sizeof(nn_data_parallel));
+    cten_assert(self != NULL, "DataParallel: out of memory");
+    self->n_params = n_params;
+    self->params = params;
+    self->n_shards = n_shards;
+    self->contexts = malloc(sizeof(cten_Context*) * n_shards);
+    self->replicas = malloc(sizeof(Tensor) * n_shards * (n_params > 0 ? n_params : 1));
+    self->losses = malloc(sizeof(float) * n_shards);
+    cten_assert(self->contexts != NULL && self->replicas != NULL && self->losses != NULL,
+                "DataParallel: out of memory");
+
+    for(int k = 0; k < n_shards; k++) {
+        self->contexts[k] = cten_context_new();
+        cten_Context* prev = cten_set_context(self->contexts[k]);
+        cten_begin_malloc(POOL_REPLICAS);
+        for(int i = 0; i < n_params; i++) {
+            Tensor replica = params[i];
+            if(replica.node != NULL) {
+                replica.node = _cten_malloc(sizeof(GradNode));
+                memset(replica.node, 0, sizeof(GradNode));
+            }
+            self->replicas[k * n_params + i] = replica;
+        }
+        cten_end_malloc();
+        cten_set_context(prev);
+    }
+    return self;
+}
+
+void nn_data_parallel_free(nn_data_parallel* self) {
+    for(int k = 0; k < self->n_shards; k++) {
+        cten_context_free(self->contexts[k]);
+    }
+    free(self->contexts);
+    free(self->replicas);
+    free(self->losses);
+    free(self);
+}
+
+// Rows [lo, hi) of a float32 or int32 tensor, without copying
+static Tensor shard_rows(Tensor t, size_t lo, size_t hi) {
+    if(t.data == NULL) return t;
+    TensorShape shape;
+    memcpy(shape, t.shape, sizeof(TensorShape));
+    shape[0] = (int)(hi - lo);
+    size_t row = t.numel / t.shape[0];
+    if(t.data->dtype == TensorDType_I32) {
+        return Tensor_from_int_buffer(shape, t.data->flexi + lo * row, FloatBuffer_ReadOnly);
+    }
+    return Tensor_from_buffer(shape, t.data->flex + lo * row, FloatBuffer_ReadOnly);
+}
+
+typedef struct ShardTask {
+    nn_data_parallel* self;
+    nn_ShardLoss loss_fn;
+    void* user;
+    Tensor x, y;
+    size_t n;  // samples in the batch
+} ShardTask;
+
+static void run_shards(void* ctx, size_t begin, size_t end) {
+    const ShardTask* t = ctx;
+    nn_data_parallel* self = t->self;
+    for(size_t k = begin; k < end; k++) {
+        size_t lo = t->n * k / self->n_shards, hi = t->n * (k + 1) / self->n_shards;
+        Tensor* params = self->replicas + k * self->n_params;
+        for(int i = 0; i < self->n_params; i++) {
+            if(params[i].node != NULL) params[i].node->grad = (Tensor){0};
+        }
+        self->losses[k] = 0.0f;
+        if(lo == hi) continue;
+
+        cten_Context* prev = cten_set_context(self->contexts[k]);
+        cten_begin_malloc(POOL_STEP);
+        Tensor x = shard_rows(t->x, lo, hi), y = shard_rows(t->y, lo, hi);
+        Tensor loss = t->loss_fn(params, x, y, t->user);
+        cten_assert(loss.numel == 1, "DataParallel: the shard loss must be a scalar");
+        // the batch loss is the mean of the shard losses weighted by their share of the rows
+        float weight = (float)(hi - lo) / (float)t->n;
+        Tensor upstream = Tensor_new((TensorShape){1}, false);
+        upstream.data->flex[0] = weight;
+        Tensor_backward(loss, upstream);
+        self->losses[k] = loss.data->flex[0] * weight;
+        cten_end_malloc();
+        cten_set_context(prev);
+    }
+}
+
+typedef struct ReduceTask {
+    float** grads;  // the shards' gradients of one parameter, summed in place
+    int n_grads;
+    const float* prev;  // the parameter's gradient so far, or NULL
+    float* out;
+    size_t numel;
+} ReduceTask;
+
+static void reduce_blocks(void* ctx, size_t begin, size_t end) {
+    const ReduceTask* t = ctx;
+    for(size_t b = begin; b < end; b++) {
+        size_t lo = b * REDUCE_BLOCK;
+        size_t len = t->numel - lo < REDUCE_BLOCK ? t->numel - lo : REDUCE_BLOCK;
+        for(int stride = 1; stride < t->n_grads; stride *= 2) {
+            for(int k = 0; k + stride < t->n_grads; k += 2 * stride) {
+                float* dst = t->grads[k] + lo;
+                _cten_kernels.add(dst, t->grads[k + stride] + lo, dst, len);
+            }
+        }
+        if(t->prev != NULL) {
+            _cten_kernels.add(t->prev + lo, t->grads[0] + lo, t->out + lo, len);
+        } else {
+            memcpy(t->out + lo, t->grads[0] + lo, sizeof(float) * len);
+        }
+    }
+}
+
+float nn_data_parallel_backward(nn_data_parallel* self,
+                                nn_ShardLoss loss_fn,
+                                void* user,
+                                Tensor x,
+                                Tensor y) {
+    cten_assert(x.ndim >= 1 && x.shape[0] > 0, "DataParallel: x needs samples along dim 0");
+    if(y.data != NULL) {
+        cten_assert(y.ndim >= 1 && y.shape[0] == x.shape[0],
+                    "DataParallel: x has %d samples but y has %d",
+                    x.shape[0],
+                    y.ndim >= 1 ? y.shape[0] : 0);
+        if(y.data->dtype != TensorDType_I32) y = _cten_as_f32(y);
+    }
+    if(x.data->dtype != TensorDType_I32) x = _cten_as_f32(x);
+
+    // views share the parameters' current storage; stale GEMM panels are repacked here, once,
+    // rather than by every shard at the same time
+    for(int i = 0; i < self->n_params; i++) {
+        for(int k = 0; k < self->n_shards; k++) {
+            Tensor* replica = &self->replicas[k * self->n_params + i];
+            GradNode* node = replica->node;
+            *replica = self->params[i];
+            replica->node = node;
+        }
+        if(self->params[i].data->packed != NULL) _cten_weight_panels(self->params[i], false);
+    }
+
+    ShardTask task = {self, loss_fn, user, x, y, (size_t)x.shape[0]};
+    _cten_parallel_for(self->n_shards, 1, run_shards, &task);
+
+    float** grads = malloc(sizeof(float*) * self->n_shards);
+    cten_assert(grads != NULL, "DataParallel: out of memory");
+    for(int i = 0; i < self->n_params; i++) {
+        Tensor p = self->params[i];
+        if(p.node == NULL) continue;
+        ReduceTask t = {grads, 0, NULL, NULL, p.numel};
+        for(int k = 0; k < self->n_shards; k++) {
+            GradNode* node = self->replicas[k * self->n_params + i].node;
+            if(node == NULL || node->grad.data == NULL) continue;
+            Tensor g = node->grad;
+            cten_assert(g.numel == p.numel, "DataParallel: gradient shape of parameter %d", i);
+            grads[t.n_grads++] = g.data->flex;
+        }
+        if(t.n_grads == 0) continue;
+        // a new tensor, as Tensor_backward() accumulates, since the old one may be shared
+        Tensor total = Tensor_new(p.shape, false);
+        if(p.node->grad.data != NULL) t.prev = _cten_as_f32(p.node->grad).data->flex;
+        t.out = total.data->flex;
+        size_t n_blocks = (p.numel + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+        size_t grain = _CTEN_GRAIN / REDUCE_BLOCK;
+        _cten_parallel_for(n_blocks, grain, reduce_blocks, &t);
+        p.node->grad = total;
+    }
+    free(grads);
+
+    float loss = 0.0f;
+    for(int k = 0; k < self->n_shards; k++) {
+        cten_Context* prev = cten_set_context(self->contexts[k]);
+        cten_free(POOL_STEP);
+        cten_set_context(prev);
+        loss += self->losses[k];
+    }
+    return loss;
+}
+
+/* Hogwild training. Each worker owns a cten_Context and, for every trainable parameter, a private
+ * copy with its own GradNode. A step snapshots the shared parameters into the copies, builds and
+ * backpropagates the worker's minibatch on them, and adds the SGD update straight into the shared
+ * parameters, with no lock and no barrier between workers.
+ *
+ * Every access to a shared trainable element while workers run is a relaxed atomic: the snapshot
+ * is made of relaxed loads and the update of relaxed compare-and-swap additions. An element can
+ * therefore never be torn and no addition is lost, but a snapshot may mix elements from before
+ * and after another worker's step, which is the inconsistency Hogwild tolerates. No kernel ever
+ * reads the shared buffers directly, and the pool's join orders all updates before the caller
+ * returns. Frozen parameters (no GradNode) are only read, so workers share them as they are.
+ * When a single thread runs all the workers in turn, nothing is concurrent and plain accesses
+ * are used instead. */
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+// MSVC compiles C without <stdatomic.h>; aligned 32-bit volatile loads and interlocked exchanges
+// are single-copy atomic, and the iso_volatile forms add no fence, so both are relaxed
+static float load_relaxed(float* p) {
+    __int32 bits = __iso_volatile_load32((volatile __int32*)p);
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+static void add_relaxed(float* p, float delta) {
+    volatile long* bits = (volatile long*)p;
+    long seen = __iso_volatile_load32((volatile __int32*)p);
+    for(;;) {
+        float value;
+        memcpy(&value, &seen, sizeof(float));
+        value += delta;
+        long next;
+        memcpy(&next, &value, sizeof(float));
+        long prev = _InterlockedCompareExchange(bits, next, seen);
+        if(prev == seen) break;
+        seen = prev;
+    }
+}
+#else
+#include <stdatomic.h>
+
+_Static_assert(sizeof(_Atomic float) == sizeof(float) && _Alignof(_Atomic float) == _Alignof(float),
+               "parameter buffers are accessed in place as _Atomic float");
+
+static float load_relaxed(float* p) {
+    return atomic_load_explicit((_Atomic float*)p, memory_order_relaxed);
+}
+
+static void add_relaxed(float* p, float delta) {
+    _Atomic float* a = (_Atomic float*)p;
+    float seen = atomic_load_explicit(a, memory_order_relaxed);
+    while(!atomic_compare_exchange_weak_explicit(a,
+                                                 &seen,
+                                                 seen + delta,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed)) {}
+}
+#endif
+
+typedef struct nn_hogwild {
+    int n_params;
+    Tensor* params;
+    int n_workers;
+    float lr;
+    float momentum;
+    float weight_decay;
+    cten_Context** contexts;
+    Tensor* replicas;  // [n_workers][n_params]; frozen parameters are the parameter itself
+    Tensor* velocity;  // [n_workers][n_params] once momentum is configured, else NULL
+    float* losses;     // each worker's summed step losses from the last call
+} nn_hogwild;
+
+static bool is_trainable(Tensor p) { return p.node != NULL; }
+
+nn_hogwild* nn_hogwild_new(int n_params, Tensor* params, int n_workers, float weight_decay) {
+    cten_assert(n_params >= 0, "Hogwild: n_params cannot be negative, but got %d.", n_params);
+    if(n_params > 0) {
+        cten_assert(params != NULL, "Hogwild: params cannot be NULL when n_params > 0.");
+    }
+    if(n_workers <= 0) n_workers = cten_num_threads();
+
+    nn_hogwild* self = malloc(sizeof(nn_hogwild));
+    cten_assert(self != NULL, "Hogwild: out of memory");
+    self->n_params = n_params;
+    self->params = params;
+    self->n_workers = n_workers;
+    self->lr = 0.001f;
+    self->momentum = 0.0f;
+    self->weight_decay = weight_decay;
+    self->contexts = malloc(sizeof(cten_Context*) * n_workers);
+    self->replicas = malloc(sizeof(Tensor) * n_workers * (n_params > 0 ? n_params : 1));
+    self->velocity = NULL;
+    self->losses = malloc(sizeof(float) * n_workers);
+    cten_assert(self->contexts != NULL && self->replicas != NULL && self->losses != NULL,
+                "Hogwild: out of memory");
+
+    for(int i = 0; i < n_params; i++) {
+        if(!is_trainable(params[i])) continue;
+        cten_assert(params[i].data->dtype == TensorDType_F32,
+                    "Hogwild: trainable parameter %d must be float32",
+                    i);
+        _cten_assert_writable("nn_hogwild_new()", params[i]);
+    }
+    for(int k = 0; k < n_workers; k++) {
+        self->contexts[k] = cten_context_new();
+        cten_Context* prev = cten_set_context(self->contexts[k]);
+        cten_begin_malloc(POOL_REPLICAS);
+        for(int i = 0; i < n_params; i++) {
+            Tensor p = params[i];
+            self->replicas[k * n_params + i] = is_trainable(p) ? Tensor_new(p.shape, true) : p;
+        }
+        cten_end_malloc();
+        cten_set_context(prev);
+    }
+    return self;
+}
+
+void nn_hogwild_config(nn_hogwild* self, float lr, float momentum) {
+    cten_assert(momentum >= 0.0f, "Momentum must be non-negative, but got %f", momentum);
+    self->lr = lr;
+    self->momentum = momentum;
+
+    if(self->velocity == NULL && self->momentum > 0.0f) {
+        int n_params = self->n_params;
+        self->velocity = malloc(sizeof(Tensor) * self->n_workers * (n_params > 0 ? n_params : 1));
+        cten_assert(self->velocity != NULL, "Hogwild: out of memory");
+        for(int k = 0; k < self->n_workers; k++) {
+            cten_Context* prev = cten_set_context(self->contexts[k]);
+            cten_begin_malloc(POOL_REPLICAS);
+            for(int i = 0; i < n_params; i++) {
+                Tensor p = self->params[i];
+                self->velocity[k * n_params + i] =
+                    is_trainable(p) ? Tensor_zeros(p.shape, false) : (Tensor){0};
+            }
+            cten_end_malloc();
+            cten_set_context(prev);
+        }
+    }
+}
+
+void nn_hogwild_free(nn_hogwild* self) {
+    for(int k = 0; k < self->n_workers; k++) {
+        cten_context_free(self->contexts[k]);
+    }
+    free(self->contexts);
+    free(self->replicas);
+    free(self->velocity);
+    free(self->losses);
+    free(self);
+}
+
+typedef struct HogwildTask {
+    nn_hogwild* self;
+    nn_ShardLoss loss_fn;
+    void* user;
+    Tensor x, y;
+    size_t n;  // samples in the dataset
+    size_t batch_size;
+    size_t n_steps;
+    bool concurrent;  // false when the workers run one after another on the caller
+} HogwildTask;
+
+// One SGD update of a shared parameter from a worker's gradient, taken at its snapshot `at`
+static void hogwild_update(const nn_hogwild* self,
+                           bool concurrent,
+                           float* param,
+                           const float* at,
+                           const float* grad,
+                           float* velocity,
+                           size_t numel) {
+    for(size_t j = 0; j < numel; j++) {
+        float grad_val = grad[j];
+        if(self->weight_decay > 0.0f) { grad_val += self->weight_decay * at[j]; }
+        if(velocity != NULL) {
+            velocity[j] = self->momentum * velocity[j] + grad_val;
+            grad_val = velocity[j];
+        }
+        if(concurrent) {
+            add_relaxed(&param[j], -self->lr * grad_val);
+        } else {
+            param[j] -= self->lr * grad_val;
+        }
+    }
+}
+
+static void run_workers(void* ctx, size_t begin, size_t end) {
+    const HogwildTask* t = ctx;
+    nn_hogwild* self = t->self;
+    size_t n_batches = (t->n + t->batch_size - 1) / t->batch_size;
+    for(size_t k = begin; k < end; k++) {
+        Tensor* replicas = self->replicas + k * self->n_params;
+        Tensor* velocity = self->velocity ? self->velocity + k * self->n_params : NULL;
+        self->losses[k] = 0.0f;
+        cten_Context* prev = cten_set_context(self->contexts[k]);
+        // worker k takes steps k, k + n_workers, ...; step s trains on batch s % n_batches
+        for(size_t s = k; s < t->n_steps; s += self->n_workers) {
+            for(int i = 0; i < self->n_params; i++) {
+                Tensor p = self->params[i];
+                if(!is_trainable(p)) continue;
+                float* copy = replicas[i].data->flex;
+                if(t->concurrent) {
+                    for(size_t j = 0; j < p.numel; j++) {
+                        copy[j] = load_relaxed(&p.data->flex[j]);
+                    }
+                } else {
+                    memcpy(copy, p.data->flex, sizeof(float) * p.numel);
+                }
+                replicas[i].node->grad = (Tensor){0};
+            }
+
+            cten_begin_malloc(POOL_STEP);
+            size_t lo = s % n_batches * t->batch_size;
+            size_t hi = lo + t->batch_size < t->n ? lo + t->batch_size : t->n;
+            Tensor x = shard_rows(t->x, lo, hi), y = shard_rows(t->y, lo, hi);
+            Tensor loss = t->loss_fn(replicas, x, y, t->user);
+            cten_assert(loss.numel == 1, "Hogwild: the minibatch loss must be a scalar");
+            Tensor_backward(loss, (Tensor){0});
+            self->losses[k] += loss.data->flex[0];
+
+            for(int i = 0; i < self->n_params; i++) {
+                Tensor p = self->params[i];
+                Tensor g = is_trainable(p) ? replicas[i].node->grad : (Tensor){0};
+                if(g.data == NULL) continue;
+                cten_assert(g.numel == p.numel, "Hogwild: gradient shape of parameter %d", i);
+                g = _cten_as_f32(g);
+                hogwild_update(self,
+                               t->concurrent,
+                               p.data->flex,
+                               replicas[i].data->flex,
+                               g.data->flex,
+                               velocity ? velocity[i].data->flex : NULL,
+                               p.numel);
+            }
+            cten_end_malloc();
+            cten_free(POOL_STEP);
+        }
+        cten_set_context(prev);
+    }
+}
+
+float nn_hogwild_train(nn_hogwild* self,
+                       nn_ShardLoss loss_fn,
+                       void* user,
+                       Tensor x,
+                       Tensor y,
+                       int batch_size,
+                       int n_steps) {
+    cten_assert(x.ndim >= 1 && x.shape[0] > 0, "Hogwild: x needs samples along dim 0");
+    cten_assert(batch_size > 0, "Hogwild: batch_size must be positive, but got %d", batch_size);
+    cten_assert(n_steps >= 0, "Hogwild: n_steps cannot be negative, but got %d", n_steps);
+    if(y.data != NULL) {
+        cten_assert(y.ndim >= 1 && y.shape[0] == x.shape[0],
+                    "Hogwild: x has %d samples but y has %d",
+                    x.shape[0],
+                    y.ndim >= 1 ? y.shape[0] : 0);
+        if(y.data->dtype != TensorDType_I32) y = _cten_as_f32(y);
+    }
+    if(x.data->dtype != TensorDType_I32) x = _cten_as_f32(x);
+    if(n_steps == 0) return 0.0f;
+
+    for(int i = 0; i < self->n_params; i++) {
+        Tensor p = self->params[i];
+        if(p.data->packed == NULL) continue;
+        // workers never read the panels of what they train, but share those of frozen weights
+        if(is_trainable(p)) {
+            _cten_mark_modified(p);
+        } else {
+            _cten_weight_panels(p, false);
+        }
+    }
+
+    HogwildTask task = {self,
+                        loss_fn,
+                        user,
+                        x,
+                        y,
+                        (size_t)x.shape[0],
+                        (size_t)batch_size,
+                        (size_t)n_steps,
+                        self->n_workers > 1 && cten_num_threads() > 1};
+    _cten_parallel_for(self->n_workers, 1, run_workers, &task);
+
+    float loss = 0.0f;
+    for(int k = 0; k < self->n_workers; k++) {
+        loss += self->losses[k];
+    }
+    return loss / (float)n_steps;
+}
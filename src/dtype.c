@@ -0,0 +1,188 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__F16C__) && defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FP16_FORMAT_IEEE)
+#include <arm_neon.h>
+#endif
+
+static inline uint32_t f32_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline float f32_from_bits(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Both directions select between cases with masks instead of branches so the fallback loops
+// vectorize; `mask(c)` is all ones when `c` holds.
+static inline uint32_t mask(uint32_t c) { return 0u - c; }
+
+static inline float f16_to_f32(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t em = h & 0x7fff;
+    uint32_t normal = (em << 13) + ((127u - 15u) << 23);              // rebias the exponent
+    normal += mask(em >= 0x7c00) & ((128u - 16u) << 23);              // inf / NaN
+    uint32_t subnormal = f32_bits((float)em * 5.9604644775390625e-8f);  // em * 2^-24
+    uint32_t is_sub = mask(em < 0x400);
+    return f32_from_bits((subnormal & is_sub) | (normal & ~is_sub) | sign);
+}
+
+static inline uint16_t f32_to_f16(float f) {
+    // round-to-nearest-even, overflow saturates to inf, NaN stays a quiet NaN
+    const float denorm_magic = f32_from_bits(((127u - 15u) + (23u - 10u) + 1u) << 23);
+    uint32_t u = f32_bits(f);
+    uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+    uint32_t mant_odd = (u >> 13) & 1;
+    uint32_t normal = (u + ((uint32_t)(15 - 127) << 23) + 0xfff + mant_odd) >> 13;
+    uint32_t subnormal = f32_bits(f32_from_bits(u) + denorm_magic) - f32_bits(denorm_magic);
+    uint32_t is_sub = mask(u < (113u << 23));
+    uint32_t h = (subnormal & is_sub) | (normal & ~is_sub);
+    uint32_t special = 0x7c00 | (mask(u > (255u << 23)) & 0x0200);
+    uint32_t is_special = mask(u >= ((127u + 16u) << 23));
+    h = (special & is_special) | (h & ~is_special);
+    return (uint16_t)(h | (sign >> 16));
+}
+
+float _cten_f16_to_f32(uint16_t h) { return f16_to_f32(h); }
+
+uint16_t _cten_f32_to_f16(float f) { return f32_to_f16(f); }
+
+float _cten_bf16_to_f32(uint16_t h) { return f32_from_bits((uint32_t)h << 16); }
+
+static inline uint16_t f32_to_bf16(float f) {
+    uint32_t u = f32_bits(f);
+    uint32_t rounded = (u + 0x7fff + ((u >> 16) & 1)) >> 16;
+    uint32_t is_nan = mask((u & 0x7fffffffu) > 0x7f800000u);
+    return (uint16_t)((((u >> 16) | 0x40) & is_nan) | (rounded & ~is_nan));
+}
+
+uint16_t _cten_f32_to_bf16(float f) { return f32_to_bf16(f); }
+
+static void widen_f16(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+    for(; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+#elif defined(__aarch64__) && defined(__ARM_FP16_FORMAT_IEEE)
+    for(; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vcvt_f32_f16(vld1_f16((const __fp16*)(src + i))));
+    }
+#endif
+    for(; i < n; i++) {
+        dst[i] = f16_to_f32(src[i]);
+    }
+}
+
+static void narrow_f16(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+    for(; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+#elif defined(__aarch64__) && defined(__ARM_FP16_FORMAT_IEEE)
+    for(; i + 4 <= n; i += 4) {
+        vst1_f16((__fp16*)(dst + i), vcvt_f16_f32(vld1q_f32(src + i)));
+    }
+#endif
+    for(; i < n; i++) {
+        dst[i] = f32_to_f16(src[i]);
+    }
+}
+
+static void widen_bf16(const uint16_t* src, float* dst, size_t n) {
+    // a plain shift, which compilers vectorize on every target
+    for(size_t i = 0; i < n; i++) {
+        uint32_t u = (uint32_t)src[i] << 16;
+        memcpy(dst + i, &u, sizeof(u));
+    }
+}
+
+static void narrow_bf16(const float* src, uint16_t* dst, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        dst[i] = f32_to_bf16(src[i]);
+    }
+}
+
+static void widen_i32(const int32_t* src, float* dst, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        dst[i] = (float)src[i];
+    }
+}
+
+static void narrow_i32(const float* src, int32_t* dst, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        dst[i] = (int32_t)lrintf(src[i]);
+    }
+}
+
+void _cten_widen(const FloatBuffer* buf, size_t start, size_t n, float* dst) {
+    switch(buf->dtype) {
+        case TensorDType_F16: widen_f16(buf->flex16 + start, dst, n); break;
+        case TensorDType_BF16: widen_bf16(buf->flex16 + start, dst, n); break;
+        case TensorDType_I32: widen_i32(buf->flexi + start, dst, n); break;
+        default: memcpy(dst, buf->flex + start, sizeof(float) * n); break;
+    }
+}
+
+void _cten_narrow(const float* src, FloatBuffer* buf, size_t start, size_t n) {
+    switch(buf->dtype) {
+        case TensorDType_F16: narrow_f16(src, buf->flex16 + start, n); break;
+        case TensorDType_BF16: narrow_bf16(src, buf->flex16 + start, n); break;
+        case TensorDType_I32: narrow_i32(src, buf->flexi + start, n); break;
+        default: memcpy(buf->flex + start, src, sizeof(float) * n); break;
+    }
+}
+
+size_t _cten_dtype_size(TensorDType dtype) {
+    switch(dtype) {
+        case TensorDType_F16:
+        case TensorDType_BF16: return sizeof(uint16_t);
+        case TensorDType_I32: return sizeof(int32_t);
+        default: return sizeof(float);
+    }
+}
+
+Tensor _cten_new_dtype(const int* shape, TensorDType dtype) {
+    Tensor self;
+    _cten_set_shape(&self, shape);
+    self.data = _cten_malloc(sizeof(FloatBuffer) + _cten_dtype_size(dtype) * self.numel);
+    self.data->numel = self.numel;
+    self.data->flags = 0;
+    self.data->dtype = dtype;
+    self.data->packed = NULL;
+    self.data->flex = (float*)(self.data + 1);
+    self.node = NULL;
+    return self;
+}
+
+TensorDType Tensor_dtype(Tensor self) { return (TensorDType)self.data->dtype; }
+
+Tensor Tensor_to(Tensor self, TensorDType dtype) {
+    if(self.data->dtype == (int)dtype) return self;
+
+    Tensor res = _cten_new_dtype(self.shape, dtype);
+    float block[_CTEN_LOAD_BLOCK];
+    for(size_t i = 0; i < self.numel; i += _CTEN_LOAD_BLOCK) {
+        size_t n = self.numel - i < _CTEN_LOAD_BLOCK ? self.numel - i : _CTEN_LOAD_BLOCK;
+        _cten_narrow(_cten_load_f32(self.data, i, n, block), res.data, i, n);
+    }
+    return res;
+}
+
+Tensor _cten_as_f32(Tensor self) {
+    if(self.data->dtype == TensorDType_F32) return self;
+    return Tensor_to(self, TensorDType_F32);
+}
@@ -0,0 +1,785 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Packed, cache-blocked GEMM in the style of BLIS/GotoBLAS.
+ *
+ * C is computed in KC-deep slabs: a KC x NC block of B is packed into NR-wide column panels that
+ * stay in L2/L3, an MC x KC block of A into MR-tall row panels that stay in L2, and the
+ * micro-kernel accumulates one MR x NR tile of C in registers while streaming one panel of each
+ * from L1.
+ * Packing zero-pads ragged edges, so the micro-kernel only ever sees full tiles. */
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define GEMM_MR 6
+#define GEMM_NR 16
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GEMM_MR 6
+#define GEMM_NR 8
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GEMM_MR 8
+#define GEMM_NR 8
+#else
+#define GEMM_MR 4
+#define GEMM_NR 8
+#endif
+
+#define GEMM_KC 256
+#define GEMM_MC (GEMM_MR * 16)
+#define GEMM_NC (GEMM_NR * 128)
+
+// below these sizes packing costs more than it saves (and needs a scratch allocation)
+#define GEMM_MIN_ROWS 8
+#define GEMM_MIN_DEPTH 4
+
+// ab[MR][NR] = a_panel @ b_panel over kc steps; a_panel is kc x MR, b_panel is kc x NR
+#if defined(__AVX2__) && defined(__FMA__)
+static void micro_kernel(size_t kc, const float* a, const float* b, float* ab) {
+    __m256 c[GEMM_MR][2];
+    for(int r = 0; r < GEMM_MR; r++) {
+        c[r][0] = _mm256_setzero_ps();
+        c[r][1] = _mm256_setzero_ps();
+    }
+    for(size_t k = 0; k < kc; k++) {
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+        for(int r = 0; r < GEMM_MR; r++) {
+            __m256 ar = _mm256_broadcast_ss(a + r);
+            c[r][0] = _mm256_fmadd_ps(ar, b0, c[r][0]);
+            c[r][1] = _mm256_fmadd_ps(ar, b1, c[r][1]);
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    for(int r = 0; r < GEMM_MR; r++) {
+        _mm256_storeu_ps(ab + r * GEMM_NR, c[r][0]);
+        _mm256_storeu_ps(ab + r * GEMM_NR + 8, c[r][1]);
+    }
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+static void micro_kernel(size_t kc, const float* a, const float* b, float* ab) {
+    __m128 c[GEMM_MR][2];
+    for(int r = 0; r < GEMM_MR; r++) {
+        c[r][0] = _mm_setzero_ps();
+        c[r][1] = _mm_setzero_ps();
+    }
+    for(size_t k = 0; k < kc; k++) {
+        __m128 b0 = _mm_loadu_ps(b);
+        __m128 b1 = _mm_loadu_ps(b + 4);
+        for(int r = 0; r < GEMM_MR; r++) {
+            __m128 ar = _mm_set1_ps(a[r]);
+            c[r][0] = _mm_add_ps(c[r][0], _mm_mul_ps(ar, b0));
+            c[r][1] = _mm_add_ps(c[r][1], _mm_mul_ps(ar, b1));
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    for(int r = 0; r < GEMM_MR; r++) {
+        _mm_storeu_ps(ab + r * GEMM_NR, c[r][0]);
+        _mm_storeu_ps(ab + r * GEMM_NR + 4, c[r][1]);
+    }
+}
+#elif defined(__ARM_NEON)
+static void micro_kernel(size_t kc, const float* a, const float* b, float* ab) {
+    float32x4_t c[GEMM_MR][2];
+    for(int r = 0; r < GEMM_MR; r++) {
+        c[r][0] = vdupq_n_f32(0.0f);
+        c[r][1] = vdupq_n_f32(0.0f);
+    }
+    for(size_t k = 0; k < kc; k++) {
+        float32x4_t b0 = vld1q_f32(b);
+        float32x4_t b1 = vld1q_f32(b + 4);
+        for(int r = 0; r < GEMM_MR; r++) {
+            c[r][0] = vmlaq_n_f32(c[r][0], b0, a[r]);
+            c[r][1] = vmlaq_n_f32(c[r][1], b1, a[r]);
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    for(int r = 0; r < GEMM_MR; r++) {
+        vst1q_f32(ab + r * GEMM_NR, c[r][0]);
+        vst1q_f32(ab + r * GEMM_NR + 4, c[r][1]);
+    }
+}
+#else
+static void micro_kernel(size_t kc, const float* a, const float* b, float* ab) {
+    float c[GEMM_MR][GEMM_NR] = {{0}};
+    for(size_t k = 0; k < kc; k++) {
+        for(int r = 0; r < GEMM_MR; r++) {
+            for(int j = 0; j < GEMM_NR; j++) {
+                c[r][j] += a[r] * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    memcpy(ab, c, sizeof(c));
+}
+#endif
+
+// A[i0.., k0..] (mc x kc) -> MR-row panels, each stored k-major: panel[k * MR + r]
+static void pack_a(size_t mc,
+                   size_t kc,
+                   const float* A,
+                   size_t rs,
+                   size_t cs,
+                   float* dst) {
+    for(size_t i = 0; i < mc; i += GEMM_MR) {
+        size_t mr = mc - i < GEMM_MR ? mc - i : GEMM_MR;
+        for(size_t k = 0; k < kc; k++) {
+            const float* src = A + i * rs + k * cs;
+            for(size_t r = 0; r < mr; r++) {
+                dst[r] = src[r * rs];
+            }
+            for(size_t r = mr; r < GEMM_MR; r++) {
+                dst[r] = 0.0f;
+            }
+            dst += GEMM_MR;
+        }
+    }
+}
+
+// B[k0.., j0..] (kc x nc) -> NR-column panels, each stored k-major: panel[k * NR + j]
+static void pack_b(size_t kc,
+                   size_t nc,
+                   const float* B,
+                   size_t rs,
+                   size_t cs,
+                   float* dst) {
+    for(size_t j = 0; j < nc; j += GEMM_NR) {
+        size_t nr = nc - j < GEMM_NR ? nc - j : GEMM_NR;
+        for(size_t k = 0; k < kc; k++) {
+            const float* src = B + k * rs + j * cs;
+            if(cs == 1 && nr == GEMM_NR) {
+                memcpy(dst, src, sizeof(float) * GEMM_NR);
+            } else {
+                for(size_t c = 0; c < nr; c++) {
+                    dst[c] = src[c * cs];
+                }
+                for(size_t c = nr; c < GEMM_NR; c++) {
+                    dst[c] = 0.0f;
+                }
+            }
+            dst += GEMM_NR;
+        }
+    }
+}
+
+// Offset of the (j0, k0) block of B in a whole-matrix panel layout: the NC-wide column blocks
+// follow each other, each holding its KC-deep slabs in order, and every slab is NR-padded
+static size_t panels_offset(size_t K, size_t j0, size_t k0, size_t nc) {
+    size_t nc_pad = (nc + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+    return j0 * K + k0 * nc_pad;
+}
+
+// Epilogue applied to each finished row segment of C: c[x] = act(c[x] + bias[x])
+void _cten_bias_act(float* c, const float* bias, size_t n, nn_Activation act) {
+    if(bias != NULL) {
+        for(size_t x = 0; x < n; x++) {
+            c[x] += bias[x];
+        }
+    }
+    switch(act) {
+        case nn_Activation_None: break;
+        case nn_Activation_ReLU: _cten_kernels.relu(c, c, n); break;
+        case nn_Activation_Sigmoid: _cten_kernels.sigmoid(c, c, n); break;
+        case nn_Activation_Tanh: _cten_kernels.tanh(c, c, n); break;
+        case nn_Activation_ELU: _cten_kernels.elu(c, 1.0f, 1.0f, c, n); break;
+        case nn_Activation_SELU:
+            _cten_kernels.elu(c, _CTEN_SELU_ALPHA, _CTEN_SELU_LAMBDA, c, n);
+            break;
+    }
+}
+
+// Floats of packing scratch gemm_block_buffered() needs for A, and for B unless it is prepacked
+static size_t pack_a_size(size_t M, size_t K) {
+    size_t kc_max = K < GEMM_KC ? K : GEMM_KC;
+    size_t mc_max = M < GEMM_MC ? M : GEMM_MC;
+    return (mc_max + GEMM_MR - 1) / GEMM_MR * GEMM_MR * kc_max;
+}
+
+static size_t pack_b_size(size_t N, size_t K) {
+    size_t kc_max = K < GEMM_KC ? K : GEMM_KC;
+    size_t nc_max = N < GEMM_NC ? N : GEMM_NC;
+    return (nc_max + GEMM_NR - 1) / GEMM_NR * GEMM_NR * kc_max;
+}
+
+// One product packed through the caller's scratch: `a_pack` of pack_a_size() floats and, unless
+// B is prepacked in `b_panels`, `b_pack` of pack_b_size() floats
+static void gemm_block_buffered(size_t M,
+                                size_t N,
+                                size_t K,
+                                const float* A,
+                                size_t rs_a,
+                                size_t cs_a,
+                                const float* B,
+                                size_t rs_b,
+                                size_t cs_b,
+                                const float* b_panels,
+                                float* C,
+                                size_t ldc,
+                                bool accumulate,
+                                const float* bias,
+                                nn_Activation act,
+                                float* a_pack,
+                                float* b_pack) {
+    if(M == 0 || N == 0) return;
+    if(K == 0) {
+        for(size_t i = 0; i < M; i++) {
+            if(!accumulate) memset(C + i * ldc, 0, sizeof(float) * N);
+            _cten_bias_act(C + i * ldc, bias, N, act);
+        }
+        return;
+    }
+    bool has_epilogue = bias != NULL || act != nn_Activation_None;
+    float ab[GEMM_MR * GEMM_NR];
+
+    for(size_t j0 = 0; j0 < N; j0 += GEMM_NC) {
+        size_t nc = N - j0 < GEMM_NC ? N - j0 : GEMM_NC;
+        for(size_t k0 = 0; k0 < K; k0 += GEMM_KC) {
+            size_t kc = K - k0 < GEMM_KC ? K - k0 : GEMM_KC;
+            // the first slab overwrites C unless the caller asked to accumulate
+            bool add = accumulate || k0 > 0;
+            // the last slab finishes C, so its tiles get the epilogue while still in L1
+            bool last = k0 + kc == K && has_epilogue;
+            const float* b_block = b_pack;
+            if(b_panels != NULL) {
+                b_block = b_panels + panels_offset(K, j0, k0, nc);
+            } else {
+                pack_b(kc, nc, B + k0 * rs_b + j0 * cs_b, rs_b, cs_b, b_pack);
+            }
+
+            for(size_t i0 = 0; i0 < M; i0 += GEMM_MC) {
+                size_t mc = M - i0 < GEMM_MC ? M - i0 : GEMM_MC;
+                pack_a(mc, kc, A + i0 * rs_a + k0 * cs_a, rs_a, cs_a, a_pack);
+
+                for(size_t j = 0; j < nc; j += GEMM_NR) {
+                    size_t nr = nc - j < GEMM_NR ? nc - j : GEMM_NR;
+                    const float* b_panel = b_block + j * kc;
+                    for(size_t i = 0; i < mc; i += GEMM_MR) {
+                        size_t mr = mc - i < GEMM_MR ? mc - i : GEMM_MR;
+                        micro_kernel(kc, a_pack + i * kc, b_panel, ab);
+
+                        float* c = C + (i0 + i) * ldc + j0 + j;
+                        for(size_t r = 0; r < mr; r++) {
+                            float* c_row = c + r * ldc;
+                            const float* ab_row = ab + r * GEMM_NR;
+                            if(add) {
+                                for(size_t x = 0; x < nr; x++) {
+                                    c_row[x] += ab_row[x];
+                                }
+                            } else {
+                                memcpy(c_row, ab_row, sizeof(float) * nr);
+                            }
+                            if(last) _cten_bias_act(c_row, bias ? bias + j0 + j : NULL, nr, act);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void gemm_block(size_t M,
+                       size_t N,
+                       size_t K,
+                       const float* A,
+                       size_t rs_a,
+                       size_t cs_a,
+                       const float* B,
+                       size_t rs_b,
+                       size_t cs_b,
+                       const float* b_panels,
+                       float* C,
+                       size_t ldc,
+                       bool accumulate,
+                       const float* bias,
+                       nn_Activation act) {
+    // B already packed by _cten_gemm_pack_panels() needs no buffer of its own
+    size_t a_size = pack_a_size(M, K);
+    size_t b_size = b_panels != NULL ? 0 : pack_b_size(N, K);
+    float* a_pack = NULL;
+    if(M > 0 && N > 0 && K > 0) {
+        a_pack = malloc(sizeof(float) * (a_size + b_size));
+        cten_assert(a_pack != NULL, "gemm: out of memory for packing buffers");
+    }
+    gemm_block_buffered(M,
+                        N,
+                        K,
+                        A,
+                        rs_a,
+                        cs_a,
+                        B,
+                        rs_b,
+                        cs_b,
+                        b_panels,
+                        C,
+                        ldc,
+                        accumulate,
+                        bias,
+                        act,
+                        a_pack,
+                        a_pack != NULL ? a_pack + a_size : NULL);
+    free(a_pack);
+}
+
+/* Large products split their rows across the thread pool in whole micro-tiles. Each thread packs
+ * its own copy of the B blocks (unless B is prepacked), which costs K * N against the
+ * rows * N * K of work it saves, and computes its rows of C exactly as a single thread would. */
+
+// Multiply-adds per thread below which a product stays on one thread
+#define GEMM_PARALLEL_WORK (1 << 20)
+
+typedef struct GemmTask {
+    size_t M, N, K;
+    const float* A;
+    size_t rs_a, cs_a;
+    const float* B;
+    size_t rs_b, cs_b;
+    const float* b_panels;
+    float* C;
+    size_t ldc;
+    bool accumulate;
+    const float* bias;
+    nn_Activation act;
+} GemmTask;
+
+// Rows [begin * GEMM_MR, end * GEMM_MR) of C
+static void gemm_rows(void* ctx, size_t begin, size_t end) {
+    const GemmTask* t = ctx;
+    size_t i0 = begin * GEMM_MR;
+    size_t i1 = end * GEMM_MR < t->M ? end * GEMM_MR : t->M;
+    gemm_block(i1 - i0,
+               t->N,
+               t->K,
+               t->A + i0 * t->rs_a,
+               t->rs_a,
+               t->cs_a,
+               t->B,
+               t->rs_b,
+               t->cs_b,
+               t->b_panels,
+               t->C + i0 * t->ldc,
+               t->ldc,
+               t->accumulate,
+               t->bias,
+               t->act);
+}
+
+static void gemm_packed(size_t M,
+                        size_t N,
+                        size_t K,
+                        const float* A,
+                        size_t rs_a,
+                        size_t cs_a,
+                        const float* B,
+                        size_t rs_b,
+                        size_t cs_b,
+                        const float* b_panels,
+                        float* C,
+                        size_t ldc,
+                        bool accumulate,
+                        const float* bias,
+                        nn_Activation act) {
+    GemmTask t = {M, N, K, A, rs_a, cs_a, B, rs_b, cs_b, b_panels, C, ldc, accumulate, bias, act};
+    size_t tile_work = GEMM_MR * N * (K > 0 ? K : 1);
+    size_t grain = tile_work >= GEMM_PARALLEL_WORK ? 1 : GEMM_PARALLEL_WORK / tile_work;
+    _cten_parallel_for((M + GEMM_MR - 1) / GEMM_MR, grain, gemm_rows, &t);
+}
+
+void _cten_gemm(size_t M,
+                size_t N,
+                size_t K,
+                const float* A,
+                size_t rs_a,
+                size_t cs_a,
+                const float* B,
+                size_t rs_b,
+                size_t cs_b,
+                float* C,
+                size_t ldc,
+                bool accumulate) {
+    gemm_packed(M,
+                N,
+                K,
+                A,
+                rs_a,
+                cs_a,
+                B,
+                rs_b,
+                cs_b,
+                NULL,
+                C,
+                ldc,
+                accumulate,
+                NULL,
+                nn_Activation_None);
+}
+
+/* Products too small to amortize packing. Batch-1 inference turns every layer into a row-vector
+ * times matrix product (M = 1) and a layer over a scalar feature into an outer product (K = 1),
+ * and tiny layers have every dimension small; each shape gets its own loop instead of the general
+ * one. */
+
+// Size-optimized builds (-Os, typical for microcontrollers) leave out the 64 unrolled kernels below
+// and run tiny products through the row-vector path instead
+#if !defined(__OPTIMIZE_SIZE__)
+#define GEMM_TINY 4
+
+// Fully unrolled kernel for one M x N x K size triple of contiguous row-major operands, with the
+// bounds known at compile time and the whole tile of C held in registers
+#define GEMM_TINY_KERNEL(m, n, k)                                                                  \
+    static void gemm_tiny_##m##x##n##x##k(                                                         \
+        const float* A, size_t lda, const float* B, size_t ldb, float* C, size_t ldc, bool acc) { \
+        float c[m][n] = {{0}};                                                                     \
+        for(int p = 0; p < k; p++) {                                                               \
+            for(int i = 0; i < m; i++) {                                                           \
+                for(int j = 0; j < n; j++) {                                                       \
+                    c[i][j] += A[i * lda + p] * B[p * ldb + j];                                    \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        for(int i = 0; i < m; i++) {                                                               \
+            for(int j = 0; j < n; j++) {                                                           \
+                C[i * ldc + j] = acc ? C[i * ldc + j] + c[i][j] : c[i][j];                         \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+// Expands X(m, n, k) for every size triple up to GEMM_TINY
+#define GEMM_TINY_FOR_K(X, m, n) X(m, n, 1) X(m, n, 2) X(m, n, 3) X(m, n, 4)
+#define GEMM_TINY_FOR_N(X, m)                                                                      \
+    GEMM_TINY_FOR_K(X, m, 1)                                                                       \
+    GEMM_TINY_FOR_K(X, m, 2)                                                                       \
+    GEMM_TINY_FOR_K(X, m, 3)                                                                       \
+    GEMM_TINY_FOR_K(X, m, 4)
+#define GEMM_TINY_FOR_ALL(X)                                                                       \
+    GEMM_TINY_FOR_N(X, 1) GEMM_TINY_FOR_N(X, 2) GEMM_TINY_FOR_N(X, 3) GEMM_TINY_FOR_N(X, 4)
+
+GEMM_TINY_FOR_ALL(GEMM_TINY_KERNEL)
+
+typedef void (*gemm_tiny_fn)(const float* A,
+                             size_t lda,
+                             const float* B,
+                             size_t ldb,
+                             float* C,
+                             size_t ldc,
+                             bool accumulate);
+
+#define GEMM_TINY_ENTRY(m, n, k) [m - 1][n - 1][k - 1] = gemm_tiny_##m##x##n##x##k,
+static const gemm_tiny_fn gemm_tiny[GEMM_TINY][GEMM_TINY][GEMM_TINY] = {
+    GEMM_TINY_FOR_ALL(GEMM_TINY_ENTRY)};
+#endif
+
+// K = 1: C[i,j] (+)= A[i] * B[j]
+static void gemm_outer(size_t M,
+                       size_t N,
+                       const float* A,
+                       size_t rs_a,
+                       const float* B,
+                       size_t cs_b,
+                       float* C,
+                       size_t ldc,
+                       bool accumulate) {
+    for(size_t i = 0; i < M; i++) {
+        float a_i = A[i * rs_a];
+        float* c_row = C + i * ldc;
+        if(cs_b == 1 && accumulate) {
+            for(size_t j = 0; j < N; j++) {
+                c_row[j] += a_i * B[j];
+            }
+        } else if(cs_b == 1) {
+            for(size_t j = 0; j < N; j++) {
+                c_row[j] = a_i * B[j];
+            }
+        } else {
+            for(size_t j = 0; j < N; j++) {
+                c_row[j] = (accumulate ? c_row[j] : 0.0f) + a_i * B[j * cs_b];
+            }
+        }
+    }
+}
+
+// M = 1: c[N] (+)= a[K] @ B[K,N]
+static void gemm_gemv(size_t N,
+                      size_t K,
+                      const float* a,
+                      size_t cs_a,
+                      const float* B,
+                      size_t rs_b,
+                      size_t cs_b,
+                      float* c,
+                      bool accumulate) {
+    if(cs_b == 1) {
+        // rows of B are contiguous: four scaled rows are summed per pass over c
+        if(!accumulate) memset(c, 0, sizeof(float) * N);
+        size_t k = 0;
+        for(; k + 4 <= K; k += 4) {
+            float a0 = a[k * cs_a], a1 = a[(k + 1) * cs_a];
+            float a2 = a[(k + 2) * cs_a], a3 = a[(k + 3) * cs_a];
+            const float* b0 = B + k * rs_b;
+            const float* b1 = b0 + rs_b;
+            const float* b2 = b1 + rs_b;
+            const float* b3 = b2 + rs_b;
+            for(size_t j = 0; j < N; j++) {
+                c[j] += a0 * b0[j] + a1 * b1[j] + a2 * b2[j] + a3 * b3[j];
+            }
+        }
+        for(; k < K; k++) {
+            float a_k = a[k * cs_a];
+            const float* b_row = B + k * rs_b;
+            for(size_t j = 0; j < N; j++) {
+                c[j] += a_k * b_row[j];
+            }
+        }
+        return;
+    }
+    // B is transposed, so its columns are contiguous: one dot product per output, with four
+    // partial sums to break the dependency on a single accumulator
+    for(size_t j = 0; j < N; j++) {
+        const float* b_col = B + j * cs_b;
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        size_t k = 0;
+        for(; k + 4 <= K; k += 4) {
+            s0 += a[k * cs_a] * b_col[k * rs_b];
+            s1 += a[(k + 1) * cs_a] * b_col[(k + 1) * rs_b];
+            s2 += a[(k + 2) * cs_a] * b_col[(k + 2) * rs_b];
+            s3 += a[(k + 3) * cs_a] * b_col[(k + 3) * rs_b];
+        }
+        for(; k < K; k++) {
+            s0 += a[k * cs_a] * b_col[k * rs_b];
+        }
+        float dot = (s0 + s1) + (s2 + s3);
+        c[j] = accumulate ? c[j] + dot : dot;
+    }
+}
+
+// Picks the specialization for a small product, falling back to plain loops
+static void gemm_small(size_t M,
+                       size_t N,
+                       size_t K,
+                       const float* A,
+                       size_t rs_a,
+                       size_t cs_a,
+                       const float* B,
+                       size_t rs_b,
+                       size_t cs_b,
+                       float* C,
+                       size_t ldc,
+                       bool accumulate) {
+    if(M == 0 || N == 0) return;
+    if(K == 0) {
+        for(size_t i = 0; i < M && !accumulate; i++) {
+            memset(C + i * ldc, 0, sizeof(float) * N);
+        }
+        return;
+    }
+#ifdef GEMM_TINY
+    if(M <= GEMM_TINY && N <= GEMM_TINY && K <= GEMM_TINY && cs_a == 1 && cs_b == 1) {
+        gemm_tiny[M - 1][N - 1][K - 1](A, rs_a, B, rs_b, C, ldc, accumulate);
+        return;
+    }
+#endif
+    if(K == 1) {
+        gemm_outer(M, N, A, rs_a, B, cs_b, C, ldc, accumulate);
+        return;
+    }
+    for(size_t i = 0; i < M; i++) {
+        // each row of C is its own row-vector product
+        gemm_gemv(N, K, A + i * rs_a, cs_a, B, rs_b, cs_b, C + i * ldc, accumulate);
+    }
+}
+
+void _cten_sgemm(bool trans_a,
+                 bool trans_b,
+                 size_t M,
+                 size_t N,
+                 size_t K,
+                 const float* A,
+                 size_t lda,
+                 const float* B,
+                 size_t ldb,
+                 float* C,
+                 size_t ldc,
+                 bool accumulate) {
+    size_t rs_a = trans_a ? 1 : lda, cs_a = trans_a ? lda : 1;
+    size_t rs_b = trans_b ? 1 : ldb, cs_b = trans_b ? ldb : 1;
+    if(M >= GEMM_MIN_ROWS && K >= GEMM_MIN_DEPTH) {
+        _cten_gemm(M, N, K, A, rs_a, cs_a, B, rs_b, cs_b, C, ldc, accumulate);
+    } else {
+        gemm_small(M, N, K, A, rs_a, cs_a, B, rs_b, cs_b, C, ldc, accumulate);
+    }
+}
+
+/* Batches of same-shaped products, e.g. one per attention head. Each is usually too small to
+ * split its rows across threads, so whole products are split across the pool instead, and every
+ * part packs through one scratch allocation for all its products. A product is computed exactly as
+ * _cten_sgemm() computes it alone. */
+
+typedef struct GemmBatchTask {
+    size_t M, N, K;
+    const float* const* A;
+    size_t rs_a, cs_a;
+    const float* const* B;
+    size_t rs_b, cs_b;
+    float* const* C;
+    size_t ldc;
+    bool accumulate;
+} GemmBatchTask;
+
+// Products [begin, end) of the batch
+static void gemm_batches(void* ctx, size_t begin, size_t end) {
+    const GemmBatchTask* t = ctx;
+    if(t->M < GEMM_MIN_ROWS || t->K < GEMM_MIN_DEPTH) {
+        for(size_t b = begin; b < end; b++) {
+            gemm_small(t->M,
+                       t->N,
+                       t->K,
+                       t->A[b],
+                       t->rs_a,
+                       t->cs_a,
+                       t->B[b],
+                       t->rs_b,
+                       t->cs_b,
+                       t->C[b],
+                       t->ldc,
+                       t->accumulate);
+        }
+        return;
+    }
+    size_t a_size = pack_a_size(t->M, t->K);
+    float* a_pack = malloc(sizeof(float) * (a_size + pack_b_size(t->N, t->K)));
+    cten_assert(a_pack != NULL, "gemm: out of memory for packing buffers");
+    for(size_t b = begin; b < end; b++) {
+        gemm_block_buffered(t->M,
+                            t->N,
+                            t->K,
+                            t->A[b],
+                            t->rs_a,
+                            t->cs_a,
+                            t->B[b],
+                            t->rs_b,
+                            t->cs_b,
+                            NULL,
+                            t->C[b],
+                            t->ldc,
+                            t->accumulate,
+                            NULL,
+                            nn_Activation_None,
+                            a_pack,
+                            a_pack + a_size);
+    }
+    free(a_pack);
+}
+
+void _cten_sgemm_batched(bool trans_a,
+                         bool trans_b,
+                         size_t count,
+                         size_t M,
+                         size_t N,
+                         size_t K,
+                         const float* const* A,
+                         size_t lda,
+                         const float* const* B,
+                         size_t ldb,
+                         float* const* C,
+                         size_t ldc,
+                         bool accumulate,
+                         bool c_distinct) {
+    if(count == 0 || M == 0 || N == 0) return;
+    size_t work = M * N * (K > 0 ? K : 1);
+    if(c_distinct && count < (size_t)cten_num_threads() && work >= GEMM_PARALLEL_WORK) {
+        // too few products to occupy the pool, but each big enough to split by rows
+        for(size_t b = 0; b < count; b++) {
+            _cten_sgemm(trans_a, trans_b, M, N, K, A[b], lda, B[b], ldb, C[b], ldc, accumulate);
+        }
+        return;
+    }
+    GemmBatchTask t = {M,
+                       N,
+                       K,
+                       A,
+                       trans_a ? 1 : lda,
+                       trans_a ? lda : 1,
+                       B,
+                       trans_b ? 1 : ldb,
+                       trans_b ? ldb : 1,
+                       C,
+                       ldc,
+                       accumulate};
+    // products that accumulate into a shared C stay in order on one thread
+    size_t grain = !c_distinct ? count : work >= GEMM_PARALLEL_WORK ? 1 : GEMM_PARALLEL_WORK / work;
+    _cten_parallel_for(count, grain, gemm_batches, &t);
+}
+
+void _cten_sgemm_bias_act(size_t M,
+                          size_t N,
+                          size_t K,
+                          const float* A,
+                          size_t lda,
+                          const float* B,
+                          size_t ldb,
+                          float* C,
+                          size_t ldc,
+                          const float* bias,
+                          nn_Activation act) {
+    _cten_sgemm_prepacked(false, M, N, K, A, lda, B, ldb, NULL, C, ldc, bias, act);
+}
+
+/* Prepacked B. A weight that many products read unchanged (a frozen layer at inference) can keep
+ * its panels from one call to the next. The layout is what gemm_packed builds block by block,
+ * laid out for the whole matrix. */
+
+size_t _cten_gemm_panels_size(size_t K, size_t N) {
+    return K * ((N + GEMM_NR - 1) / GEMM_NR * GEMM_NR);
+}
+
+void _cten_gemm_pack_panels(size_t K,
+                            size_t N,
+                            const float* B,
+                            size_t rs_b,
+                            size_t cs_b,
+                            float* panels) {
+    for(size_t j0 = 0; j0 < N; j0 += GEMM_NC) {
+        size_t nc = N - j0 < GEMM_NC ? N - j0 : GEMM_NC;
+        for(size_t k0 = 0; k0 < K; k0 += GEMM_KC) {
+            size_t kc = K - k0 < GEMM_KC ? K - k0 : GEMM_KC;
+            pack_b(kc,
+                   nc,
+                   B + k0 * rs_b + j0 * cs_b,
+                   rs_b,
+                   cs_b,
+                   panels + panels_offset(K, j0, k0, nc));
+        }
+    }
+}
+
+void _cten_sgemm_prepacked(bool trans_b,
+                           size_t M,
+                           size_t N,
+                           size_t K,
+                           const float* A,
+                           size_t lda,
+                           const float* B,
+                           size_t ldb,
+                           const float* b_panels,
+                           float* C,
+                           size_t ldc,
+                           const float* bias,
+                           nn_Activation act) {
+    size_t rs_b = trans_b ? 1 : ldb, cs_b = trans_b ? ldb : 1;
+    if(M >= GEMM_MIN_ROWS && K >= GEMM_MIN_DEPTH) {
+        gemm_packed(M, N, K, A, lda, 1, B, rs_b, cs_b, b_panels, C, ldc, false, bias, act);
+        return;
+    }
+    // small products never pack, so they read B itself whether or not panels exist
+    gemm_small(M, N, K, A, lda, 1, B, rs_b, cs_b, C, ldc, false);
+    for(size_t i = 0; i < M; i++) {
+        _cten_bias_act(C + i * ldc, bias, N, act);
+    }
+}
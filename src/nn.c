@@ -5,33 +5,174 @@
 #include <math.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <stdio.h>
 
-static float elu_alpha_value = 1.0f;
-static float huber_delta_value = 1.0f;
-
 Tensor nn_linear(Tensor input, Tensor weight, Tensor bias) {
+    if(weight.ndim == 2 && bias.numel == (size_t)weight.shape[1]) {
+        return nn_linear_act(input, weight, bias, nn_Activation_None);
+    }
     Tensor tmp = Tensor_matmul(input, weight);
     tmp = Tensor_add(tmp, bias);
     return tmp;
 }
 
+// dz = g * act'(z), with the derivative written in terms of the activation's output y (which is
+// positive exactly where z is)
+static void act_backward(nn_Activation act, const float* g, const float* y, float* dz, size_t n) {
+    switch(act) {
+        case nn_Activation_None: memcpy(dz, g, sizeof(float) * n); return;
+        case nn_Activation_ReLU:
+            _cten_parallel_map(_cten_kernels.relu_grad, y, dz, n, _CTEN_GRAIN);
+            break;
+        case nn_Activation_Sigmoid:
+            _cten_parallel_map(_cten_kernels.sigmoid_grad, y, dz, n, _CTEN_GRAIN);
+            break;
+        case nn_Activation_Tanh:
+            _cten_parallel_map(_cten_kernels.tanh_grad, y, dz, n, _CTEN_GRAIN);
+            break;
+        case nn_Activation_ELU: _cten_kernels.elu_grad(y, y, 1.0f, 1.0f, dz, n); break;
+        case nn_Activation_SELU:
+            _cten_kernels.elu_grad(y,
+                                   y,
+                                   _CTEN_SELU_LAMBDA,
+                                   _CTEN_SELU_LAMBDA * _CTEN_SELU_ALPHA,
+                                   dz,
+                                   n);
+            break;
+    }
+    _cten_parallel_zip(_cten_kernels.mul, g, dz, dz, n, _CTEN_GRAIN);
+}
+
+// dZ = G * act'(Z) for the node's current upstream gradient G. It is kept in saved[0], with the G
+// it came from in saved[1], so whichever input's gradient comes first computes it and the others
+// reuse it until a later Tensor_backward() pass brings a new G.
+static const float* linear_act_dz(Tensor self) {
+    GradNode* node = self.node;
+    nn_Activation act = (nn_Activation)node->params[0];
+    if(act == nn_Activation_None) return node->grad.data->flex;
+    if(node->saved[1].data != node->grad.data) {
+        node->saved[0] = Tensor_new(self.shape, false);
+        act_backward(act,
+                     node->grad.data->flex,
+                     self.data->flex,
+                     node->saved[0].data->flex,
+                     self.numel);
+        node->saved[1] = node->grad;
+    }
+    return node->saved[0].data->flex;
+}
+
+// Full chain rule against the upstream gradient (like Matmul): dX = dZ @ W^T, dW = X^T @ dZ and
+// db sums dZ over the rows.
+static Tensor GradFn_linear_act(Tensor self, int i) {
+    const float* dz = linear_act_dz(self);
+    size_t in_features = self.node->inputs[1].shape[0];
+    size_t out_features = self.node->inputs[1].shape[1];
+    size_t rows = self.numel / out_features;
+
+    if(i == 2) {
+        Tensor res = Tensor_zeros(self.node->inputs[2].shape, false);
+        for(size_t r = 0; r < rows; r++) {
+            _cten_kernels.add(res.data->flex, dz + r * out_features, res.data->flex, out_features);
+        }
+        return res;
+    }
+    if(i == 0) {
+        Tensor w = _cten_as_f32(self.node->inputs[1]);
+        Tensor res = Tensor_new(self.node->inputs[0].shape, false);
+        _cten_sgemm_prepacked(true,
+                              rows,
+                              in_features,
+                              out_features,
+                              dz,
+                              out_features,
+                              w.data->flex,
+                              out_features,
+                              _cten_weight_panels(self.node->inputs[1], true),
+                              res.data->flex,
+                              in_features,
+                              NULL,
+                              nn_Activation_None);
+        return res;
+    }
+    Tensor x = _cten_as_f32(self.node->inputs[0]);
+    Tensor res = Tensor_new(self.node->inputs[1].shape, false);
+    _cten_sgemm(true,
+                false,
+                in_features,
+                out_features,
+                rows,
+                x.data->flex,
+                in_features,
+                dz,
+                out_features,
+                res.data->flex,
+                out_features,
+                false);
+    return res;
+}
+
+Tensor nn_linear_act(Tensor input, Tensor weight, Tensor bias, nn_Activation act) {
+    cten_assert(input.ndim >= 1 && weight.ndim == 2,
+                "nn_linear_act: expected input [..., in] and weight [in, out]");
+    cten_assert(input.shape[input.ndim - 1] == weight.shape[0],
+                "nn_linear_act: input features %d do not match weight rows %d",
+                input.shape[input.ndim - 1],
+                weight.shape[0]);
+    size_t in_features = weight.shape[0];
+    size_t out_features = weight.shape[1];
+    cten_assert(bias.numel == out_features,
+                "nn_linear_act: bias has %zu elements, expected %zu",
+                bias.numel,
+                out_features);
+
+    Tensor b = _cten_as_f32(bias);
+    bool requires_grad =
+        !cten_is_eval() && (input.node != NULL || weight.node != NULL || bias.node != NULL);
+    TensorShape res_shape;
+    memcpy(res_shape, input.shape, sizeof(TensorShape));
+    res_shape[input.ndim - 1] = out_features;
+    Tensor res = Tensor_new(res_shape, requires_grad);
+    // reduced-precision inputs and weights are widened only when Tensor_matmul would widen them
+    _cten_matmul_shared(input,
+                        weight,
+                        res,
+                        input.numel / in_features,
+                        in_features,
+                        out_features,
+                        b.data->flex,
+                        act);
+
+    if(requires_grad) {
+        res.node->grad_fn = GradFn_linear_act;
+        res.node->inputs[0] = input;
+        res.node->inputs[1] = weight;
+        res.node->inputs[2] = bias;
+        res.node->n_inputs = 3;
+        res.node->params[0] = act;
+        res.node->name = "LinearAct";
+    }
+    return res;
+}
+
 static Tensor GradFn_relu(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int i = 0; i < input.data->numel; i++) {
-        res.data->flex[i] = input.data->flex[i] > 0 ? 1.0f : 0.0f;
-    }
+    _cten_parallel_map(_cten_kernels.relu_grad,
+                       input.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN);
     return res;
 }
 
 Tensor nn_relu(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
-    Tensor res = Tensor_zeros(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = fmaxf(0, self.data->flex[i]);
-    }
+    Tensor res = Tensor_new(self.shape, requires_grad);
+    _cten_parallel_map(_cten_kernels.relu, self.data->flex, res.data->flex, res.numel, _CTEN_GRAIN);
 
     if(requires_grad) {
         res.node->grad_fn = GradFn_relu;
@@ -45,18 +186,23 @@ Tensor nn_relu(Tensor self) {
 static Tensor GradFn_log(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int j = 0; j < input.data->numel; j++) {
-        res.data->flex[j] = 1.0f / input.data->flex[j];
-    }
+    _cten_parallel_map(_cten_kernels.reciprocal,
+                       input.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN);
     return res;
 }
 
 Tensor nn_log(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = logf(self.data->flex[i]);
-    }
+    _cten_parallel_map(_cten_kernels.log,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN_MATH);
     if(requires_grad) {
         res.node->grad_fn = GradFn_log;
         res.node->inputs[0] = self;
@@ -66,14 +212,17 @@ Tensor nn_log(Tensor self) {
     return res;
 }
 
-static Tensor GradFn_exp(Tensor self, int i) { return self; }
+static Tensor GradFn_exp(Tensor self, int i) { return Tensor_detach(self); }
 
 Tensor nn_exp(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = expf(self.data->flex[i]);
-    }
+    _cten_parallel_map(_cten_kernels.exp,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN_MATH);
     if(requires_grad) {
         res.node->grad_fn = GradFn_exp;
         res.node->inputs[0] = self;
@@ -86,16 +235,17 @@ Tensor nn_exp(Tensor self) {
 static Tensor GradFn_sin(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int j = 0; j < input.data->numel; j++) {
+    for(size_t j = 0; j < input.data->numel; j++) {
         res.data->flex[j] = cosf(input.data->flex[j]);
     }
     return res;
 }
 
 Tensor nn_sin(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
+    for(size_t i = 0; i < self.data->numel; i++) {
         res.data->flex[i] = sinf(self.data->flex[i]);
     }
     if(requires_grad) {
@@ -110,16 +260,17 @@ Tensor nn_sin(Tensor self) {
 static Tensor GradFn_cos(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int j = 0; j < input.data->numel; j++) {
+    for(size_t j = 0; j < input.data->numel; j++) {
         res.data->flex[j] = -sinf(input.data->flex[j]);
     }
     return res;
 }
 
 Tensor nn_cos(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
+    for(size_t i = 0; i < self.data->numel; i++) {
         res.data->flex[i] = cosf(self.data->flex[i]);
     }
     if(requires_grad) {
@@ -134,7 +285,7 @@ Tensor nn_cos(Tensor self) {
 static Tensor GradFn_tan(Tensor self, int i) {
     // d/dx(tan(x)) = 1 + tan^2(x)
     Tensor res = Tensor_new(self.shape, false);
-    for(int j = 0; j < self.data->numel; j++) {
+    for(size_t j = 0; j < self.data->numel; j++) {
         float y = self.data->flex[j];
         res.data->flex[j] = 1.0f + y * y;
     }
@@ -142,9 +293,10 @@ static Tensor GradFn_tan(Tensor self, int i) {
 }
 
 Tensor nn_tan(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
+    for(size_t i = 0; i < self.data->numel; i++) {
         res.data->flex[i] = tanf(self.data->flex[i]);
     }
     if(requires_grad) {
@@ -159,19 +311,23 @@ Tensor nn_tan(Tensor self) {
 static Tensor GradFn_sigmoid(Tensor self, int i) {
     // d/dx sigmoid(x) = sigmoid(x) * (1 - sigmoid(x))
     Tensor res = Tensor_new(self.shape, false);
-    for(int j = 0; j < self.data->numel; j++) {
-        float y = self.data->flex[j];
-        res.data->flex[j] = y * (1.0f - y);
-    }
+    _cten_parallel_map(_cten_kernels.sigmoid_grad,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN_MATH);
     return res;
 }
 
 Tensor nn_sigmoid(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = 1.0f / (1.0f + expf(-self.data->flex[i]));
-    }
+    _cten_parallel_map(_cten_kernels.sigmoid,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN_MATH);
     if(requires_grad) {
         res.node->grad_fn = GradFn_sigmoid;
         res.node->inputs[0] = self;
@@ -184,19 +340,23 @@ Tensor nn_sigmoid(Tensor self) {
 static Tensor GradFn_tanh(Tensor self, int i) {
     // d/dx tanh(x) = 1 - tanh^2(x)
     Tensor res = Tensor_new(self.shape, false);
-    for(int j = 0; j < self.data->numel; j++) {
-        float y = self.data->flex[j];
-        res.data->flex[j] = 1.0f - y * y;
-    }
+    _cten_parallel_map(_cten_kernels.tanh_grad,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN_MATH);
     return res;
 }
 
 Tensor nn_tanh(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = tanhf(self.data->flex[i]);
-    }
+    _cten_parallel_map(_cten_kernels.tanh,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN_MATH);
     if(requires_grad) {
         res.node->grad_fn = GradFn_tanh;
         res.node->inputs[0] = self;
@@ -207,38 +367,30 @@ Tensor nn_tanh(Tensor self) {
 }
 
 static Tensor GradFn_elu(Tensor self, int i) {
-    float alpha = elu_alpha_value;
+    float alpha = _cten_param_f32(self.node, 0);
     Tensor input = self.node->inputs[0];
     Tensor grad = Tensor_new(input.shape, false);
-    for(int j = 0; j < input.data->numel; j++) {
-        float x = input.data->flex[j];
-        if(x > 0) {
-            grad.data->flex[j] = 1.0f;
-        } else {
-            // derivative is alpha * e^x = alpha * (e^x - 1) + alpha = y + alpha
-            grad.data->flex[j] = self.data->flex[j] + alpha;
-        }
-    }
+    // derivative is 1, or alpha * e^x = alpha * (e^x - 1) + alpha = y + alpha
+    _cten_kernels.elu_grad(input.data->flex,
+                           self.data->flex,
+                           1.0f,
+                           alpha,
+                           grad.data->flex,
+                           grad.numel);
     return grad;
 }
 
 Tensor nn_elu(Tensor self, float alpha) {
-    elu_alpha_value = alpha;
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        float x = self.data->flex[i];
-        if(x > 0) {
-            res.data->flex[i] = x;
-        } else {
-            res.data->flex[i] = alpha * (expf(x) - 1.0f);
-        }
-    }
+    _cten_kernels.elu(self.data->flex, alpha, 1.0f, res.data->flex, res.numel);
     if(requires_grad) {
         res.node->grad_fn = GradFn_elu;
         res.node->inputs[0] = self;
         res.node->n_inputs = 1;
         res.node->name = "Elu";
+        _cten_set_param_f32(res.node, 0, alpha);
     }
     return res;
 }
@@ -246,33 +398,27 @@ Tensor nn_elu(Tensor self, float alpha) {
 static Tensor GradFn_selu(Tensor self, int i) {
     Tensor input = self.node->inputs[0];
     Tensor grad = Tensor_new(input.shape, false);
-    const float alpha = 1.67326324f;
-    const float lambda = 1.05070098f;
-    for(int j = 0; j < input.data->numel; j++) {
-        float x = input.data->flex[j];
-        if(x > 0) {
-            grad.data->flex[j] = lambda;
-        } else {
-            // derivative is lambda * alpha * e^x = y + lambda*alpha
-            grad.data->flex[j] = self.data->flex[j] + lambda * alpha;
-        }
-    }
+    const float alpha = _CTEN_SELU_ALPHA;
+    const float lambda = _CTEN_SELU_LAMBDA;
+    // derivative is lambda, or lambda * alpha * e^x = y + lambda*alpha
+    _cten_kernels.elu_grad(input.data->flex,
+                           self.data->flex,
+                           lambda,
+                           lambda * alpha,
+                           grad.data->flex,
+                           grad.numel);
     return grad;
 }
 
 Tensor nn_selu(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    const float alpha = 1.67326324f;
-    const float lambda = 1.05070098f;
-    for(int i = 0; i < self.data->numel; i++) {
-        float x = self.data->flex[i];
-        if(x > 0) {
-            res.data->flex[i] = lambda * x;
-        } else {
-            res.data->flex[i] = lambda * alpha * (expf(x) - 1);
-        }
-    }
+    _cten_kernels.elu(self.data->flex,
+                      _CTEN_SELU_ALPHA,
+                      _CTEN_SELU_LAMBDA,
+                      res.data->flex,
+                      res.numel);
     if(requires_grad) {
         res.node->grad_fn = GradFn_selu;
         res.node->inputs[0] = self;
@@ -288,47 +434,195 @@ Tensor Glorot_init(TensorShape shape, bool requires_grad) {
     int fan_out = shape[1];
     float scale = sqrtf(6.0f / (fan_in + fan_out));
 
-    for(int i = 0; i < res.data->numel; i++) {
-        float r = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+    for(size_t i = 0; i < res.data->numel; i++) {
+        float r = _cten_rand_uniform() * 2.0f - 1.0f;
         res.data->flex[i] = r * scale;
     }
     return res;
 }
 
+/* Softmax along the last dimension works on contiguous rows with the vector kernels. Rows are
+ * taken in chunks of about SOFTMAX_CHUNK elements: each row is shifted by its maximum, exp runs
+ * once over the whole chunk (a long span even for a few classes), and each row is scaled by
+ * 1 / sum while the chunk is still in cache. Taking the maximum first costs a cheap read pass and
+ * keeps exp to once per element, which an online max/sum recurrence would not. */
+
+#define SOFTMAX_CHUNK 4096
+// rows shorter than this are cheaper in plain loops than in kernel calls
+#define SOFTMAX_SHORT_ROW 16
+
+static float row_max(const float* x, size_t n) {
+    if(n >= SOFTMAX_SHORT_ROW) return _cten_kernels.reduce_max(x, n);
+    float max_val = -INFINITY;
+    for(size_t k = 0; k < n; k++) {
+        max_val = fmaxf(max_val, x[k]);
+    }
+    return max_val;
+}
+
+static float row_sum(const float* x, size_t n) {
+    if(n >= SOFTMAX_SHORT_ROW) return _cten_kernels.reduce_sum(x, n);
+    float sum = 0.0f;
+    for(size_t k = 0; k < n; k++) {
+        sum += x[k];
+    }
+    return sum;
+}
+
+static size_t softmax_chunk_rows(size_t n) { return n >= SOFTMAX_CHUNK ? 1 : SOFTMAX_CHUNK / n; }
+
+// Operands of the row loops below. Each loop handles rows [begin, end) of n elements, so rows
+// split across the thread pool through softmax_parallel().
+typedef struct SoftmaxRows {
+    size_t n;
+    const float* x;  // input rows, or the forward output in backward
+    const float* g;  // upstream gradient rows, in backward
+    float* y;        // output rows
+    float* lse;      // one log-sum-exp per row
+    Tensor labels;   // targets of the cross-entropy backward
+    float upstream;  // its scalar upstream gradient
+} SoftmaxRows;
+
+static void softmax_parallel(_cten_RangeFn fn, SoftmaxRows* t, size_t rows) {
+    _cten_parallel_for(rows, t->n >= _CTEN_GRAIN_MATH ? 1 : _CTEN_GRAIN_MATH / t->n, fn, t);
+}
+
+static void softmax_rows(void* ctx, size_t begin, size_t end) {
+    const SoftmaxRows* t = ctx;
+    size_t n = t->n, chunk_rows = softmax_chunk_rows(n);
+    for(size_t r0 = begin; r0 < end; r0 += chunk_rows) {
+        size_t m = end - r0 < chunk_rows ? end - r0 : chunk_rows;
+        const float* xc = t->x + r0 * n;
+        float* yc = t->y + r0 * n;
+        for(size_t r = 0; r < m; r++) {
+            const float* xr = xc + r * n;
+            float max_val = row_max(xr, n);
+            for(size_t k = 0; k < n; k++) {
+                yc[r * n + k] = xr[k] - max_val;
+            }
+        }
+        _cten_kernels.exp(yc, yc, m * n);
+        for(size_t r = 0; r < m; r++) {
+            float* yr = yc + r * n;
+            if(n >= SOFTMAX_SHORT_ROW) {
+                _cten_kernels.scale(yr, 1.0f / row_sum(yr, n), yr, n);
+                continue;
+            }
+            float sum = row_sum(yr, n);
+            for(size_t k = 0; k < n; k++) {
+                yr[k] /= sum;
+            }
+        }
+    }
+}
+
+// lse[r] = max_r + log(sum_k exp(x[r, k] - max_r)), staging the exponentials one chunk at a time
+static void logsumexp_rows(void* ctx, size_t begin, size_t end) {
+    const SoftmaxRows* t = ctx;
+    size_t n = t->n, chunk_rows = softmax_chunk_rows(n);
+    if(chunk_rows > end - begin) chunk_rows = end - begin;
+    float* buf = malloc(sizeof(float) * chunk_rows * n);
+    cten_assert(buf != NULL, "nn_softmax_crossentropy: out of memory");
+    for(size_t r0 = begin; r0 < end; r0 += chunk_rows) {
+        size_t m = end - r0 < chunk_rows ? end - r0 : chunk_rows;
+        const float* xc = t->x + r0 * n;
+        for(size_t r = 0; r < m; r++) {
+            const float* xr = xc + r * n;
+            float max_val = row_max(xr, n);
+            for(size_t k = 0; k < n; k++) {
+                buf[r * n + k] = xr[k] - max_val;
+            }
+            t->lse[r0 + r] = max_val;
+        }
+        _cten_kernels.exp(buf, buf, m * n);
+        for(size_t r = 0; r < m; r++) {
+            t->lse[r0 + r] += _cten_kernels.scalar_log(row_sum(buf + r * n, n));
+        }
+    }
+    free(buf);
+}
+
+// y = x - lse row by row: the shifted row goes straight to y and only its exponentials are staged
+static void log_softmax_rows(void* ctx, size_t begin, size_t end) {
+    const SoftmaxRows* t = ctx;
+    size_t n = t->n, chunk_rows = softmax_chunk_rows(n);
+    if(chunk_rows > end - begin) chunk_rows = end - begin;
+    float* buf = malloc(sizeof(float) * chunk_rows * n);
+    cten_assert(buf != NULL, "nn_log_softmax: out of memory");
+    for(size_t r0 = begin; r0 < end; r0 += chunk_rows) {
+        size_t m = end - r0 < chunk_rows ? end - r0 : chunk_rows;
+        const float* xc = t->x + r0 * n;
+        float* yc = t->y + r0 * n;
+        for(size_t r = 0; r < m; r++) {
+            float max_val = row_max(xc + r * n, n);
+            for(size_t k = 0; k < n; k++) {
+                yc[r * n + k] = xc[r * n + k] - max_val;
+            }
+        }
+        _cten_kernels.exp(yc, buf, m * n);
+        for(size_t r = 0; r < m; r++) {
+            float log_sum = _cten_kernels.scalar_log(row_sum(buf + r * n, n));
+            for(size_t k = 0; k < n; k++) {
+                yc[r * n + k] -= log_sum;
+            }
+        }
+    }
+    free(buf);
+}
+
+// dL/dz_j = s_j * (dL/ds_j - sum_k(dL/ds_k * s_k)), with s the forward output in x
+static void softmax_grad_rows(void* ctx, size_t begin, size_t end) {
+    const SoftmaxRows* t = ctx;
+    size_t n = t->n;
+    for(size_t r = begin; r < end; r++) {
+        const float* s = t->x + r * n;
+        const float* g = t->g + r * n;
+        float* gx = t->y + r * n;
+        float dot_product = 0.0f;
+        if(n >= SOFTMAX_SHORT_ROW) {
+            dot_product = _cten_kernels.dot(g, s, n);
+        } else {
+            for(size_t k = 0; k < n; k++) {
+                dot_product += g[k] * s[k];
+            }
+        }
+        for(size_t k = 0; k < n; k++) {
+            gx[k] = s[k] * (g[k] - dot_product);
+        }
+    }
+}
+
 static Tensor GradFn_softmax(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor grad = Tensor_new(input.shape, false);
 
     int dim = self.node->params[0];
-    int input_ndim = TensorShape_dim(input.shape);
-
-    int dim_size = self.shape[dim];
-    int outer_size = 1;
-    for(int j = 0; j < dim; j++) {
-        outer_size *= self.shape[j];
-    }
-    int inner_size = 1;
-    for(int j = dim + 1; j < input_ndim; j++) {
-        inner_size *= self.shape[j];
-    }
+    size_t dim_size = self.shape[dim];
+    size_t inner_size = _cten_stride(self, dim);
+    size_t outer_size = self.numel / (dim_size * inner_size);
 
     float* s_data = self.data->flex;                         // Softmax output data (s)
     float* upstream_grad_data = self.node->grad.data->flex;  // Upstream grad (dL/ds)
     float* input_grad_data = grad.data->flex;                // Resulting grad (dL/dz)
-    for(int outer = 0; outer < outer_size; outer++) {
-        for(int inner = 0; inner < inner_size; inner++) {
-            int slice_offset = outer * dim_size * inner_size + inner;
+    if(inner_size == 1) {
+        SoftmaxRows t = {.n = dim_size, .x = s_data, .g = upstream_grad_data, .y = input_grad_data};
+        softmax_parallel(softmax_grad_rows, &t, outer_size);
+        return grad;
+    }
+    for(size_t outer = 0; outer < outer_size; outer++) {
+        for(size_t inner = 0; inner < inner_size; inner++) {
+            size_t slice_offset = outer * dim_size * inner_size + inner;
             // Step 1. Calculate the dot product for the current slice: sum_k(dL/ds_k * s_k)
             float dot_product = 0.0f;
-            for(int k = 0; k < dim_size; k++) {
-                int index = slice_offset + k * inner_size;
+            for(size_t k = 0; k < dim_size; k++) {
+                size_t index = slice_offset + k * inner_size;
                 dot_product += upstream_grad_data[index] * s_data[index];
             }
 
             // Step 2. Calculate the final gradient using the formula: dL/dz_j = s_j * (dL/ds_j -
             // dot_product)
-            for(int k = 0; k < dim_size; k++) {
-                int index = slice_offset + k * inner_size;
+            for(size_t k = 0; k < dim_size; k++) {
+                size_t index = slice_offset + k * inner_size;
                 input_grad_data[index] = s_data[index] * (upstream_grad_data[index] - dot_product);
             }
         }
@@ -337,38 +631,37 @@ static Tensor GradFn_softmax(Tensor self, int i) {
 }
 
 Tensor nn_softmax(Tensor self, int dim) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    int self_dim = TensorShape_dim(self.shape);
-    assert(dim >= 0 && dim < self_dim);
-    int dim_size = self.shape[dim];
-    int outer_size = 1;
-    for(int i = 0; i < dim; i++) {
-        outer_size *= self.shape[i];
-    }
-    int inner_size = 1;
-    for(int i = dim + 1; i < self_dim; i++) {
-        inner_size *= self.shape[i];
-    }
-
-    for(int outer = 0; outer < outer_size; outer++) {
-        for(int inner = 0; inner < inner_size; inner++) {
-            int slice_offset = outer * dim_size * inner_size + inner;
-            float max_val = -INFINITY;
-            for(int k = 0; k < dim_size; k++) {
-                int index = slice_offset + k * inner_size;
-                max_val = fmaxf(max_val, self.data->flex[index]);
-            }
-            float sum = 0.0f;
-            for(int k = 0; k < dim_size; k++) {
-                int index = slice_offset + k * inner_size;
-                float val = expf(self.data->flex[index] - max_val);
-                res.data->flex[index] = val;
-                sum += val;
-            }
-            for(int k = 0; k < dim_size; k++) {
-                int index = slice_offset + k * inner_size;
-                res.data->flex[index] /= sum;
+    assert(dim >= 0 && dim < self.ndim);
+    size_t dim_size = self.shape[dim];
+    size_t inner_size = _cten_stride(self, dim);
+    size_t outer_size = self.numel / (dim_size * inner_size);
+
+    if(inner_size == 1) {
+        SoftmaxRows t = {.n = dim_size, .x = self.data->flex, .y = res.data->flex};
+        softmax_parallel(softmax_rows, &t, outer_size);
+    } else {
+        for(size_t outer = 0; outer < outer_size; outer++) {
+            for(size_t inner = 0; inner < inner_size; inner++) {
+                size_t slice_offset = outer * dim_size * inner_size + inner;
+                float max_val = -INFINITY;
+                for(size_t k = 0; k < dim_size; k++) {
+                    size_t index = slice_offset + k * inner_size;
+                    max_val = fmaxf(max_val, self.data->flex[index]);
+                }
+                float sum = 0.0f;
+                for(size_t k = 0; k < dim_size; k++) {
+                    size_t index = slice_offset + k * inner_size;
+                    float val = _cten_kernels.scalar_exp(self.data->flex[index] - max_val);
+                    res.data->flex[index] = val;
+                    sum += val;
+                }
+                for(size_t k = 0; k < dim_size; k++) {
+                    size_t index = slice_offset + k * inner_size;
+                    res.data->flex[index] /= sum;
+                }
             }
         }
     }
@@ -383,23 +676,149 @@ Tensor nn_softmax(Tensor self, int dim) {
     return res;
 }
 
+// dL/dx_j = g_j - softmax_j * sum_k(g_k), with softmax_j = exp(y_j) from the output in x
+static void log_softmax_grad_rows(void* ctx, size_t begin, size_t end) {
+    const SoftmaxRows* t = ctx;
+    size_t n = t->n, chunk_rows = softmax_chunk_rows(n);
+    for(size_t r0 = begin; r0 < end; r0 += chunk_rows) {
+        size_t m = end - r0 < chunk_rows ? end - r0 : chunk_rows;
+        size_t offset = r0 * n;
+        _cten_kernels.exp(t->x + offset, t->y + offset, m * n);
+        for(size_t r = 0; r < m; r++, offset += n) {
+            float g_sum = row_sum(t->g + offset, n);
+            for(size_t k = 0; k < n; k++) {
+                t->y[offset + k] = t->g[offset + k] - t->y[offset + k] * g_sum;
+            }
+        }
+    }
+}
+
+static Tensor GradFn_log_softmax(Tensor self, int i) {
+    Tensor input = self.node->inputs[i];
+    Tensor grad = Tensor_new(input.shape, false);
+
+    int dim = self.node->params[0];
+    size_t dim_size = self.shape[dim];
+    size_t inner_size = _cten_stride(self, dim);
+    size_t outer_size = self.numel / (dim_size * inner_size);
+
+    const float* y = self.data->flex;
+    const float* g = self.node->grad.data->flex;
+    float* gx = grad.data->flex;
+    if(inner_size == 1) {
+        SoftmaxRows t = {.n = dim_size, .x = y, .g = g, .y = gx};
+        softmax_parallel(log_softmax_grad_rows, &t, outer_size);
+        return grad;
+    }
+    for(size_t outer = 0; outer < outer_size; outer++) {
+        for(size_t inner = 0; inner < inner_size; inner++) {
+            size_t slice_offset = outer * dim_size * inner_size + inner;
+            float g_sum = 0.0f;
+            for(size_t k = 0; k < dim_size; k++) {
+                g_sum += g[slice_offset + k * inner_size];
+            }
+            for(size_t k = 0; k < dim_size; k++) {
+                size_t index = slice_offset + k * inner_size;
+                gx[index] = g[index] - _cten_kernels.scalar_exp(y[index]) * g_sum;
+            }
+        }
+    }
+    return grad;
+}
+
+/* log_softmax(x) = x - logsumexp(x), built from the shifted logits rather than as log(softmax(x)),
+ * so confident rows keep finite log-probabilities where the probabilities underflow to zero. */
+Tensor nn_log_softmax(Tensor self, int dim) {
+    self = _cten_as_f32(self);
+    bool requires_grad = !cten_is_eval() && self.node != NULL;
+    Tensor res = Tensor_new(self.shape, requires_grad);
+    assert(dim >= 0 && dim < self.ndim);
+    size_t dim_size = self.shape[dim];
+    size_t inner_size = _cten_stride(self, dim);
+    size_t outer_size = self.numel / (dim_size * inner_size);
+
+    if(inner_size == 1) {
+        SoftmaxRows t = {.n = dim_size, .x = self.data->flex, .y = res.data->flex};
+        softmax_parallel(log_softmax_rows, &t, outer_size);
+    } else {
+        for(size_t outer = 0; outer < outer_size; outer++) {
+            for(size_t inner = 0; inner < inner_size; inner++) {
+                size_t slice_offset = outer * dim_size * inner_size + inner;
+                float max_val = -INFINITY;
+                for(size_t k = 0; k < dim_size; k++) {
+                    max_val = fmaxf(max_val, self.data->flex[slice_offset + k * inner_size]);
+                }
+                float sum = 0.0f;
+                for(size_t k = 0; k < dim_size; k++) {
+                    size_t index = slice_offset + k * inner_size;
+                    sum += _cten_kernels.scalar_exp(self.data->flex[index] - max_val);
+                }
+                float lse = max_val + _cten_kernels.scalar_log(sum);
+                for(size_t k = 0; k < dim_size; k++) {
+                    size_t index = slice_offset + k * inner_size;
+                    res.data->flex[index] = self.data->flex[index] - lse;
+                }
+            }
+        }
+    }
+
+    if(requires_grad) {
+        res.node->grad_fn = GradFn_log_softmax;
+        res.node->inputs[0] = self;
+        res.node->n_inputs = 1;
+        res.node->name = "LogSoftmax";
+        res.node->params[0] = dim;
+    }
+    return res;
+}
+
+// Class-index labels (TensorDType_I32, one per sample) select a single probability per row, so
+// the losses and their gradients never materialize the one-hot matrix.
+static int class_label(Tensor y_true, int sample, int n_classes) {
+    int32_t label = y_true.data->flexi[sample];
+    cten_assert(label >= 0 && label < n_classes,
+                "class label %d out of range [0, %d)",
+                (int)label,
+                n_classes);
+    return label;
+}
+
+static bool has_class_labels(Tensor y_true, size_t n_samples) {
+    if(y_true.data->dtype != TensorDType_I32) return false;
+    cten_assert(y_true.numel == n_samples,
+                "expected %zu class labels, got %zu",
+                n_samples,
+                y_true.numel);
+    return true;
+}
+
 static Tensor GradFn_crossentropy(Tensor self, int i) {
     if(i == 1) {  // Gradient w.r.t. y_pred
         Tensor y_true = self.node->inputs[0];
         Tensor y_pred = self.node->inputs[1];
-        int n_samples = y_true.shape[0];
-        int n_classes = y_true.shape[1];
+        int n_samples = y_pred.shape[0];
+        int n_classes = y_pred.shape[1];
+
+        // the loss is the mean over samples
+        if(y_true.data->dtype == TensorDType_I32) {
+            Tensor grad = Tensor_zeros(y_pred.shape, false);
+            for(int r = 0; r < n_samples; r++) {
+                size_t index = (size_t)r * n_classes + class_label(y_true, r, n_classes);
+                grad.data->flex[index] = -1.0f / (y_pred.data->flex[index] * n_samples);
+            }
+            return grad;
+        }
 
         Tensor grad = Tensor_new(y_pred.shape, false);
 
-        for(int i = 0; i < n_samples; i++) {
+        for(int r = 0; r < n_samples; r++) {
             for(int j = 0; j < n_classes; j++) {
-                float y_true_val = y_true.data->flex[i * n_classes + j];
-                float y_pred_val = y_pred.data->flex[i * n_classes + j];
+                float y_true_val = y_true.data->flex[r * n_classes + j];
+                float y_pred_val = y_pred.data->flex[r * n_classes + j];
                 if(y_true_val == 0) {
-                    grad.data->flex[i * n_classes + j] = 0;
+                    grad.data->flex[r * n_classes + j] = 0;
                 } else {
-                    grad.data->flex[i * n_classes + j] = -y_true_val / y_pred_val;
+                    grad.data->flex[r * n_classes + j] = -y_true_val / (y_pred_val * n_samples);
                 }
             }
         }
@@ -409,15 +828,20 @@ static Tensor GradFn_crossentropy(Tensor self, int i) {
 }
 
 Tensor nn_crossentropy(Tensor y_true, Tensor y_pred) {
-    // y_true: [None, n_classes]
+    y_pred = _cten_as_f32(y_pred);
+    // y_true: [None, n_classes], or [None] int32 class labels
     // y_pred: [None, n_classes]
-    assert(TensorShape_dim(y_true.shape) == 2);
-    assert(TensorShape_dim(y_pred.shape) == 2);
-
-    int n_samples = y_true.shape[0];
-    int n_classes = y_true.shape[1];
-    assert(n_samples == y_pred.shape[0]);
-    assert(n_classes == y_pred.shape[1]);
+    assert(y_pred.ndim == 2);
+
+    int n_samples = y_pred.shape[0];
+    int n_classes = y_pred.shape[1];
+    bool sparse = has_class_labels(y_true, n_samples);
+    if(!sparse) {
+        y_true = _cten_as_f32(y_true);
+        assert(y_true.ndim == 2);
+        assert(n_samples == y_true.shape[0]);
+        assert(n_classes == y_true.shape[1]);
+    }
 
     bool requires_grad =
         !cten_is_eval() &&
@@ -427,14 +851,20 @@ Tensor nn_crossentropy(Tensor y_true, Tensor y_pred) {
 
     // Calculate cross-entropy loss
     float total_loss = 0.0f;
+    float epsilon = 1e-8f;  // avoid log(0) so we add a small epsilon
     for(int i = 0; i < n_samples; i++) {
         float sample_loss = 0.0f;
-        for(int j = 0; j < n_classes; j++) {
-            float true_val = y_true.data->flex[i * n_classes + j];
-            float pred_val = y_pred.data->flex[i * n_classes + j];
-            float epsilon = 1e-8f;  // avoid log(0) so we add a small epsilon
-            if(true_val > 0) {      // one-hot encoding
-                sample_loss -= true_val * logf(pred_val + epsilon);
+        if(sparse) {
+            int label = class_label(y_true, i, n_classes);
+            float p = y_pred.data->flex[i * n_classes + label];
+            sample_loss = -_cten_kernels.scalar_log(p + epsilon);
+        } else {
+            for(int j = 0; j < n_classes; j++) {
+                float true_val = y_true.data->flex[i * n_classes + j];
+                float pred_val = y_pred.data->flex[i * n_classes + j];
+                if(true_val > 0) {  // one-hot encoding
+                    sample_loss -= true_val * _cten_kernels.scalar_log(pred_val + epsilon);
+                }
             }
         }
         total_loss += sample_loss;
@@ -453,72 +883,171 @@ Tensor nn_crossentropy(Tensor y_true, Tensor y_pred) {
     return res;
 }
 
+// (softmax - onehot) scaled by the upstream gradient over the row count, from the logits in x and
+// the saved lse
+static void softmax_crossentropy_grad_rows(void* ctx, size_t begin, size_t end) {
+    const SoftmaxRows* t = ctx;
+    bool sparse = t->labels.data->dtype == TensorDType_I32;
+    size_t n = t->n, chunk_rows = softmax_chunk_rows(n);
+    for(size_t r0 = begin; r0 < end; r0 += chunk_rows) {
+        size_t m = end - r0 < chunk_rows ? end - r0 : chunk_rows;
+        const float* xc = t->x + r0 * n;
+        float* gc = t->y + r0 * n;
+        for(size_t r = 0; r < m; r++) {
+            for(size_t k = 0; k < n; k++) {
+                gc[r * n + k] = xc[r * n + k] - t->lse[r0 + r];
+            }
+        }
+        _cten_kernels.exp(gc, gc, m * n);
+        for(size_t r = 0; r < m; r++) {
+            float* gr = gc + r * n;
+            if(sparse) {
+                gr[class_label(t->labels, (int)(r0 + r), (int)n)] -= 1.0f;
+            } else {
+                const float* yr = t->labels.data->flex + (r0 + r) * n;
+                for(size_t k = 0; k < n; k++) {
+                    gr[k] -= yr[k];
+                }
+            }
+            if(t->upstream != 1.0f) _cten_kernels.scale(gr, t->upstream, gr, n);
+        }
+    }
+}
+
 static Tensor GradFn_softmax_crossentropy(Tensor self, int i) {
     if(i == 1) {
-        Tensor y_true = self.node->inputs[0];
+        // (softmax - onehot) / n_samples in one pass from the log-sum-exp the forward saved, with
+        // the upstream gradient folded in: no softmax tensor is rebuilt and no second tensor is
+        // allocated
         Tensor logits = self.node->inputs[1];
+        size_t n = logits.shape[logits.ndim - 1];
+        size_t n_samples = logits.numel / n;
+        Tensor grad = Tensor_new(logits.shape, false);
+        SoftmaxRows t = {
+            .n = n,
+            .x = logits.data->flex,
+            .y = grad.data->flex,
+            .lse = self.node->saved[0].data->flex,
+            .labels = self.node->inputs[0],
+            .upstream = self.node->grad.data->flex[0] / n_samples,
+        };
+        softmax_parallel(softmax_crossentropy_grad_rows, &t, n_samples);
+        return grad;
+    }
+    return Tensor_zeros((TensorShape){1}, false);
+}
 
-        Tensor y_pred = Tensor_new(logits.shape, false);
-        int self_dim = TensorShape_dim(logits.shape);
-        int last_dim_size = logits.shape[self_dim - 1];
-        int outer_size = logits.data->numel / last_dim_size;
+/* The loss of a row is lse - z[label], or sum_k y_k * (lse - z_k) for dense targets, so the
+ * forward only needs the log-sum-exp of each row. It keeps that vector for the backward in
+ * saved[0] instead of the probabilities. */
+Tensor nn_softmax_crossentropy(Tensor y_true, Tensor logits) {
+    logits = _cten_as_f32(logits);
+    size_t n_classes = logits.shape[logits.ndim - 1];
+    size_t n_samples = logits.numel / n_classes;
+    bool sparse = has_class_labels(y_true, n_samples);
+    if(!sparse) {
+        y_true = _cten_as_f32(y_true);
+        cten_assert(y_true.numel == logits.numel,
+                    "expected %zu one-hot targets, got %zu",
+                    logits.numel,
+                    y_true.numel);
+    }
+    bool requires_grad = !cten_is_eval() && logits.node != NULL;
 
-        for(int outer = 0; outer < outer_size; outer++) {
-            float max_val = -INFINITY;
-            float sum = 0;
+    Tensor lse = Tensor_new((TensorShape){(int)n_samples}, false);
+    SoftmaxRows t = {.n = n_classes, .x = logits.data->flex, .lse = lse.data->flex};
+    softmax_parallel(logsumexp_rows, &t, n_samples);
 
-            for(int d = 0; d < last_dim_size; d++) {
-                int index = outer * last_dim_size + d;
-                max_val = fmaxf(max_val, logits.data->flex[index]);
-            }
+    float total_loss = 0.0f;
+    for(size_t i = 0; i < n_samples; i++) {
+        const float* z = logits.data->flex + i * n_classes;
+        if(sparse) {
+            total_loss += lse.data->flex[i] - z[class_label(y_true, (int)i, (int)n_classes)];
+            continue;
+        }
+        const float* y = y_true.data->flex + i * n_classes;
+        for(size_t k = 0; k < n_classes; k++) {
+            if(y[k] != 0) total_loss += y[k] * (lse.data->flex[i] - z[k]);
+        }
+    }
 
-            for(int d = 0; d < last_dim_size; d++) {
-                int index = outer * last_dim_size + d;
-                y_pred.data->flex[index] = expf(logits.data->flex[index] - max_val);
-                sum += y_pred.data->flex[index];
-            }
+    Tensor res = Tensor_zeros((TensorShape){1}, requires_grad);
+    res.data->flex[0] = total_loss / n_samples;
 
-            for(int d = 0; d < last_dim_size; d++) {
-                int index = outer * last_dim_size + d;
-                y_pred.data->flex[index] /= sum;
-            }
-        }
+    if(requires_grad) {
+        res.node->grad_fn = GradFn_softmax_crossentropy;
+        res.node->inputs[0] = y_true;
+        res.node->inputs[1] = logits;
+        res.node->saved[0] = lse;
+        res.node->n_inputs = 2;
+        res.node->name = "SoftmaxCrossEntropy";
+    }
 
-        Tensor grad = Tensor_new(y_pred.shape, false);
-        int n_samples = y_pred.shape[0];
-        int n_classes = y_pred.shape[1];
+    return res;
+}
 
-        for(int i = 0; i < n_samples; i++) {
-            for(int j = 0; j < n_classes; j++) {
-                grad.data->flex[i * n_classes + j] =
-                    y_pred.data->flex[i * n_classes + j] - y_true.data->flex[i * n_classes + j];
+static Tensor GradFn_nll_loss(Tensor self, int i) {
+    if(i == 1) {
+        // -onehot scaled by the upstream gradient over the row count, as the loss is the mean of
+        // the rows; with class labels only one entry per row is written
+        Tensor y_true = self.node->inputs[0];
+        Tensor log_probs = self.node->inputs[1];
+        size_t n_classes = log_probs.shape[log_probs.ndim - 1];
+        size_t n_samples = log_probs.numel / n_classes;
+        float upstream = self.node->grad.data->flex[0] / n_samples;
+
+        if(y_true.data->dtype == TensorDType_I32) {
+            Tensor grad = Tensor_zeros(log_probs.shape, false);
+            for(size_t r = 0; r < n_samples; r++) {
+                int label = class_label(y_true, (int)r, (int)n_classes);
+                grad.data->flex[r * n_classes + label] = -upstream;
             }
+            return grad;
         }
-
+        Tensor grad = Tensor_new(log_probs.shape, false);
+        _cten_kernels.scale(y_true.data->flex, -upstream, grad.data->flex, log_probs.numel);
         return grad;
     }
     return Tensor_zeros((TensorShape){1}, false);
 }
 
-Tensor nn_softmax_crossentropy(Tensor y_true, Tensor logits) {
-    bool requires_grad = !cten_is_eval() && logits.node != NULL;
-    // disable gradient computation
-    cten_begin_eval();
-    int last_dim_logits = TensorShape_dim(logits.shape) - 1;
-    Tensor y_pred = nn_softmax(logits, last_dim_logits);
-    Tensor loss = nn_crossentropy(y_true, y_pred);
-    cten_end_eval();
+Tensor nn_nll_loss(Tensor y_true, Tensor log_probs) {
+    log_probs = _cten_as_f32(log_probs);
+    size_t n_classes = log_probs.shape[log_probs.ndim - 1];
+    size_t n_samples = log_probs.numel / n_classes;
+    bool sparse = has_class_labels(y_true, n_samples);
+    if(!sparse) {
+        y_true = _cten_as_f32(y_true);
+        cten_assert(y_true.numel == log_probs.numel,
+                    "expected %zu one-hot targets, got %zu",
+                    log_probs.numel,
+                    y_true.numel);
+    }
+    bool requires_grad = !cten_is_eval() && log_probs.node != NULL;
+
+    float total_loss = 0.0f;
+    for(size_t i = 0; i < n_samples; i++) {
+        const float* lp = log_probs.data->flex + i * n_classes;
+        if(sparse) {
+            total_loss -= lp[class_label(y_true, (int)i, (int)n_classes)];
+            continue;
+        }
+        const float* y = y_true.data->flex + i * n_classes;
+        for(size_t k = 0; k < n_classes; k++) {
+            if(y[k] != 0) total_loss -= y[k] * lp[k];
+        }
+    }
+
     Tensor res = Tensor_zeros((TensorShape){1}, requires_grad);
-    res.data->flex[0] = loss.data->flex[0];
+    res.data->flex[0] = total_loss / n_samples;
 
     if(requires_grad) {
-        res.node->grad_fn = GradFn_softmax_crossentropy;
+        res.node->grad_fn = GradFn_nll_loss;
         res.node->inputs[0] = y_true;
-        res.node->inputs[1] = logits;
+        res.node->inputs[1] = log_probs;
         res.node->n_inputs = 2;
-        res.node->name = "SoftmaxCrossEntropy";
+        res.node->name = "NLLLoss";
     }
-
     return res;
 }
 
@@ -526,10 +1055,10 @@ static Tensor GradFn_mse_loss(Tensor self, int i) {
     if(i == 1) {  // Gradient w.r.t y_pred
         Tensor y_true = self.node->inputs[0];
         Tensor y_pred = self.node->inputs[1];
-        int n = y_pred.data->numel;
+        size_t n = y_pred.data->numel;
 
         Tensor grad = Tensor_new(y_pred.shape, false);
-        for(int j = 0; j < n; j++) {
+        for(size_t j = 0; j < n; j++) {
             grad.data->flex[j] = 2.0f * (y_pred.data->flex[j] - y_true.data->flex[j]) / n;
         }
         return grad;
@@ -538,6 +1067,8 @@ static Tensor GradFn_mse_loss(Tensor self, int i) {
 }
 
 Tensor nn_mse_loss(Tensor y_true, Tensor y_pred) {
+    y_true = _cten_as_f32(y_true);
+    y_pred = _cten_as_f32(y_pred);
     bool requires_grad = !cten_is_eval() && y_pred.node != NULL;
 
     cten_begin_eval();
@@ -563,10 +1094,10 @@ static Tensor GradFn_mae_loss(Tensor self, int i) {
     if(i == 1) {  // Gradient w.r.t y_pred
         Tensor y_true = self.node->inputs[0];
         Tensor y_pred = self.node->inputs[1];
-        int n = y_pred.data->numel;
+        size_t n = y_pred.data->numel;
 
         Tensor grad = Tensor_new(y_pred.shape, false);
-        for(int j = 0; j < n; j++) {
+        for(size_t j = 0; j < n; j++) {
             float error = y_pred.data->flex[j] - y_true.data->flex[j];
             if(error > 0) {
                 grad.data->flex[j] = 1.0f / n;
@@ -582,6 +1113,8 @@ static Tensor GradFn_mae_loss(Tensor self, int i) {
 }
 
 Tensor nn_mae_loss(Tensor y_true, Tensor y_pred) {
+    y_true = _cten_as_f32(y_true);
+    y_pred = _cten_as_f32(y_pred);
     bool requires_grad = !cten_is_eval() && y_pred.node != NULL;
 
     cten_begin_eval();
@@ -607,13 +1140,13 @@ static Tensor GradFn_huber_loss(Tensor self, int i) {
     if(i == 1) {  // Gradient w.r.t y_pred
         Tensor y_true = self.node->inputs[0];
         Tensor y_pred = self.node->inputs[1];
-        float delta = huber_delta_value;
-        int n = y_pred.data->numel;
+        float delta = _cten_param_f32(self.node, 0);
+        size_t n = y_pred.data->numel;
 
         Tensor grad = Tensor_new(y_pred.shape, false);
         // Gradient of Huber loss is (error / n) for small errors,
         // and (delta * sign(error) / n) for large errors.
-        for(int j = 0; j < n; j++) {
+        for(size_t j = 0; j < n; j++) {
             float error = y_pred.data->flex[j] - y_true.data->flex[j];
             if(fabsf(error) <= delta) {
                 grad.data->flex[j] = error / n;
@@ -631,12 +1164,13 @@ static Tensor GradFn_huber_loss(Tensor self, int i) {
 }
 
 Tensor nn_huber_loss(Tensor y_true, Tensor y_pred, float delta) {
-    huber_delta_value = delta;  // Store delta for the backward pass
+    y_true = _cten_as_f32(y_true);
+    y_pred = _cten_as_f32(y_pred);
     bool requires_grad = !cten_is_eval() && y_pred.node != NULL;
 
-    int n = y_pred.data->numel;
+    size_t n = y_pred.data->numel;
     float total_loss = 0.0f;
-    for(int i = 0; i < n; i++) {
+    for(size_t i = 0; i < n; i++) {
         float error = y_pred.data->flex[i] - y_true.data->flex[i];
         float abs_error = fabsf(error);
         if(abs_error <= delta) {
@@ -655,6 +1189,7 @@ Tensor nn_huber_loss(Tensor y_true, Tensor y_pred, float delta) {
         res.node->inputs[1] = y_pred;
         res.node->n_inputs = 2;
         res.node->name = "HuberLoss";
+        _cten_set_param_f32(res.node, 0, delta);
     }
     return res;
 }
\ No newline at end of file
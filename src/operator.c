@@ -21,6 +21,32 @@
 #undef Tensor_min
 #endif
 
+// res = KERNEL(a, b) for same-shaped operands `a` and `b`, with KERNEL one of the dispatched
+// elementwise kernels. Float32 operands are split across the thread pool; reduced-precision ones
+// are widened to float32 one block at a time on the calling thread.
+#define ELEMWISE_BINARY(res, a, b, KERNEL)                                                      \
+    do {                                                                                        \
+        if((a).data->dtype == TensorDType_F32 && (b).data->dtype == TensorDType_F32) {          \
+            _cten_parallel_zip(KERNEL,                                                          \
+                               (a).data->flex,                                                  \
+                               (b).data->flex,                                                  \
+                               (res).data->flex,                                                \
+                               (res).numel,                                                     \
+                               _CTEN_GRAIN);                                                    \
+            break;                                                                              \
+        }                                                                                       \
+        float a_buf[_CTEN_LOAD_BLOCK], b_buf[_CTEN_LOAD_BLOCK];                                 \
+        size_t span = _cten_load_span((a).data) < _cten_load_span((b).data)                     \
+                          ? _cten_load_span((a).data)                                           \
+                          : _cten_load_span((b).data);                                          \
+        for(size_t base = 0; base < (res).numel; base += span) {                                \
+            size_t n = (res).numel - base < span ? (res).numel - base : span;                   \
+            const float* x = _cten_load_f32((a).data, base, n, a_buf);                          \
+            const float* y = _cten_load_f32((b).data, base, n, b_buf);                          \
+            KERNEL(x, y, (res).data->flex + base, n);                                           \
+        }                                                                                       \
+    } while(0)
+
 static Tensor GradFn_add(Tensor self, int i) {
     // f(x, y) = x + y; f'(x) = 1; f'(y) = 1
     Tensor input = self.node->inputs[i];
@@ -43,9 +69,7 @@ Tensor Tensor_add(Tensor self, Tensor other) {
     bool requires_grad = !cten_is_eval() && (orig_self.node != NULL || orig_other.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
 
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = self.data->flex[i] + other.data->flex[i];
-    }
+    ELEMWISE_BINARY(res, self, other, _cten_kernels.add);
 
     if(requires_grad) {
         res.node->grad_fn = GradFn_add;
@@ -68,9 +92,7 @@ Tensor Tensor_mul(Tensor self, Tensor other) {
     bool requires_grad = !cten_is_eval() && (orig_self.node != NULL || orig_other.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
 
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = self.data->flex[i] * other.data->flex[i];
-    }
+    ELEMWISE_BINARY(res, self, other, _cten_kernels.mul);
 
     if(requires_grad) {
         res.node->grad_fn = GradFn_mul;
@@ -84,7 +106,7 @@ Tensor Tensor_mul(Tensor self, Tensor other) {
 
 Tensor Tensor_mulf(Tensor self, float other) {
     Tensor tmp = Tensor_new(self.shape, false);
-    for(int i = 0; i < tmp.data->numel; i++) {
+    for(size_t i = 0; i < tmp.data->numel; i++) {
         tmp.data->flex[i] = other;
     }
     Tensor res = Tensor_mul(self, tmp);
@@ -92,32 +114,26 @@ Tensor Tensor_mulf(Tensor self, float other) {
 }
 
 void Tensor_argmax(Tensor self, int* out) {
+    self = _cten_as_f32(self);
     // reduce last dim
-    int last_dim = self.shape[TensorShape_dim(self.shape) - 1];
-    int n = TensorShape_numel(self.shape) / last_dim;
-    for(int i = 0; i < n; i++) {
-        float* p = self.data->flex + i * last_dim;
-        float max_val = p[0];
-        int max_idx = 0;
-        for(int j = 1; j < last_dim; j++) {
-            if(p[j] > max_val) {
-                max_val = p[j];
-                max_idx = j;
-            }
-        }
-        out[i] = max_idx;
+    int last_dim = self.shape[self.ndim - 1];
+    size_t n = self.numel / last_dim;
+    for(size_t i = 0; i < n; i++) {
+        size_t max_idx;
+        _cten_kernels.reduce_max_index(self.data->flex + i * last_dim, last_dim, &max_idx);
+        out[i] = (int)max_idx;
     }
 }
 
 Tensor GradFn_mean(Tensor self, int i) {
     Tensor input_tensor = self.node->inputs[i];
-    int divisor;
+    size_t divisor;
 
-    if(TensorShape_numel(self.shape) == 1 && TensorShape_numel(input_tensor.shape) > 1) {
-        divisor = TensorShape_numel(input_tensor.shape);
+    if(self.numel == 1 && input_tensor.numel > 1) {
+        divisor = input_tensor.numel;
     } else {
-        int input_ndim = TensorShape_dim(input_tensor.shape);
-        int output_ndim = TensorShape_dim(self.shape);
+        int input_ndim = input_tensor.ndim;
+        int output_ndim = self.ndim;
         if(input_ndim > output_ndim) {
             int out_idx = 0;
             int reduced_dim_size = 1;
@@ -131,7 +147,7 @@ Tensor GradFn_mean(Tensor self, int i) {
             divisor = reduced_dim_size;
         } else {
             // scalar input
-            divisor = TensorShape_numel(input_tensor.shape);
+            divisor = input_tensor.numel;
         }
     }
 
@@ -139,16 +155,16 @@ Tensor GradFn_mean(Tensor self, int i) {
     Tensor res = Tensor_new(input_tensor.shape, false);
 
     // gradient value is 1 divided by the number of elements that were averaged.
-    float grad_val = 1.0f / divisor;
+    float grad_val = 1.0f / (float)divisor;
 
-    for(int j = 0; j < res.data->numel; j++) {
+    for(size_t j = 0; j < res.data->numel; j++) {
         res.data->flex[j] = grad_val;
     }
     return res;
 }
 
 Tensor Tensor_mean(Tensor self, ...) {
-    int ndim = TensorShape_dim(self.shape);
+    int ndim = self.ndim;
     int dim = INT_MIN;  // Default value to trigger the "else" block
 
     va_list args;
@@ -167,19 +183,7 @@ Tensor Tensor_mean(Tensor self, ...) {
         }
         return res;
     } else {
-        Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, self.node != NULL);
-        float sum = 0;
-        for(int i = 0; i < self.data->numel; i++) {
-            sum += self.data->flex[i];
-        }
-        res.data->flex[0] = sum / self.data->numel;
-        if(res.node != NULL) {
-            res.node->grad_fn = GradFn_mean;
-            res.node->inputs[0] = self;
-            res.node->n_inputs = 1;
-            res.node->name = "Mean";
-        }
-        return res;
+        return Tensor_mean_all(self);
     }
 }
 
@@ -189,7 +193,7 @@ Tensor GradFn_sum(Tensor self, int i) {
 }
 
 Tensor Tensor_sum(Tensor self, ...) {
-    int ndim = TensorShape_dim(self.shape);
+    int ndim = self.ndim;
     int dim = INT_MIN;  // Default value to trigger the "else" block
 
     va_list args;
@@ -208,55 +212,251 @@ Tensor Tensor_sum(Tensor self, ...) {
         }
         return res;
     } else {
-        Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, self.node != NULL);
-        float sum = 0;
-        for(int i = 0; i < self.data->numel; i++) {
-            sum += self.data->flex[i];
-        }
-        res.data->flex[0] = sum;
-        if(res.node != NULL) {
-            res.node->grad_fn = GradFn_sum;
-            res.node->inputs[0] = self;
-            res.node->n_inputs = 1;
-            res.node->name = "Sum";
+        return Tensor_sum_all(self);
+    }
+}
+
+// Smallest row count and inner dimension for which Tensor_matmul uses the packed GEMM, the same as
+// the GEMM's own: from there on it reads a prepacked weight's panels instead of the weight
+#define MATMUL_GEMM_MIN_ROWS 8
+#define MATMUL_GEMM_MIN_DEPTH 4
+
+// Leading (batch) dimensions of a matmul, right-aligned and broadcast like elementwise ops. Each
+// operand's stride counts whole matrices and is 0 along the dimensions it broadcasts.
+typedef struct MatmulBatch {
+    int ndim;
+    int shape[CTEN_MAX_DIMS];
+    size_t a_stride[CTEN_MAX_DIMS];
+    size_t b_stride[CTEN_MAX_DIMS];
+    size_t count;
+} MatmulBatch;
+
+static void matmul_batch_init(MatmulBatch* mb, Tensor a, Tensor b) {
+    int a_nb = a.ndim - 2;
+    int b_nb = b.ndim - 2;
+    mb->ndim = a_nb > b_nb ? a_nb : b_nb;
+    mb->count = 1;
+    size_t a_run = 1, b_run = 1;
+    for(int d = mb->ndim - 1; d >= 0; d--) {
+        int ad = d - (mb->ndim - a_nb);
+        int bd = d - (mb->ndim - b_nb);
+        int a_size = ad >= 0 ? a.shape[ad] : 1;
+        int b_size = bd >= 0 ? b.shape[bd] : 1;
+        cten_assert(a_size == b_size || a_size == 1 || b_size == 1,
+                    "Tensor_matmul: batch dimensions %d and %d cannot be broadcast",
+                    a_size,
+                    b_size);
+        mb->shape[d] = a_size > b_size ? a_size : b_size;
+        mb->a_stride[d] = a_size == 1 ? 0 : a_run;
+        mb->b_stride[d] = b_size == 1 ? 0 : b_run;
+        a_run *= a_size;
+        b_run *= b_size;
+        mb->count *= mb->shape[d];
+    }
+}
+
+// Matrix index inside an operand for output batch `t`
+static size_t matmul_batch_index(const MatmulBatch* mb, const size_t* stride, size_t t) {
+    size_t index = 0;
+    for(int d = mb->ndim - 1; d >= 0; d--) {
+        index += (t % mb->shape[d]) * stride[d];
+        t /= mb->shape[d];
+    }
+    return index;
+}
+
+// Pointers to each output batch's matrix of one operand, `mat` floats per matrix
+static void matmul_batch_ptrs(const MatmulBatch* mb,
+                              const size_t* stride,
+                              const float* base,
+                              size_t mat,
+                              const float** out) {
+    for(size_t t = 0; t < mb->count; t++) {
+        out[t] = base + matmul_batch_index(mb, stride, t) * mat;
+    }
+}
+
+// Scratch for the operand pointers of a batched product: A, B, then C
+static void* matmul_ptrs_alloc(size_t count) {
+    void* ptrs = malloc(sizeof(float*) * 3 * count);
+    cten_assert(ptrs != NULL, "Tensor_matmul: out of memory");
+    return ptrs;
+}
+
+// Few rows or a shallow product: i-k-j order streams each row of `other` (widened if needed)
+// contiguously, with no packing to amortize.
+static void matmul_streamed(Tensor self,
+                            Tensor other,
+                            Tensor res,
+                            size_t m,
+                            size_t n,
+                            size_t p,
+                            const float* bias,
+                            nn_Activation act) {
+    float a_buf[_CTEN_LOAD_BLOCK], b_buf[_CTEN_LOAD_BLOCK];
+    size_t a_span = _cten_load_span(self.data);
+    size_t b_span = _cten_load_span(other.data);
+    for(size_t i = 0; i < m; i++) {
+        float* out = res.data->flex + i * p;
+        memset(out, 0, sizeof(float) * p);
+        for(size_t k0 = 0; k0 < n; k0 += a_span) {
+            size_t kn = n - k0 < a_span ? n - k0 : a_span;
+            const float* a_row = _cten_load_f32(self.data, i * n + k0, kn, a_buf);
+            for(size_t k = 0; k < kn; k++) {
+                float a_ik = a_row[k];
+                for(size_t j0 = 0; j0 < p; j0 += b_span) {
+                    size_t jn = p - j0 < b_span ? p - j0 : b_span;
+                    const float* b_row = _cten_load_f32(other.data, (k0 + k) * p + j0, jn, b_buf);
+                    for(size_t j = 0; j < jn; j++) {
+                        out[j0 + j] += a_ik * b_row[j];
+                    }
+                }
+            }
         }
-        return res;
+        _cten_bias_act(out, bias, p, act);
     }
 }
 
+void _cten_matmul_shared(Tensor self,
+                         Tensor other,
+                         Tensor res,
+                         size_t rows,
+                         size_t n,
+                         size_t p,
+                         const float* bias,
+                         nn_Activation act) {
+    bool f32 = self.data->dtype == TensorDType_F32 && other.data->dtype == TensorDType_F32;
+    bool packed_gemm = rows >= MATMUL_GEMM_MIN_ROWS && n >= MATMUL_GEMM_MIN_DEPTH;
+    if(!f32 && !packed_gemm) {
+        matmul_streamed(self, other, res, rows, n, p, bias, act);
+        return;
+    }
+    // float32 operands go straight to the shape-specialized kernels; reduced-precision ones need
+    // enough rows reusing each element of `other` to pay for widening it once, unless the packed
+    // GEMM reads its panels instead
+    const float* panels = _cten_weight_panels(other, false);
+    Tensor a = _cten_as_f32(self);
+    const float* b = panels != NULL && packed_gemm ? NULL : _cten_as_f32(other).data->flex;
+    _cten_sgemm_prepacked(false,
+                          rows,
+                          p,
+                          n,
+                          a.data->flex,
+                          n,
+                          b,
+                          p,
+                          panels,
+                          res.data->flex,
+                          p,
+                          bias,
+                          act);
+}
+
 static Tensor GradFn_matmul(Tensor self, int i) {
-    return Tensor_transpose(Tensor_detach(self.node->inputs[1 - i]));
-    ;
+    // Full chain rule against the upstream gradient (like softmax): dA = G @ B^T and dB = A^T @ G
+    // per batch, summed over the batch dimensions the operand was broadcast along. The transposes
+    // are GEMM flags, so neither operand is copied.
+    Tensor a = _cten_as_f32(self.node->inputs[0]);
+    Tensor b = _cten_as_f32(self.node->inputs[1]);
+    const float* g = self.node->grad.data->flex;
+    size_t m = a.shape[a.ndim - 2];
+    size_t n = a.shape[a.ndim - 1];
+    size_t p = b.shape[b.ndim - 1];
+
+    MatmulBatch mb;
+    matmul_batch_init(&mb, a, b);
+    if(b.numel == n * p) {
+        // shared `other`: flatten the batches into rows, so dB's batch sum is one deeper GEMM
+        size_t rows = mb.count * m;
+        if(i == 0) {
+            Tensor res = Tensor_new(a.shape, false);
+            _cten_sgemm_prepacked(true,
+                                  rows,
+                                  n,
+                                  p,
+                                  g,
+                                  p,
+                                  b.data->flex,
+                                  p,
+                                  _cten_weight_panels(self.node->inputs[1], true),
+                                  res.data->flex,
+                                  n,
+                                  NULL,
+                                  nn_Activation_None);
+            return res;
+        }
+        Tensor res = Tensor_new(b.shape, false);
+        _cten_sgemm(true, false, n, p, rows, a.data->flex, n, g, p, res.data->flex, p, false);
+        return res;
+    }
+
+    Tensor res = Tensor_zeros(i == 0 ? a.shape : b.shape, false);
+    // one product per output batch; a broadcast operand's batches all add into its one gradient
+    const float** g_t = matmul_ptrs_alloc(mb.count);
+    const float** x_t = g_t + mb.count;  // the other operand
+    float** d_t = (float**)(x_t + mb.count);
+    for(size_t t = 0; t < mb.count; t++) {
+        g_t[t] = g + t * m * p;
+    }
+    const size_t* d_stride = i == 0 ? mb.a_stride : mb.b_stride;
+    size_t d_mat = i == 0 ? m * n : n * p;
+    for(size_t t = 0; t < mb.count; t++) {
+        d_t[t] = res.data->flex + matmul_batch_index(&mb, d_stride, t) * d_mat;
+    }
+    bool distinct = res.numel / d_mat == mb.count;
+    if(i == 0) {
+        matmul_batch_ptrs(&mb, mb.b_stride, b.data->flex, n * p, x_t);
+        _cten_sgemm_batched(false, true, mb.count, m, n, p, g_t, p, x_t, p, d_t, n, true, distinct);
+    } else {
+        matmul_batch_ptrs(&mb, mb.a_stride, a.data->flex, m * n, x_t);
+        _cten_sgemm_batched(true, false, mb.count, n, p, m, x_t, n, g_t, p, d_t, p, true, distinct);
+    }
+    free(g_t);
+    return res;
 }
 
 Tensor Tensor_matmul(Tensor self, Tensor other) {
-    int self_dim = TensorShape_dim(self.shape);
-    int other_dim = TensorShape_dim(other.shape);
+    int self_dim = self.ndim;
+    int other_dim = other.ndim;
     assert(self_dim >= 2);
     assert(other_dim >= 2);
 
-    int m = self.shape[self_dim - 2];
-    int n = self.shape[self_dim - 1];
-    int p = other.shape[other_dim - 1];
-
-    assert(n == other.shape[other_dim - 2]);
-
-    TensorShape res_shape;
-    memcpy(res_shape, self.shape, sizeof(TensorShape));
-    res_shape[self_dim - 1] = p;
+    size_t m = self.shape[self_dim - 2];
+    size_t n = self.shape[self_dim - 1];
+    size_t p = other.shape[other_dim - 1];
+
+    cten_assert(n == (size_t)other.shape[other_dim - 2],
+                "Tensor_matmul: inner dimensions %zu and %d do not match",
+                n,
+                other.shape[other_dim - 2]);
+
+    MatmulBatch mb;
+    matmul_batch_init(&mb, self, other);
+    TensorShape res_shape = {0};
+    memcpy(res_shape, mb.shape, sizeof(int) * mb.ndim);
+    res_shape[mb.ndim] = m;
+    res_shape[mb.ndim + 1] = p;
     Tensor res = Tensor_new(
         res_shape,
         self.node != NULL ||
             other.node != NULL);  // here weight/bias have .node != NULL, so res have GradNode
 
-    for(int i = 0; i < m; i++) {
-        for(int j = 0; j < p; j++) {
-            float sum = 0;
-            for(int k = 0; k < n; k++) {
-                sum += self.data->flex[i * n + k] * other.data->flex[k * p + j];
-            }
-            res.data->flex[i * p + j] = sum;
+    if(other.numel == n * p) {
+        // one shared `other` (e.g. a weight): the batches of `self` are just more rows
+        _cten_matmul_shared(self, other, res, mb.count * m, n, p, NULL, nn_Activation_None);
+    } else {
+        Tensor a = _cten_as_f32(self);
+        Tensor b = _cten_as_f32(other);
+        const float** a_t = matmul_ptrs_alloc(mb.count);
+        const float** b_t = a_t + mb.count;
+        float** c_t = (float**)(b_t + mb.count);
+        matmul_batch_ptrs(&mb, mb.a_stride, a.data->flex, m * n, a_t);
+        matmul_batch_ptrs(&mb, mb.b_stride, b.data->flex, n * p, b_t);
+        for(size_t t = 0; t < mb.count; t++) {
+            c_t[t] = res.data->flex + t * m * p;
         }
+        _cten_sgemm_batched(false, false, mb.count, m, p, n, a_t, n, b_t, p, c_t, p, false, true);
+        free(a_t);
     }
 
     if(res.node != NULL) {
@@ -270,6 +470,49 @@ Tensor Tensor_matmul(Tensor self, Tensor other) {
     return res;
 }
 
+static void pack_weight_panels(Tensor weight, PackedWeight* pw) {
+    Tensor w = _cten_as_f32(weight);
+    _cten_gemm_pack_panels(pw->rows, pw->cols, w.data->flex, pw->cols, 1, pw->panels);
+    if(pw->panels_t != NULL) {
+        // the transpose is the same data with its strides swapped
+        _cten_gemm_pack_panels(pw->cols, pw->rows, w.data->flex, 1, pw->cols, pw->panels_t);
+    }
+    pw->stale = false;
+}
+
+void Tensor_pack_weight(Tensor weight, bool with_transpose) {
+    cten_assert(weight.ndim == 2,
+                "Tensor_pack_weight: expected a 2-D weight, got %d dims",
+                weight.ndim);
+    PackedWeight* pw = weight.data->packed;
+    size_t rows = weight.shape[0], cols = weight.shape[1];
+    if(pw == NULL || pw->rows != rows || pw->cols != cols) {
+        pw = _cten_malloc(sizeof(PackedWeight));
+        pw->rows = rows;
+        pw->cols = cols;
+        pw->panels = _cten_malloc(sizeof(float) * _cten_gemm_panels_size(rows, cols));
+        pw->panels_t = NULL;
+        weight.data->packed = pw;
+    }
+    if(with_transpose && pw->panels_t == NULL) {
+        pw->panels_t = _cten_malloc(sizeof(float) * _cten_gemm_panels_size(cols, rows));
+    }
+    pack_weight_panels(weight, pw);
+}
+
+const float* _cten_weight_panels(Tensor weight, bool transposed) {
+    PackedWeight* pw = weight.data->packed;
+    if(pw == NULL || weight.ndim < 2) return NULL;
+    // a reshaped view shares the buffer but not the layout the panels were packed for
+    if(pw->rows != (size_t)weight.shape[weight.ndim - 2] ||
+       pw->cols != (size_t)weight.shape[weight.ndim - 1] || pw->rows * pw->cols != weight.numel) {
+        return NULL;
+    }
+    if(transposed && pw->panels_t == NULL) return NULL;
+    if(pw->stale) pack_weight_panels(weight, pw);
+    return transposed ? pw->panels_t : pw->panels;
+}
+
 static Tensor GradFn_sub(Tensor self, int i) {
     // f(x, y) = x - y; f'(x) = 1; f'(y) = -1
     Tensor input = self.node->inputs[i];
@@ -280,15 +523,33 @@ static Tensor GradFn_sub(Tensor self, int i) {
 
 static Tensor GradFn_div(Tensor self, int i) {
     Tensor res = Tensor_new(self.shape, false);
-    Tensor x = self.node->inputs[0];
-    Tensor y = self.node->inputs[1];
-
+    Tensor x = _cten_as_f32(self.node->inputs[0]);
+    Tensor y = _cten_as_f32(self.node->inputs[1]);
+
+    if(x.numel == res.numel && y.numel == res.numel) {
+        if(i == 0) {
+            _cten_parallel_map(_cten_kernels.reciprocal,
+                               y.data->flex,
+                               res.data->flex,
+                               res.numel,
+                               _CTEN_GRAIN);
+        } else {
+            _cten_parallel_zip(_cten_kernels.div_grad_y,
+                               x.data->flex,
+                               y.data->flex,
+                               res.data->flex,
+                               res.numel,
+                               _CTEN_GRAIN);
+        }
+        return res;
+    }
+    // broadcast operands repeat their elements over the result
     if(i == 0) {  // Gradient w.r.t. x: 1/y
-        for(int j = 0; j < res.data->numel; j++) {
+        for(size_t j = 0; j < res.data->numel; j++) {
             res.data->flex[j] = 1.0f / y.data->flex[j % y.data->numel];
         }
     } else {  // Gradient w.r.t. y: -x/y²
-        for(int j = 0; j < res.data->numel; j++) {
+        for(size_t j = 0; j < res.data->numel; j++) {
             float x_val = x.data->flex[j % x.data->numel];
             float y_val = y.data->flex[j % y.data->numel];
             res.data->flex[j] = -x_val / (y_val * y_val);
@@ -306,9 +567,7 @@ Tensor Tensor_div(Tensor self, Tensor other) {
     }
     bool requires_grad = !cten_is_eval() && (orig_self.node != NULL || orig_other.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = self.data->flex[i] / other.data->flex[i];
-    }
+    ELEMWISE_BINARY(res, self, other, _cten_kernels.div);
     if(requires_grad) {
         res.node->grad_fn = GradFn_div;
         res.node->inputs[0] = orig_self;
@@ -323,19 +582,19 @@ static Tensor GradFn_square(Tensor self, int i) {
     // f(x) = x²; f'(x) = 2x
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int j = 0; j < res.data->numel; j++) {
-        res.data->flex[j] = 2.0f * input.data->flex[j];
-    }
+    _cten_kernels.scale(input.data->flex, 2.0f, res.data->flex, res.numel);
     return res;
 }
 
 Tensor Tensor_square(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && (self.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        float val = self.data->flex[i];
-        res.data->flex[i] = val * val;
-    }
+    _cten_parallel_map(_cten_kernels.square,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN);
     if(requires_grad) {
         res.node->grad_fn = GradFn_square;
         res.node->inputs[0] = self;
@@ -349,19 +608,23 @@ static Tensor GradFn_reciprocal(Tensor self, int i) {
     // f(x) = 1/x; f'(x) = -1/x^2
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int j = 0; j < res.data->numel; j++) {
-        float x_val = input.data->flex[j];
-        res.data->flex[j] = -1.0f / (x_val * x_val);
-    }
+    _cten_parallel_map(_cten_kernels.reciprocal_grad,
+                       input.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN);
     return res;
 }
 
 Tensor Tensor_reciprocal(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && (self.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = 1.0f / self.data->flex[i];
-    }
+    _cten_parallel_map(_cten_kernels.reciprocal,
+                       self.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN);
     if(requires_grad) {
         res.node->grad_fn = GradFn_reciprocal;
         res.node->inputs[0] = self;
@@ -374,12 +637,12 @@ Tensor Tensor_reciprocal(Tensor self) {
 static Tensor GradFn_pow(Tensor self, int i) {
     // f(x, y) = x^y;  ∂f/∂x = y*x^(y-1);  ∂f/∂y = x^y * ln(x)
     Tensor res = Tensor_new(self.shape, false);
-    Tensor x = self.node->inputs[0];
-    Tensor y = self.node->inputs[1];
+    Tensor x = _cten_as_f32(self.node->inputs[0]);
+    Tensor y = _cten_as_f32(self.node->inputs[1]);
 
     if(i == 0) {
         // Gradient w.r.t. x: y*x^(y-1)
-        for(int j = 0; j < res.data->numel; j++) {
+        for(size_t j = 0; j < res.data->numel; j++) {
             float x_val = x.data->flex[j % x.data->numel];
             float y_val = y.data->flex[j % y.data->numel];
             if(x_val == 0.0f && y_val > 1.0f) {
@@ -390,7 +653,7 @@ static Tensor GradFn_pow(Tensor self, int i) {
         }
     } else {
         // Gradient w.r.t. y: x^y * ln(x)
-        for(int j = 0; j < res.data->numel; j++) {
+        for(size_t j = 0; j < res.data->numel; j++) {
             float x_val = x.data->flex[j % x.data->numel];
             float self_val = self.data->flex[j];
             if(x_val <= 0.0f) {
@@ -410,6 +673,12 @@ static Tensor GradFn_pow(Tensor self, int i) {
     return res;
 }
 
+static void pow_kernel(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = powf(x[i], y[i]);
+    }
+}
+
 Tensor Tensor_pow(Tensor self, Tensor other) {
     Tensor orig_self = self;
     Tensor orig_other = other;
@@ -418,9 +687,7 @@ Tensor Tensor_pow(Tensor self, Tensor other) {
     }
     bool requires_grad = !cten_is_eval() && (orig_self.node != NULL || orig_other.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = powf(self.data->flex[i], other.data->flex[i]);
-    }
+    ELEMWISE_BINARY(res, self, other, pow_kernel);
     if(requires_grad) {
         res.node->grad_fn = GradFn_pow;
         res.node->inputs[0] = orig_self;
@@ -439,9 +706,7 @@ Tensor Tensor_sub(Tensor self, Tensor other) {
     }
     bool requires_grad = !cten_is_eval() && (orig_self.node != NULL || orig_other.node != NULL);
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = self.data->flex[i] - other.data->flex[i];
-    }
+    ELEMWISE_BINARY(res, self, other, _cten_kernels.sub);
     if(requires_grad) {
         res.node->grad_fn = GradFn_sub;
         res.node->inputs[0] = orig_self;
@@ -452,147 +717,60 @@ Tensor Tensor_sub(Tensor self, Tensor other) {
     return res;
 }
 
-Tensor GradFn_reduce_dim(Tensor self, int i) {
-    Tensor input = self.node->inputs[0];
-    Tensor indices_tensor = self.node->inputs[1];
-    Tensor grad_out = Tensor_zeros(input.shape, false);
-
-    int out_numel = indices_tensor.data->numel;
-    int ndim = TensorShape_dim(input.shape);
-    int reduced_dim = -1;
-
-    for(int d = 0, out_d = 0; d < ndim; d++) {
-        if(out_d >= TensorShape_dim(self.shape) || input.shape[d] != self.shape[out_d]) {
-            reduced_dim = d;
-            break;
-        }
-        out_d++;
-    }
-    cten_assert(reduced_dim != -1, "Could not determine reduced dimension in gradient calculation");
-
-    for(int j = 0; j < out_numel; j++) {
-        int index_along_dim = (int)indices_tensor.data->flex[j];
-
-        int linear_idx = 0, stride = 1, out_j_rem = j,
-            out_shape_idx = TensorShape_dim(self.shape) - 1;
-        for(int k = ndim - 1; k >= 0; --k) {
-            int current_dim_idx;
-            if(k == reduced_dim) {
-                current_dim_idx = index_along_dim;
-            } else {
-                int dim_k = self.shape[out_shape_idx--];
-                current_dim_idx = out_j_rem % dim_k;
-                out_j_rem /= dim_k;
-            }
-            linear_idx += current_dim_idx * stride;
-            stride *= input.shape[k];
-        }
-        grad_out.data->flex[linear_idx] = 1.0f;
-    }
-    return grad_out;
-}
-
 Tensor GradFn_max_all(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_zeros(input.shape, false);
     float max_val = self.data->flex[0];
 
-    int max_count = 0;
-    for(int j = 0; j < input.data->numel; j++) {
+    size_t max_count = 0;
+    for(size_t j = 0; j < input.data->numel; j++) {
         if(input.data->flex[j] == max_val) max_count++;
     }
 
-    float grad_value = (max_count > 0) ? 1.0f / max_count : 0.0f;
-    for(int j = 0; j < input.data->numel; j++) {
+    float grad_value = (max_count > 0) ? 1.0f / (float)max_count : 0.0f;
+    for(size_t j = 0; j < input.data->numel; j++) {
         if(input.data->flex[j] == max_val) res.data->flex[j] = grad_value;
     }
     return res;
 }
 
-Tensor Tensor_max(Tensor self) {
-    if(self.data->numel == 0) { cten_assert(false, "Error: max() on an empty tensor."); }
-    bool requires_grad = !cten_is_eval() && (self.node != NULL);
-    Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, requires_grad);
-
-    float max_val = self.data->flex[0];
-    for(int i = 1; i < self.data->numel; i++) {
-        if(self.data->flex[i] > max_val) { max_val = self.data->flex[i]; }
-    }
-
-    res.data->flex[0] = max_val;
-
-    if(requires_grad) {
-        res.node->grad_fn = GradFn_max_all;
-        res.node->inputs[0] = self;
-        res.node->n_inputs = 1;
-        res.node->name = "MaxAll";
-    }
-
-    return res;
-}
+Tensor Tensor_max(Tensor self) { return Tensor_max_all(self); }
 
 Tensor GradFn_min_all(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_zeros(input.shape, false);
     float min_val = self.data->flex[0];
 
-    int min_count = 0;
-    for(int j = 0; j < input.data->numel; j++) {
+    size_t min_count = 0;
+    for(size_t j = 0; j < input.data->numel; j++) {
         if(input.data->flex[j] == min_val) min_count++;
     }
 
-    float grad_value = (min_count > 0) ? 1.0f / min_count : 0.0f;
-    for(int j = 0; j < input.data->numel; j++) {
+    float grad_value = (min_count > 0) ? 1.0f / (float)min_count : 0.0f;
+    for(size_t j = 0; j < input.data->numel; j++) {
         if(input.data->flex[j] == min_val) res.data->flex[j] = grad_value;
     }
     return res;
 }
 
-Tensor Tensor_min(Tensor self) {
-    if(self.data->numel == 0) { cten_assert(false, "Error: min() on an empty tensor."); }
-    bool requires_grad = !cten_is_eval() && (self.node != NULL);
-    Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, requires_grad);
-
-    // Find minimum value
-    float min_val = self.data->flex[0];
-    for(int i = 1; i < self.data->numel; i++) {
-        if(self.data->flex[i] < min_val) { min_val = self.data->flex[i]; }
-    }
-
-    res.data->flex[0] = min_val;
-
-    if(requires_grad) {
-        res.node->grad_fn = GradFn_min_all;
-        res.node->inputs[0] = self;
-        res.node->n_inputs = 1;
-        res.node->name = "MinAll";
-    }
-
-    return res;
-}
+Tensor Tensor_min(Tensor self) { return Tensor_min_all(self); }
 
 static Tensor GradFn_abs(Tensor self, int i) {
     Tensor input = self.node->inputs[i];
     Tensor res = Tensor_new(input.shape, false);
-    for(int j = 0; j < input.data->numel; j++) {
-        float val = input.data->flex[j];
-        if(val > 0) {
-            res.data->flex[j] = 1.0f;
-        } else if(val < 0) {
-            res.data->flex[j] = -1.0f;
-        } else {
-            res.data->flex[j] = 0.0f;
-        }
-    }
+    _cten_parallel_map(_cten_kernels.abs_grad,
+                       input.data->flex,
+                       res.data->flex,
+                       res.numel,
+                       _CTEN_GRAIN);
     return res;
 }
 
 Tensor Tensor_abs(Tensor self) {
+    self = _cten_as_f32(self);
     bool requires_grad = !cten_is_eval() && self.node != NULL;
     Tensor res = Tensor_new(self.shape, requires_grad);
-    for(int i = 0; i < self.data->numel; i++) {
-        res.data->flex[i] = fabsf(self.data->flex[i]);
-    }
+    _cten_parallel_map(_cten_kernels.abs, self.data->flex, res.data->flex, res.numel, _CTEN_GRAIN);
 
     if(requires_grad) {
         res.node->grad_fn = GradFn_abs;
@@ -41,19 +41,36 @@ optim_adagrad*
 
 void optim_adagrad_zerograd(optim_adagrad* self) { _cten_zero_grad(self->params, self->n_params); }
 
+// Elements [begin, end) of one parameter, split across the thread pool by optim_adagrad_step()
+typedef struct AdagradUpdate {
+    const optim_adagrad* self;
+    float* param;
+    const float* grad;
+    float* sum_sq;
+} AdagradUpdate;
+
+static void adagrad_update(void* ctx, size_t begin, size_t end) {
+    const AdagradUpdate* u = ctx;
+    const optim_adagrad* self = u->self;
+    for(size_t j = begin; j < end; j++) {
+        float g = u->grad[j];
+        if(self->weight_decay > 0.0f) { g += self->weight_decay * u->param[j]; }
+        u->sum_sq[j] += g * g;
+        u->param[j] -= self->lr * g / (sqrtf(u->sum_sq[j]) + self->ε);
+    }
+}
+
 void optim_adagrad_step(optim_adagrad* self) {
     for(int i = 0; i < self->n_params; i++) {
         Tensor t = self->params[i];
         if(t.node == NULL || t.node->grad.data == NULL) continue;
+        _cten_assert_writable("optim_adagrad_step()", t);
+        _cten_mark_modified(t);
 
-        Tensor grad = t.node->grad;
-        Tensor* sum_sq = &self->sum_sq_grad[i];
-
-        for(int j = 0; j < t.data->numel; j++) {
-            float g = grad.data->flex[j];
-            if(self->weight_decay > 0.0f) { g += self->weight_decay * t.data->flex[j]; }
-            sum_sq->data->flex[j] += g * g;
-            t.data->flex[j] -= self->lr * g / (sqrtf(sum_sq->data->flex[j]) + self->ε);
-        }
+        AdagradUpdate u = {self,
+                           t.data->flex,
+                           t.node->grad.data->flex,
+                           self->sum_sq_grad[i].data->flex};
+        _cten_parallel_for(t.data->numel, _CTEN_GRAIN, adagrad_update, &u);
     }
 }
@@ -45,6 +45,7 @@ optim_adam* optim_adam_new(int n_params,
     self->β2 = β2;
     self->ε = ε;
     self->t = 0;
+    self->weight_decay = weight_decay;
 
     self->m = _cten_malloc(sizeof(Tensor) * n_params);
     self->v = _cten_malloc(sizeof(Tensor) * n_params);
@@ -57,24 +58,48 @@ optim_adam* optim_adam_new(int n_params,
 
 void optim_adam_zerograd(optim_adam* self) { _cten_zero_grad(self->params, self->n_params); }
 
+// Elements [begin, end) of one parameter, split across the thread pool by optim_adam_step()
+typedef struct AdamUpdate {
+    const optim_adam* self;
+    float* param;
+    const float* grad;
+    float* m;
+    float* v;
+    float m_correction;  // 1 - β1^t
+    float v_correction;  // 1 - β2^t
+} AdamUpdate;
+
+static void adam_update(void* ctx, size_t begin, size_t end) {
+    const AdamUpdate* u = ctx;
+    const optim_adam* self = u->self;
+    for(size_t j = begin; j < end; j++) {
+        float g = u->grad[j];
+        if(self->weight_decay > 0.0f) { g += self->weight_decay * u->param[j]; }
+        u->m[j] = self->β1 * u->m[j] + (1 - self->β1) * g;
+        u->v[j] = self->β2 * u->v[j] + (1 - self->β2) * g * g;
+        float m_hat = u->m[j] / u->m_correction;
+        float v_hat = u->v[j] / u->v_correction;
+        u->param[j] -= self->lr * m_hat / (sqrtf(v_hat) + self->ε);
+    }
+}
+
 void optim_adam_step(optim_adam* self) {
     self->t++;
     for(int i = 0; i < self->n_params; i++) {
         Tensor p = self->params[i];
         if(p.node == NULL || p.node->grad.data == NULL) continue;
+        _cten_assert_writable("optim_adam_step()", p);
+        _cten_mark_modified(p);
 
-        Tensor grad = p.node->grad;
-        Tensor* m = &self->m[i];
-        Tensor* v = &self->v[i];
-
-        for(int j = 0; j < p.data->numel; j++) {
-            float g = grad.data->flex[j];
-            if(self->weight_decay > 0.0f) { g += self->weight_decay * p.data->flex[j]; }
-            m->data->flex[j] = self->β1 * m->data->flex[j] + (1 - self->β1) * g;
-            v->data->flex[j] = self->β2 * v->data->flex[j] + (1 - self->β2) * g * g;
-            float m_hat = m->data->flex[j] / (1 - powf(self->β1, self->t));
-            float v_hat = v->data->flex[j] / (1 - powf(self->β2, self->t));
-            p.data->flex[j] -= self->lr * m_hat / (sqrtf(v_hat) + self->ε);
-        }
+        AdamUpdate u = {
+            .self = self,
+            .param = p.data->flex,
+            .grad = p.node->grad.data->flex,
+            .m = self->m[i].data->flex,
+            .v = self->v[i].data->flex,
+            .m_correction = 1 - powf(self->β1, self->t),
+            .v_correction = 1 - powf(self->β2, self->t),
+        };
+        _cten_parallel_for(p.data->numel, _CTEN_GRAIN, adam_update, &u);
     }
 }
\ No newline at end of file
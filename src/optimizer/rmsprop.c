@@ -51,19 +51,36 @@ optim_rmsprop* optim_rmsprop_new(int n_params,
 
 void optim_rmsprop_zerograd(optim_rmsprop* self) { _cten_zero_grad(self->params, self->n_params); }
 
+// Elements [begin, end) of one parameter, split across the thread pool by optim_rmsprop_step()
+typedef struct RmspropUpdate {
+    const optim_rmsprop* self;
+    float* param;
+    const float* grad;
+    float* sq_avg;
+} RmspropUpdate;
+
+static void rmsprop_update(void* ctx, size_t begin, size_t end) {
+    const RmspropUpdate* u = ctx;
+    const optim_rmsprop* self = u->self;
+    for(size_t j = begin; j < end; j++) {
+        float g = u->grad[j];
+        if(self->weight_decay > 0.0f) { g += self->weight_decay * u->param[j]; }
+        u->sq_avg[j] = self->β * u->sq_avg[j] + (1 - self->β) * g * g;
+        u->param[j] -= self->lr * g / (sqrtf(u->sq_avg[j]) + self->ε);
+    }
+}
+
 void optim_rmsprop_step(optim_rmsprop* self) {
     for(int i = 0; i < self->n_params; i++) {
         Tensor t = self->params[i];
         if(t.node == NULL || t.node->grad.data == NULL) continue;
+        _cten_assert_writable("optim_rmsprop_step()", t);
+        _cten_mark_modified(t);
 
-        Tensor grad = t.node->grad;
-        Tensor* sq_avg = &self->squared_avg[i];
-
-        for(int j = 0; j < t.data->numel; j++) {
-            float g = grad.data->flex[j];
-            if(self->weight_decay > 0.0f) { g += self->weight_decay * t.data->flex[j]; }
-            sq_avg->data->flex[j] = self->β * sq_avg->data->flex[j] + (1 - self->β) * g * g;
-            t.data->flex[j] -= self->lr * g / (sqrtf(sq_avg->data->flex[j]) + self->ε);
-        }
+        RmspropUpdate u = {self,
+                           t.data->flex,
+                           t.node->grad.data->flex,
+                           self->squared_avg[i].data->flex};
+        _cten_parallel_for(t.data->numel, _CTEN_GRAIN, rmsprop_update, &u);
     }
 }
\ No newline at end of file
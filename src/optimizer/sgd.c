@@ -45,33 +45,52 @@ void optim_sgd_config(optim_sgd* self, float lr, float momentum) {
 
 void optim_sgd_zerograd(optim_sgd* self) { _cten_zero_grad(self->params, self->n_params); }
 
+// Elements [begin, end) of one parameter, split across the thread pool by optim_sgd_step()
+typedef struct SgdUpdate {
+    const optim_sgd* self;
+    float* param;
+    const float* grad;
+    float* velocity;  // NULL without momentum
+} SgdUpdate;
+
+static void sgd_update(void* ctx, size_t begin, size_t end) {
+    const SgdUpdate* u = ctx;
+    const optim_sgd* self = u->self;
+    float* param_data = u->param;
+    const float* grad_data = u->grad;
+    float* velocity_data = u->velocity;
+    if(velocity_data != NULL) {
+        // v = momentum * v + grad
+        // p = p - lr * v
+        for(size_t j = begin; j < end; j++) {
+            float grad_val = grad_data[j];
+            if(self->weight_decay > 0.0f) { grad_val += self->weight_decay * param_data[j]; }
+            velocity_data[j] = self->momentum * velocity_data[j] + grad_val;
+            param_data[j] -= self->lr * velocity_data[j];
+        }
+    } else {
+        // p = p - lr * grad
+        for(size_t j = begin; j < end; j++) {
+            float grad_val = grad_data[j];
+            if(self->weight_decay > 0.0f) { grad_val += self->weight_decay * param_data[j]; }
+            param_data[j] -= self->lr * grad_val;
+        }
+    }
+}
+
 void optim_sgd_step(optim_sgd* self) {
     for(int i = 0; i < self->n_params; i++) {
         Tensor t = self->params[i];
         if(t.node == NULL || t.node->grad.data == NULL) { continue; }
+        _cten_assert_writable("optim_sgd_step()", t);
+        _cten_mark_modified(t);
 
-        float* param_data = t.data->flex;
-        float* grad_data = t.node->grad.data->flex;
-
+        SgdUpdate u = {self, t.data->flex, t.node->grad.data->flex, NULL};
         if(self->momentum > 0.0f) {
-            // v = momentum * v + grad
-            // p = p - lr * v
             cten_assert(self->velocity != NULL,
                         "Velocity buffer is NULL. Did you configure momentum?");
-            float* velocity_data = self->velocity[i].data->flex;
-            for(int j = 0; j < t.data->numel; j++) {
-                float grad_val = grad_data[j];
-                if(self->weight_decay > 0.0f) { grad_val += self->weight_decay * param_data[j]; }
-                velocity_data[j] = self->momentum * velocity_data[j] + grad_val;
-                param_data[j] -= self->lr * velocity_data[j];
-            }
-        } else {
-            // p = p - lr * grad
-            for(int j = 0; j < t.data->numel; j++) {
-                float grad_val = grad_data[j];
-                if(self->weight_decay > 0.0f) { grad_val += self->weight_decay * param_data[j]; }
-                param_data[j] -= self->lr * grad_val;
-            }
+            u.velocity = self->velocity[i].data->flex;
         }
+        _cten_parallel_for(t.data->numel, _CTEN_GRAIN, sgd_update, &u);
     }
 }
\ No newline at end of file
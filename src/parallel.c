@@ -0,0 +1,285 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/* A persistent pool of worker threads for data-parallel loops.
+ *
+ * cten_initilize() starts cten_num_threads() - 1 workers, the calling thread being the last one.
+ * Between loops they sleep on a condition variable. _cten_parallel_for() splits its range into one
+ * contiguous part per thread, wakes the workers, runs the first part itself and waits for the
+ * others. Each part computes exactly what the serial loop computes for its units, so results do
+ * not depend on the thread count. A loop started while another is running (from inside a part, or
+ * from a second thread using the library) runs serially on its caller instead of waiting.
+ *
+ * The loop description and the count of unfinished parts are only touched under the pool mutex,
+ * so the unlock that publishes a loop orders it before every part, and each part's writes before
+ * the caller returns. */
+
+#define POOL_MAX_THREADS 64
+
+#ifdef _WIN32
+#include <windows.h>
+
+typedef CRITICAL_SECTION PoolMutex;
+typedef CONDITION_VARIABLE PoolCond;
+typedef HANDLE PoolThread;
+
+static void mutex_init(PoolMutex* m) { InitializeCriticalSection(m); }
+
+static void mutex_destroy(PoolMutex* m) { DeleteCriticalSection(m); }
+
+static void mutex_lock(PoolMutex* m) { EnterCriticalSection(m); }
+
+static void mutex_unlock(PoolMutex* m) { LeaveCriticalSection(m); }
+
+static void cond_init(PoolCond* c) { InitializeConditionVariable(c); }
+
+static void cond_destroy(PoolCond* c) { (void)c; }
+
+static void cond_wait(PoolCond* c, PoolMutex* m) { SleepConditionVariableCS(c, m, INFINITE); }
+
+static void cond_signal(PoolCond* c) { WakeConditionVariable(c); }
+
+static void cond_broadcast(PoolCond* c) { WakeAllConditionVariable(c); }
+
+static void worker_main(int index);
+
+static DWORD WINAPI worker_entry(LPVOID arg) {
+    worker_main((int)(intptr_t)arg);
+    return 0;
+}
+
+static bool thread_start(PoolThread* t, int index) {
+    *t = CreateThread(NULL, 0, worker_entry, (LPVOID)(intptr_t)index, 0, NULL);
+    return *t != NULL;
+}
+
+static void thread_join(PoolThread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+static int hardware_threads() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t PoolMutex;
+typedef pthread_cond_t PoolCond;
+typedef pthread_t PoolThread;
+
+static void mutex_init(PoolMutex* m) { pthread_mutex_init(m, NULL); }
+
+static void mutex_destroy(PoolMutex* m) { pthread_mutex_destroy(m); }
+
+static void mutex_lock(PoolMutex* m) { pthread_mutex_lock(m); }
+
+static void mutex_unlock(PoolMutex* m) { pthread_mutex_unlock(m); }
+
+static void cond_init(PoolCond* c) { pthread_cond_init(c, NULL); }
+
+static void cond_destroy(PoolCond* c) { pthread_cond_destroy(c); }
+
+static void cond_wait(PoolCond* c, PoolMutex* m) { pthread_cond_wait(c, m); }
+
+static void cond_signal(PoolCond* c) { pthread_cond_signal(c); }
+
+static void cond_broadcast(PoolCond* c) { pthread_cond_broadcast(c); }
+
+static void worker_main(int index);
+
+static void* worker_entry(void* arg) {
+    worker_main((int)(intptr_t)arg);
+    return NULL;
+}
+
+static bool thread_start(PoolThread* t, int index) {
+    return pthread_create(t, NULL, worker_entry, (void*)(intptr_t)index) == 0;
+}
+
+static void thread_join(PoolThread t) { pthread_join(t, NULL); }
+
+static int hardware_threads() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+#endif
+
+typedef struct ThreadPool {
+    PoolMutex lock;
+    PoolCond wake;  // workers wait here for the next loop, or for shutdown
+    PoolCond done;  // the caller waits here for the last part
+    PoolThread workers[POOL_MAX_THREADS];
+    int n_threads;  // workers + the caller
+    bool initialized;
+    bool stop;
+    bool busy;            // a loop is running
+    unsigned generation;  // bumped for every loop
+    int pending;          // parts of the current loop not yet finished
+    // the current loop
+    _cten_RangeFn fn;
+    void* ctx;
+    size_t n;
+    int n_parts;
+} ThreadPool;
+
+static ThreadPool g_pool = {.n_threads = 1};
+
+// Part `k` of `n_parts` covering [0, n)
+static void run_part(_cten_RangeFn fn, void* ctx, size_t n, int k, int n_parts) {
+    size_t begin = n * k / n_parts;
+    size_t end = n * (k + 1) / n_parts;
+    if(begin < end) fn(ctx, begin, end);
+}
+
+static void worker_main(int index) {
+    unsigned seen = 0;
+    mutex_lock(&g_pool.lock);
+    for(;;) {
+        while(!g_pool.stop && g_pool.generation == seen) {
+            cond_wait(&g_pool.wake, &g_pool.lock);
+        }
+        if(g_pool.stop) break;
+        seen = g_pool.generation;
+        if(index >= g_pool.n_parts) continue;
+        _cten_RangeFn fn = g_pool.fn;
+        void* ctx = g_pool.ctx;
+        size_t n = g_pool.n;
+        int n_parts = g_pool.n_parts;
+        mutex_unlock(&g_pool.lock);
+        run_part(fn, ctx, n, index, n_parts);
+        mutex_lock(&g_pool.lock);
+        if(--g_pool.pending == 0) cond_signal(&g_pool.done);
+    }
+    mutex_unlock(&g_pool.lock);
+}
+
+static void stop_workers() {
+    mutex_lock(&g_pool.lock);
+    g_pool.stop = true;
+    cond_broadcast(&g_pool.wake);
+    mutex_unlock(&g_pool.lock);
+    for(int i = 1; i < g_pool.n_threads; i++) {
+        thread_join(g_pool.workers[i]);
+    }
+    g_pool.stop = false;
+    g_pool.n_threads = 1;
+}
+
+int cten_set_num_threads(int n) {
+    if(n <= 0) n = hardware_threads();
+    if(n > POOL_MAX_THREADS) n = POOL_MAX_THREADS;
+    if(!g_pool.initialized) {
+        mutex_init(&g_pool.lock);
+        cond_init(&g_pool.wake);
+        cond_init(&g_pool.done);
+        g_pool.initialized = true;
+    }
+    cten_assert(!g_pool.busy, "cten_set_num_threads() called while a parallel loop is running");
+    if(n == g_pool.n_threads) return n;
+    stop_workers();
+    // workers start with the current generation already seen, so none runs a stale loop
+    g_pool.generation = 0;
+    for(int i = 1; i < n; i++) {
+        cten_assert(thread_start(&g_pool.workers[i], i), "failed to start worker thread %d", i);
+        g_pool.n_threads = i + 1;
+    }
+    return g_pool.n_threads;
+}
+
+int cten_num_threads() { return g_pool.n_threads; }
+
+void _cten_threads_init() {
+    int n = 0;
+    const char* env = getenv("CTEN_NUM_THREADS");
+    if(env != NULL && env[0] != '\0') {
+        char* end;
+        n = (int)strtol(env, &end, 10);
+        cten_assert(*end == '\0' && n >= 0, "CTEN_NUM_THREADS: expected a count, got '%s'", env);
+    }
+    cten_set_num_threads(n);
+}
+
+void _cten_threads_shutdown() {
+    if(!g_pool.initialized) return;
+    stop_workers();
+    cond_destroy(&g_pool.done);
+    cond_destroy(&g_pool.wake);
+    mutex_destroy(&g_pool.lock);
+    g_pool.initialized = false;
+}
+
+void _cten_parallel_for(size_t n, size_t grain, _cten_RangeFn fn, void* ctx) {
+    size_t n_parts = grain > 1 ? n / grain : n;
+    if(n_parts > (size_t)g_pool.n_threads) n_parts = g_pool.n_threads;
+    if(n_parts <= 1) {
+        if(n > 0) fn(ctx, 0, n);
+        return;
+    }
+    mutex_lock(&g_pool.lock);
+    if(g_pool.busy) {
+        mutex_unlock(&g_pool.lock);
+        fn(ctx, 0, n);
+        return;
+    }
+    g_pool.busy = true;
+    g_pool.fn = fn;
+    g_pool.ctx = ctx;
+    g_pool.n = n;
+    g_pool.n_parts = (int)n_parts;
+    g_pool.pending = (int)n_parts - 1;
+    g_pool.generation++;
+    cond_broadcast(&g_pool.wake);
+    mutex_unlock(&g_pool.lock);
+
+    run_part(fn, ctx, n, 0, (int)n_parts);
+
+    mutex_lock(&g_pool.lock);
+    while(g_pool.pending > 0) {
+        cond_wait(&g_pool.done, &g_pool.lock);
+    }
+    g_pool.busy = false;
+    mutex_unlock(&g_pool.lock);
+}
+
+typedef struct MapTask {
+    void (*unary)(const float* x, float* out, size_t n);
+    void (*binary)(const float* x, const float* y, float* out, size_t n);
+    const float* x;
+    const float* y;
+    float* out;
+} MapTask;
+
+static void map_range(void* ctx, size_t begin, size_t end) {
+    const MapTask* t = ctx;
+    if(t->unary != NULL) {
+        t->unary(t->x + begin, t->out + begin, end - begin);
+    } else {
+        t->binary(t->x + begin, t->y + begin, t->out + begin, end - begin);
+    }
+}
+
+void _cten_parallel_map(void (*kernel)(const float* x, float* out, size_t n),
+                        const float* x,
+                        float* out,
+                        size_t n,
+                        size_t grain) {
+    MapTask t = {.unary = kernel, .x = x, .out = out};
+    _cten_parallel_for(n, grain, map_range, &t);
+}
+
+void _cten_parallel_zip(void (*kernel)(const float* x, const float* y, float* out, size_t n),
+                        const float* x,
+                        const float* y,
+                        float* out,
+                        size_t n,
+                        size_t grain) {
+    MapTask t = {.binary = kernel, .x = x, .y = y, .out = out};
+    _cten_parallel_for(n, grain, map_range, &t);
+}
@@ -1,47 +1,62 @@
 #include "cten.h"
+#include "cten_internal.h"
 
 #include "common/vector.h"
 #include <stddef.h>
 
-typedef struct {
+struct PoolAllocator {
     c11_vector /*PoolId*/ stack;
     c11_vector /*void_p*/ pointers;
     c11_vector /*void_p*/ pointers_swap_buffer;
-} PoolAllocator;
-
-static PoolAllocator g_allocator;
+};
 
 void cten_initilize() {
-    c11_vector__ctor(&g_allocator.stack, sizeof(PoolId));
-    c11_vector__ctor(&g_allocator.pointers, sizeof(void*));
-    c11_vector__ctor(&g_allocator.pointers_swap_buffer, sizeof(void*));
+    _cten_context_init();
+    _cten_simd_init();
+    _cten_threads_init();
 }
 
 void cten_finalize() {
-    for(int i = 0; i < g_allocator.pointers.length; i++) {
-        void* p = c11__getitem(void*, &g_allocator.pointers, i);
+    _cten_threads_shutdown();
+    _cten_context_shutdown();
+}
+
+PoolAllocator* _cten_pools_new() {
+    PoolAllocator* self = malloc(sizeof(PoolAllocator));
+    cten_assert(self != NULL, "out of memory allocating a pool allocator");
+    c11_vector__ctor(&self->stack, sizeof(PoolId));
+    c11_vector__ctor(&self->pointers, sizeof(void*));
+    c11_vector__ctor(&self->pointers_swap_buffer, sizeof(void*));
+    return self;
+}
+
+void _cten_pools_free(PoolAllocator* self) {
+    for(int i = 0; i < self->pointers.length; i++) {
+        void* p = c11__getitem(void*, &self->pointers, i);
         free(p);
     }
-    assert(g_allocator.pointers_swap_buffer.length == 0);
-    c11_vector__dtor(&g_allocator.stack);
-    c11_vector__dtor(&g_allocator.pointers);
-    c11_vector__dtor(&g_allocator.pointers_swap_buffer);
+    assert(self->pointers_swap_buffer.length == 0);
+    c11_vector__dtor(&self->stack);
+    c11_vector__dtor(&self->pointers);
+    c11_vector__dtor(&self->pointers_swap_buffer);
+    free(self);
 }
 
 void cten_begin_malloc(PoolId id) {
-    c11_vector* self = &g_allocator.stack;
+    c11_vector* self = &_cten_current_pools()->stack;
     c11_vector__push(PoolId, self, id);
 }
 
 void cten_end_malloc() {
-    c11_vector* self = &g_allocator.stack;
+    c11_vector* self = &_cten_current_pools()->stack;
     assert(self->length > 0);
     c11_vector__pop(self);
 }
 
 void cten_free(PoolId id) {
-    c11_vector* pointers = &g_allocator.pointers;
-    c11_vector* swap_buffer = &g_allocator.pointers_swap_buffer;
+    PoolAllocator* pools = _cten_current_pools();
+    c11_vector* pointers = &pools->pointers;
+    c11_vector* swap_buffer = &pools->pointers_swap_buffer;
     for(int i = 0; i < pointers->length; i++) {
         void* p = c11__getitem(void*, pointers, i);
         if(((PoolId*)p)[0] == id) {
@@ -55,9 +70,10 @@ void cten_free(PoolId id) {
 }
 
 void* _cten_malloc(size_t size) {
-    assert(g_allocator.stack.length > 0);
-    PoolId id = c11_vector__back(PoolId, &g_allocator.stack);
-    c11_vector* pointers = &g_allocator.pointers;
+    PoolAllocator* pools = _cten_current_pools();
+    assert(pools->stack.length > 0);
+    PoolId id = c11_vector__back(PoolId, &pools->stack);
+    c11_vector* pointers = &pools->pointers;
     void* p = malloc(sizeof(PoolId) + size);
     assert(p != NULL);
     ((PoolId*)p)[0] = id;
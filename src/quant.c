@@ -0,0 +1,166 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+typedef struct nn_qlinear {
+    int in_features;
+    int out_features;
+    float in_scale;
+    int in_zero_point;
+    int8_t* weight;      // [out_features, in_features], one row per output channel
+    int32_t* weight_sum; // per-channel sum of `weight`, folds the input zero point out of the GEMM
+    float* scale;        // in_scale * per-channel weight scale
+    float* bias;
+} nn_qlinear;
+
+// The int32 accumulator holds |x - zp| <= 255 times |w| <= 127 summed over in_features terms.
+#define QLINEAR_MAX_IN_FEATURES (INT32_MAX / (255 * 127))
+
+static inline int8_t quantize(float x, float inv_scale, int zero_point, int lo) {
+    float v = x * inv_scale + (float)zero_point;
+    v = v < (float)lo ? (float)lo : v;
+    v = v > 127.0f ? 127.0f : v;
+    return (int8_t)(v >= 0.0f ? v + 0.5f : v - 0.5f);
+}
+
+// Four output channels per pass share each widened input load; the int16 x int8 products fit
+// the multiply-add instructions compilers emit for these reductions.
+static inline void dot4_s8(const int16_t* x, const int8_t* w, int n, int32_t* acc) {
+    const int8_t *w0 = w, *w1 = w + n, *w2 = w + 2 * n, *w3 = w + 3 * n;
+    int32_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    for(int k = 0; k < n; k++) {
+        a0 += x[k] * w0[k];
+        a1 += x[k] * w1[k];
+        a2 += x[k] * w2[k];
+        a3 += x[k] * w3[k];
+    }
+    acc[0] = a0;
+    acc[1] = a1;
+    acc[2] = a2;
+    acc[3] = a3;
+}
+
+static inline int32_t dot_s8(const int16_t* x, const int8_t* w, int n) {
+    int32_t acc = 0;
+    for(int k = 0; k < n; k++) {
+        acc += x[k] * w[k];
+    }
+    return acc;
+}
+
+nn_qrange nn_qrange_new() { return (nn_qrange){INFINITY, -INFINITY}; }
+
+void nn_qrange_observe(nn_qrange* self, Tensor x) {
+    float block[_CTEN_LOAD_BLOCK];
+    for(size_t i = 0; i < x.numel; i += _CTEN_LOAD_BLOCK) {
+        size_t n = x.numel - i < _CTEN_LOAD_BLOCK ? x.numel - i : _CTEN_LOAD_BLOCK;
+        const float* v = _cten_load_f32(x.data, i, n, block);
+        for(size_t j = 0; j < n; j++) {
+            self->min_val = fminf(self->min_val, v[j]);
+            self->max_val = fmaxf(self->max_val, v[j]);
+        }
+    }
+}
+
+nn_qlinear* nn_qlinear_new(Tensor weight, Tensor bias, nn_qrange input_range) {
+    cten_assert(weight.ndim == 2,
+                "nn_qlinear_new: weight must be 2D [in, out], got %dD",
+                weight.ndim);
+    int in = weight.shape[0];
+    int out = weight.shape[1];
+    cten_assert(in <= QLINEAR_MAX_IN_FEATURES,
+                "nn_qlinear_new: in_features %d would overflow the int32 accumulator",
+                in);
+    cten_assert(bias.numel == (size_t)out,
+                "nn_qlinear_new: bias has %zu elements, expected %d",
+                bias.numel,
+                out);
+    cten_assert(input_range.min_val <= input_range.max_val,
+                "nn_qlinear_new: input range is empty, run a calibration pass first");
+    weight = _cten_as_f32(weight);
+    bias = _cten_as_f32(bias);
+
+    nn_qlinear* self = _cten_malloc(sizeof(nn_qlinear));
+    self->in_features = in;
+    self->out_features = out;
+    self->weight = _cten_malloc(sizeof(int8_t) * in * out);
+    self->weight_sum = _cten_malloc(sizeof(int32_t) * out);
+    self->scale = _cten_malloc(sizeof(float) * out);
+    self->bias = _cten_malloc(sizeof(float) * out);
+    memcpy(self->bias, bias.data->flex, sizeof(float) * out);
+
+    // asymmetric input quantization; the range is widened to contain 0 so zeros stay exact
+    float lo = fminf(input_range.min_val, 0.0f);
+    float hi = fmaxf(input_range.max_val, 0.0f);
+    self->in_scale = hi > lo ? (hi - lo) / 255.0f : 1.0f;
+    int zp = (int)lrintf(-128.0f - lo / self->in_scale);
+    self->in_zero_point = zp < -128 ? -128 : (zp > 127 ? 127 : zp);
+
+    // symmetric per-output-channel weight quantization
+    const float* w = weight.data->flex;
+    for(int j = 0; j < out; j++) {
+        float amax = 0.0f;
+        for(int k = 0; k < in; k++) {
+            amax = fmaxf(amax, fabsf(w[(size_t)k * out + j]));
+        }
+        float w_scale = amax > 0.0f ? amax / 127.0f : 1.0f;
+        int8_t* row = self->weight + (size_t)j * in;
+        int32_t sum = 0;
+        for(int k = 0; k < in; k++) {
+            row[k] = quantize(w[(size_t)k * out + j], 1.0f / w_scale, 0, -127);
+            sum += row[k];
+        }
+        self->weight_sum[j] = sum;
+        self->scale[j] = self->in_scale * w_scale;
+    }
+    return self;
+}
+
+Tensor nn_qlinear_forward(nn_qlinear* self, Tensor input) {
+    int in = self->in_features;
+    int out = self->out_features;
+    cten_assert(input.ndim >= 1 && input.shape[input.ndim - 1] == in,
+                "nn_qlinear_forward: input last dimension must be %d",
+                in);
+    input = _cten_as_f32(input);
+
+    TensorShape res_shape;
+    memcpy(res_shape, input.shape, sizeof(TensorShape));
+    res_shape[input.ndim - 1] = out;
+    Tensor res = Tensor_new(res_shape, false);
+
+    size_t rows = input.numel / in;
+    float inv_scale = 1.0f / self->in_scale;
+    int zp = self->in_zero_point;
+    int16_t* xq = _cten_malloc(sizeof(int16_t) * in);
+    for(size_t i = 0; i < rows; i++) {
+        const float* x = input.data->flex + i * in;
+        for(int k = 0; k < in; k++) {
+            xq[k] = quantize(x[k], inv_scale, zp, -128);
+        }
+        // fused requantize: y = scale * (sum(xq * wq) - zp * sum(wq)) + bias
+        float* y = res.data->flex + i * out;
+        int32_t acc[4];
+        int j = 0;
+        for(; j + 4 <= out; j += 4) {
+            dot4_s8(xq, self->weight + (size_t)j * in, in, acc);
+            for(int c = 0; c < 4; c++) {
+                int32_t a = acc[c] - zp * self->weight_sum[j + c];
+                y[j + c] = (float)a * self->scale[j + c] + self->bias[j + c];
+            }
+        }
+        for(; j < out; j++) {
+            int32_t a = dot_s8(xq, self->weight + (size_t)j * in, in) - zp * self->weight_sum[j];
+            y[j] = (float)a * self->scale[j] + self->bias[j];
+        }
+    }
+    return res;
+}
+
+size_t nn_qlinear_nbytes(nn_qlinear* self) {
+    size_t per_channel = sizeof(int32_t) + 2 * sizeof(float);
+    return sizeof(nn_qlinear) + (size_t)self->in_features * self->out_features +
+           per_channel * self->out_features;
+}
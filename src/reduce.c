@@ -0,0 +1,413 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Reductions over any set of axes.
+ *
+ * The input is seen as runs of adjacent axes that are all kept or all reduced, each run merged
+ * into a single axis and size-1 axes dropped, so every reduction is a loop nest over at most
+ * CTEN_MAX_DIMS runs with plain strides. The innermost run is contiguous in the input: when it is
+ * kept, a row of inputs combines into a row of outputs through the vector kernels, and when it is
+ * reduced, each row folds into one output through a horizontal kernel. Backward walks the same
+ * runs. */
+
+#define REDUCE_BLOCK 256
+
+// Runs from the innermost (run 0) outwards. Kept runs step through the output, reduced runs
+// through the reduced axes flattened in row-major order.
+typedef struct ReducePlan {
+    int n_runs;
+    bool reduced[CTEN_MAX_DIMS];
+    size_t size[CTEN_MAX_DIMS];
+    size_t in_stride[CTEN_MAX_DIMS];
+    size_t out_stride[CTEN_MAX_DIMS];  // 0 on reduced runs
+    size_t red_stride[CTEN_MAX_DIMS];  // 0 on kept runs
+    size_t out_numel, red_numel;
+} ReducePlan;
+
+static void plan_reduce(const int* shape, int ndim, int axes, ReducePlan* p) {
+    memset(p, 0, sizeof(*p));
+    size_t in_stride = 1, out_stride = 1, red_stride = 1;
+    for(int d = ndim - 1; d >= 0; d--) {
+        size_t size = shape[d];
+        bool reduced = (axes >> d) & 1;
+        if(size == 1) continue;
+        int r = p->n_runs;
+        if(r > 0 && p->reduced[r - 1] == reduced) {
+            p->size[r - 1] *= size;
+        } else {
+            p->reduced[r] = reduced;
+            p->size[r] = size;
+            p->in_stride[r] = in_stride;
+            p->out_stride[r] = reduced ? 0 : out_stride;
+            p->red_stride[r] = reduced ? red_stride : 0;
+            p->n_runs++;
+        }
+        in_stride *= size;
+        if(reduced) {
+            red_stride *= size;
+        } else {
+            out_stride *= size;
+        }
+    }
+    if(p->n_runs == 0) {
+        // a single element
+        p->n_runs = 1;
+        p->size[0] = p->in_stride[0] = p->out_stride[0] = 1;
+    }
+    p->out_numel = out_stride;
+    p->red_numel = red_stride;
+}
+
+// Input offset of the element at flattened reduced position `red` of output `out`
+static size_t plan_offset(const ReducePlan* p, size_t out, size_t red) {
+    size_t in = 0;
+    for(int r = 0; r < p->n_runs; r++) {
+        size_t pos = p->reduced[r] ? red / p->red_stride[r] : out / p->out_stride[r];
+        in += pos % p->size[r] * p->in_stride[r];
+    }
+    return in;
+}
+
+typedef struct ReduceArgs {
+    const float* x;
+    const float* y;  // per-output values: the maximum for logsumexp, the result in backward
+    const float* g;  // upstream gradient, in backward
+    float* out;      // per-output accumulators, or the input gradient in backward
+    int32_t* idx;    // positions of the extremes within the reduced axes, or NULL
+    bool is_min;
+    float s;         // d out / dx of sum and mean
+} ReduceArgs;
+
+// Handles the innermost run, p->size[0] elements from input offset `in`: one output at `out` and
+// positions from `red` when the run is reduced, outputs from `out` at position `red` when kept.
+typedef void (*ReduceRow)(const ReducePlan* p,
+                          const ReduceArgs* a,
+                          size_t in,
+                          size_t out,
+                          size_t red);
+
+static void walk(const ReducePlan* p,
+                 int r,
+                 ReduceRow row,
+                 const ReduceArgs* a,
+                 size_t in,
+                 size_t out,
+                 size_t red) {
+    if(r == 0) {
+        row(p, a, in, out, red);
+        return;
+    }
+    for(size_t j = 0; j < p->size[r]; j++) {
+        walk(p,
+             r - 1,
+             row,
+             a,
+             in + j * p->in_stride[r],
+             out + j * p->out_stride[r],
+             red + j * p->red_stride[r]);
+    }
+}
+
+typedef struct WalkTask {
+    const ReducePlan* p;
+    ReduceRow row;
+    const ReduceArgs* a;
+} WalkTask;
+
+// Slices [begin, end) of the outermost run, which is kept
+static void walk_slices(void* ctx, size_t begin, size_t end) {
+    const WalkTask* t = ctx;
+    const ReducePlan* p = t->p;
+    int r = p->n_runs - 1;
+    for(size_t j = begin; j < end; j++) {
+        walk(p, r - 1, t->row, t->a, j * p->in_stride[r], j * p->out_stride[r], 0);
+    }
+}
+
+// Elements [begin, end) of every row of the innermost run, which is kept
+static void walk_columns(void* ctx, size_t begin, size_t end) {
+    const WalkTask* t = ctx;
+    ReducePlan p = *t->p;
+    p.size[0] = end - begin;
+    walk(&p, p.n_runs - 1, t->row, t->a, begin, begin, 0);
+}
+
+// walk() over the whole input, split across the thread pool where outputs are independent: by
+// slices of the outermost run when it is kept, otherwise by columns of a kept innermost run. A
+// plan with neither folds everything into one output and stays serial. `grain` counts input
+// elements per thread.
+static void walk_all(const ReducePlan* p, ReduceRow row, const ReduceArgs* a, size_t grain) {
+    WalkTask t = {p, row, a};
+    int r = p->n_runs - 1;
+    size_t numel = p->in_stride[r] * p->size[r];
+    if(r > 0 && !p->reduced[r]) {
+        size_t slice = p->in_stride[r];
+        _cten_parallel_for(p->size[r], slice >= grain ? 1 : grain / slice, walk_slices, &t);
+    } else if(!p->reduced[0]) {
+        // columns narrower than this would leave the kernels too little to vectorize
+        size_t rows = numel / p->size[0], min_columns = 16;
+        size_t columns = rows >= grain ? 1 : grain / rows;
+        if(columns < min_columns) columns = min_columns;
+        _cten_parallel_for(p->size[0], columns, walk_columns, &t);
+    } else {
+        walk(p, r, row, a, 0, 0, 0);
+    }
+}
+
+static void sum_row(const ReducePlan* p, const ReduceArgs* a, size_t in, size_t out, size_t red) {
+    (void)red;
+    if(p->reduced[0]) {
+        a->out[out] += _cten_kernels.reduce_sum(a->x + in, p->size[0]);
+    } else {
+        _cten_kernels.add(a->out + out, a->x + in, a->out + out, p->size[0]);
+    }
+}
+
+// Rows arrive in increasing reduced position and only a strictly better value replaces the
+// current one, so ties keep the first position.
+static void extreme_row(const ReducePlan* p,
+                        const ReduceArgs* a,
+                        size_t in,
+                        size_t out,
+                        size_t red) {
+    const float* x = a->x + in;
+    float* best = a->out + out;
+    size_t n = p->size[0];
+    if(p->reduced[0] && a->idx != NULL) {
+        size_t j;
+        float v = a->is_min ? _cten_kernels.reduce_min_index(x, n, &j)
+                            : _cten_kernels.reduce_max_index(x, n, &j);
+        if(a->is_min ? v < best[0] : v > best[0]) {
+            best[0] = v;
+            a->idx[out] = (int32_t)(red + j);
+        }
+    } else if(p->reduced[0]) {
+        float v = a->is_min ? _cten_kernels.reduce_min(x, n) : _cten_kernels.reduce_max(x, n);
+        if(a->is_min ? v < best[0] : v > best[0]) best[0] = v;
+    } else if(a->idx != NULL) {
+        int32_t* idx = a->idx + out;
+        if(a->is_min) {
+            _cten_kernels.min_index(x, best, idx, (int32_t)red, n);
+        } else {
+            _cten_kernels.max_index(x, best, idx, (int32_t)red, n);
+        }
+    } else if(a->is_min) {
+        _cten_kernels.min(x, best, best, n);
+    } else {
+        _cten_kernels.max(x, best, best, n);
+    }
+}
+
+// Accumulates exp(x - max), a block at a time
+static void logsumexp_row(const ReducePlan* p,
+                          const ReduceArgs* a,
+                          size_t in,
+                          size_t out,
+                          size_t red) {
+    (void)red;
+    float buf[REDUCE_BLOCK];
+    const float* x = a->x + in;
+    size_t n = p->size[0];
+    for(size_t j = 0; j < n; j += REDUCE_BLOCK) {
+        size_t m = n - j < REDUCE_BLOCK ? n - j : REDUCE_BLOCK;
+        if(p->reduced[0]) {
+            for(size_t k = 0; k < m; k++) {
+                buf[k] = x[j + k] - a->y[out];
+            }
+            _cten_kernels.exp(buf, buf, m);
+            a->out[out] += _cten_kernels.reduce_sum(buf, m);
+        } else {
+            _cten_kernels.sub(x + j, a->y + out + j, buf, m);
+            _cten_kernels.exp(buf, buf, m);
+            _cten_kernels.add(a->out + out + j, buf, a->out + out + j, m);
+        }
+    }
+}
+
+static void sum_grad_row(const ReducePlan* p,
+                         const ReduceArgs* a,
+                         size_t in,
+                         size_t out,
+                         size_t red) {
+    (void)red;
+    float* gx = a->out + in;
+    size_t n = p->size[0];
+    if(p->reduced[0]) {
+        float v = a->s * a->g[out];
+        for(size_t j = 0; j < n; j++) {
+            gx[j] = v;
+        }
+    } else {
+        _cten_kernels.scale(a->g + out, a->s, gx, n);
+    }
+}
+
+// d logsumexp(x) / dx = exp(x - logsumexp(x)), the softmax over the reduced axes
+static void logsumexp_grad_row(const ReducePlan* p,
+                               const ReduceArgs* a,
+                               size_t in,
+                               size_t out,
+                               size_t red) {
+    (void)red;
+    const float* x = a->x + in;
+    float* gx = a->out + in;
+    size_t n = p->size[0];
+    if(p->reduced[0]) {
+        for(size_t j = 0; j < n; j++) {
+            gx[j] = x[j] - a->y[out];
+        }
+        _cten_kernels.exp(gx, gx, n);
+        _cten_kernels.scale(gx, a->g[out], gx, n);
+    } else {
+        _cten_kernels.sub(x, a->y + out, gx, n);
+        _cten_kernels.exp(gx, gx, n);
+        _cten_kernels.mul(gx, a->g + out, gx, n);
+    }
+}
+
+static void fill(float* x, float v, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        x[i] = v;
+    }
+}
+
+Tensor _cten_reduce(Tensor self,
+                    TensorReduceOp op,
+                    int axes,
+                    bool keepdim,
+                    bool requires_grad,
+                    Tensor* indices) {
+    ReducePlan p;
+    plan_reduce(self.shape, self.ndim, axes, &p);
+
+    TensorShape out_shape = {0};
+    int out_ndim = 0;
+    for(int d = 0; d < self.ndim; d++) {
+        if(!((axes >> d) & 1)) {
+            out_shape[out_ndim++] = self.shape[d];
+        } else if(keepdim) {
+            out_shape[out_ndim++] = 1;
+        }
+    }
+    if(out_ndim == 0) out_shape[0] = 1;
+
+    bool argmax = op == TensorReduceOp_ArgMax;
+    Tensor res = Tensor_new(out_shape, requires_grad && !argmax);
+    ReduceArgs a = {.x = self.data->flex, .out = res.data->flex};
+    switch(op) {
+        case TensorReduceOp_Sum:
+        case TensorReduceOp_Mean:
+            fill(a.out, 0.0f, p.out_numel);
+            walk_all(&p, sum_row, &a, _CTEN_GRAIN);
+            if(op == TensorReduceOp_Mean) {
+                _cten_kernels.scale(a.out, 1.0f / (float)p.red_numel, a.out, p.out_numel);
+            }
+            return res;
+        case TensorReduceOp_Max:
+        case TensorReduceOp_Min:
+        case TensorReduceOp_ArgMax: {
+            Tensor idx = _cten_new_dtype(out_shape, TensorDType_I32);
+            memset(idx.data->flexi, 0, sizeof(int32_t) * p.out_numel);
+            a.idx = argmax || indices != NULL ? idx.data->flexi : NULL;
+            a.is_min = op == TensorReduceOp_Min;
+            fill(a.out, a.is_min ? INFINITY : -INFINITY, p.out_numel);
+            walk_all(&p, extreme_row, &a, _CTEN_GRAIN);
+            if(indices != NULL) *indices = idx;
+            return argmax ? idx : res;
+        }
+        case TensorReduceOp_LogSumExp: {
+            // max + log(sum(exp(x - max))), which cannot overflow; infinite maxima pass through
+            Tensor max = Tensor_new(out_shape, false);
+            a.out = max.data->flex;
+            fill(a.out, -INFINITY, p.out_numel);
+            walk_all(&p, extreme_row, &a, _CTEN_GRAIN);
+
+            float* y = res.data->flex;
+            a.out = y;
+            a.y = max.data->flex;
+            fill(y, 0.0f, p.out_numel);
+            walk_all(&p, logsumexp_row, &a, _CTEN_GRAIN_MATH);
+            _cten_kernels.log(y, y, p.out_numel);
+            _cten_kernels.add(y, a.y, y, p.out_numel);
+            for(size_t i = 0; i < p.out_numel; i++) {
+                if(isinf(a.y[i])) y[i] = a.y[i];
+            }
+            return res;
+        }
+    }
+    cten_assert(false, "Tensor_reduce(): unknown op %d", (int)op);
+    return res;
+}
+
+static Tensor GradFn_reduce(Tensor self, int i) {
+    (void)i;
+    Tensor input = self.node->inputs[0];
+    TensorReduceOp op = (TensorReduceOp)self.node->params[0];
+    ReducePlan p;
+    plan_reduce(input.shape, input.ndim, self.node->params[1], &p);
+
+    Tensor res = Tensor_new(input.shape, false);
+    ReduceArgs a = {
+        .x = input.data->flex,
+        .y = self.data->flex,
+        .g = self.node->grad.data->flex,
+        .out = res.data->flex,
+    };
+    switch(op) {
+        case TensorReduceOp_Max:
+        case TensorReduceOp_Min: {
+            // the upstream gradient goes to the position that won, nothing elsewhere
+            const int32_t* idx = self.node->inputs[1].data->flexi;
+            memset(a.out, 0, sizeof(float) * res.numel);
+            for(size_t o = 0; o < p.out_numel; o++) {
+                a.out[plan_offset(&p, o, (size_t)idx[o])] += a.g[o];
+            }
+            break;
+        }
+        case TensorReduceOp_LogSumExp:
+            walk_all(&p, logsumexp_grad_row, &a, _CTEN_GRAIN_MATH);
+            break;
+        default:
+            a.s = op == TensorReduceOp_Mean ? 1.0f / (float)p.red_numel : 1.0f;
+            walk_all(&p, sum_grad_row, &a, _CTEN_GRAIN);
+            break;
+    }
+    return res;
+}
+
+Tensor _cten_reduce_autograd(Tensor self,
+                             TensorReduceOp op,
+                             int axes,
+                             bool keepdim,
+                             Tensor* indices) {
+    bool extreme = op == TensorReduceOp_Max || op == TensorReduceOp_Min;
+    bool requires_grad = !cten_is_eval() && self.node != NULL && op != TensorReduceOp_ArgMax;
+    Tensor idx = {0};
+    bool want_indices = indices != NULL || (requires_grad && extreme);
+    Tensor res = _cten_reduce(self, op, axes, keepdim, requires_grad, want_indices ? &idx : NULL);
+    if(requires_grad) {
+        res.node->grad_fn = GradFn_reduce;
+        res.node->inputs[0] = self;
+        res.node->inputs[1] = idx;
+        res.node->n_inputs = extreme ? 2 : 1;
+        res.node->params[0] = op;
+        res.node->params[1] = axes;
+        res.node->name = "Reduce";
+    }
+    if(indices != NULL) *indices = idx;
+    return res;
+}
+
+Tensor Tensor_reduce(Tensor self, TensorReduceOp op, const int* dims, int n_dims, bool keepdim) {
+    self = _cten_as_f32(self);
+    int axes = n_dims == 0 ? (1 << self.ndim) - 1 : 0;
+    for(int k = 0; k < n_dims; k++) {
+        int d = TensorShape_asdim(self.shape, dims[k]);
+        cten_assert(!((axes >> d) & 1), "Tensor_reduce(): dim %d listed twice", dims[k]);
+        axes |= 1 << d;
+    }
+    return _cten_reduce_autograd(self, op, axes, keepdim, NULL);
+}
@@ -0,0 +1,1055 @@
+#include "cten.h"
+#include "cten_internal.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Elementwise kernels behind a dispatch table.
+ *
+ * Every kernel has a portable loop, and x86-64 builds add SSE2, AVX2 and AVX-512 versions compiled
+ * for their instruction set with target attributes, so one binary runs everywhere and still uses
+ * the widest vectors the CPU has. cten_initilize() picks the level from CPUID; the CTEN_SIMD
+ * environment variable (scalar, sse2, avx2 or avx512) lowers it, e.g. to test the narrower paths
+ * on a wider machine. The vector kernels only use correctly rounded operations, so every level
+ * computes the same elementwise results as the portable loops; sums and dot products add in an
+ * order that depends on the vector width, so they may differ in the last bits between levels.
+ *
+ * exp, log and the activations built on them have two accuracy modes. Precise calls the C library
+ * one value at a time; Fast evaluates the polynomials below with the same operations at every
+ * level, so they vectorize and never reach libm. Where the target has FMA the compiler may fuse
+ * their multiply-adds, so levels can differ in the last bit. */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIMD_TARGET(isa)
+#define SIMD_NOINLINE __declspec(noinline)
+#else
+#include <immintrin.h>
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#define SIMD_NOINLINE __attribute__((noinline))
+#endif
+#else
+#define SIMD_NOINLINE
+#endif
+
+/* Portable loops, which also finish the ragged tails of the vector kernels */
+
+static void add_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] + y[i];
+    }
+}
+
+static void sub_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] - y[i];
+    }
+}
+
+static void mul_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] * y[i];
+    }
+}
+
+static void div_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] / y[i];
+    }
+}
+
+static void max_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > y[i] ? x[i] : y[i];
+    }
+}
+
+static void min_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] < y[i] ? x[i] : y[i];
+    }
+}
+
+static void max_index_scalar(const float* x, float* best, int32_t* idx, int32_t pos, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        if(x[i] > best[i]) {
+            best[i] = x[i];
+            idx[i] = pos;
+        }
+    }
+}
+
+static void min_index_scalar(const float* x, float* best, int32_t* idx, int32_t pos, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        if(x[i] < best[i]) {
+            best[i] = x[i];
+            idx[i] = pos;
+        }
+    }
+}
+
+/* Sums and dot products add blocks of PAIRWISE_BLOCK elements with several independent
+ * accumulators and then the block results pairwise, so the rounding error grows with log n rather
+ * than n and no add waits on the previous one. The split points depend only on n, so a build
+ * gives the same bits every run. */
+
+#define PAIRWISE_BLOCK 1024
+
+static float pairwise_sum(float (*block)(const float*, size_t), const float* x, size_t n) {
+    if(n <= PAIRWISE_BLOCK) return block(x, n);
+    size_t half = (n / 2 + PAIRWISE_BLOCK - 1) / PAIRWISE_BLOCK * PAIRWISE_BLOCK;
+    return pairwise_sum(block, x, half) + pairwise_sum(block, x + half, n - half);
+}
+
+static float pairwise_dot(float (*block)(const float*, const float*, size_t),
+                          const float* x,
+                          const float* y,
+                          size_t n) {
+    if(n <= PAIRWISE_BLOCK) return block(x, y, n);
+    size_t half = (n / 2 + PAIRWISE_BLOCK - 1) / PAIRWISE_BLOCK * PAIRWISE_BLOCK;
+    return pairwise_dot(block, x, y, half) + pairwise_dot(block, x + half, y + half, n - half);
+}
+
+// Kept out of line: inlined into an AVX-512 kernel, the compiler vectorizes these into zmm16-31,
+// which V_ZEROUPPER does not clear, and C library code that runs next slows down sharply.
+static SIMD_NOINLINE float sum_block_scalar(const float* x, size_t n) {
+    float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        a0 += x[i];
+        a1 += x[i + 1];
+        a2 += x[i + 2];
+        a3 += x[i + 3];
+    }
+    for(; i < n; i++) {
+        a0 += x[i];
+    }
+    return (a0 + a1) + (a2 + a3);
+}
+
+static SIMD_NOINLINE float dot_block_scalar(const float* x, const float* y, size_t n) {
+    float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        a0 += x[i] * y[i];
+        a1 += x[i + 1] * y[i + 1];
+        a2 += x[i + 2] * y[i + 2];
+        a3 += x[i + 3] * y[i + 3];
+    }
+    for(; i < n; i++) {
+        a0 += x[i] * y[i];
+    }
+    return (a0 + a1) + (a2 + a3);
+}
+
+static float reduce_sum_scalar(const float* x, size_t n) {
+    return pairwise_sum(sum_block_scalar, x, n);
+}
+
+static float dot_scalar(const float* x, const float* y, size_t n) {
+    return pairwise_dot(dot_block_scalar, x, y, n);
+}
+
+static float reduce_max_scalar(const float* x, size_t n) {
+    float best = -INFINITY;
+    for(size_t i = 0; i < n; i++) {
+        best = x[i] > best ? x[i] : best;
+    }
+    return best;
+}
+
+static float reduce_min_scalar(const float* x, size_t n) {
+    float best = INFINITY;
+    for(size_t i = 0; i < n; i++) {
+        best = x[i] < best ? x[i] : best;
+    }
+    return best;
+}
+
+static float reduce_max_index_scalar(const float* x, size_t n, size_t* pos) {
+    float best = -INFINITY;
+    size_t at = 0;
+    for(size_t i = 0; i < n; i++) {
+        if(x[i] > best) {
+            best = x[i];
+            at = i;
+        }
+    }
+    *pos = at;
+    return best;
+}
+
+static float reduce_min_index_scalar(const float* x, size_t n, size_t* pos) {
+    float best = INFINITY;
+    size_t at = 0;
+    for(size_t i = 0; i < n; i++) {
+        if(x[i] < best) {
+            best = x[i];
+            at = i;
+        }
+    }
+    *pos = at;
+    return best;
+}
+
+static void abs_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = fabsf(x[i]);
+    }
+}
+
+static void square_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] * x[i];
+    }
+}
+
+static void reciprocal_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = 1.0f / x[i];
+    }
+}
+
+static void relu_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > 0.0f ? x[i] : 0.0f;
+    }
+}
+
+static void sigmoid_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = 1.0f / (1.0f + expf(-x[i]));
+    }
+}
+
+static void tanh_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = tanhf(x[i]);
+    }
+}
+
+static void exp_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = expf(x[i]);
+    }
+}
+
+static void log_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = logf(x[i]);
+    }
+}
+
+static void elu_scalar(const float* x, float alpha, float scale, float* out, size_t n) {
+    float neg_scale = scale * alpha;
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > 0.0f ? scale * x[i] : neg_scale * (expf(x[i]) - 1.0f);
+    }
+}
+
+static void scale_scalar(const float* x, float s, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = s * x[i];
+    }
+}
+
+static void abs_grad_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > 0.0f ? 1.0f : (x[i] < 0.0f ? -1.0f : 0.0f);
+    }
+}
+
+static void relu_grad_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > 0.0f ? 1.0f : 0.0f;
+    }
+}
+
+static void reciprocal_grad_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = -1.0f / (x[i] * x[i]);
+    }
+}
+
+static void sigmoid_grad_scalar(const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = y[i] * (1.0f - y[i]);
+    }
+}
+
+static void tanh_grad_scalar(const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = 1.0f - y[i] * y[i];
+    }
+}
+
+static void elu_grad_scalar(
+    const float* x, const float* y, float a, float b, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > 0.0f ? a : y[i] + b;
+    }
+}
+
+static void div_grad_y_scalar(const float* x, const float* y, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = -x[i] / (y[i] * y[i]);
+    }
+}
+
+/* Fast math: Cephes-style range reductions and minimax polynomials in plain float arithmetic.
+ * exp(x) = 2^n * e^r with n = round(x / ln 2) and |r| <= ln(2) / 2; inputs above FAST_EXP_HI
+ * overflow to inf and results below FLT_MIN flush to zero. log(x) = e * ln 2 + log1p(m - 1) with
+ * the mantissa m in [sqrt(1/2), sqrt(2)). tanh uses an odd polynomial below 0.625 and
+ * 1 - 2 / (e^2|x| + 1) above. Each function below is mirrored operation for operation by the
+ * vector versions in SIMD_KERNELS. */
+
+#define FAST_EXP_HI 88.3762626647949f      // 127.5 * ln 2, the largest n with a normal 2^n
+#define FAST_EXP_LO -87.3365447505531f     // ln FLT_MIN
+#define FAST_LOG2E 1.44269504088896341f
+#define FAST_ROUND_MAGIC 12582912.0f       // 1.5 * 2^23: adding it rounds to an integer
+#define FAST_LN2_HI 0.693359375f           // ln 2 split so that n * FAST_LN2_HI is exact
+#define FAST_LN2_LO -2.12194440e-4f
+#define FAST_SQRT_HALF 0.707106781186547524f
+#define FAST_TANH_SMALL 0.625f
+
+static float bits_to_float(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static uint32_t float_to_bits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Shared reduction of exp and expm1: returns 2^n and sets e^r - 1 and n
+static float fast_exp_parts(float x, float* em1, float* n) {
+    float c = x > FAST_EXP_HI ? FAST_EXP_HI : x;
+    c = FAST_EXP_LO > c ? FAST_EXP_LO : c;
+    float t = c * FAST_LOG2E + FAST_ROUND_MAGIC;
+    *n = t - FAST_ROUND_MAGIC;
+    float r = c - *n * FAST_LN2_HI;
+    r = r - *n * FAST_LN2_LO;
+    float q = 1.9875691500e-4f;
+    q = q * r + 1.3981999507e-3f;
+    q = q * r + 8.3334519073e-3f;
+    q = q * r + 4.1665795894e-2f;
+    q = q * r + 1.6666665459e-1f;
+    q = q * r + 5.0000001201e-1f;
+    *em1 = q * (r * r) + r;
+    // n + 127 sits in the low bits of t, shifted into the exponent field
+    return bits_to_float((float_to_bits(t) + 127u) << 23);
+}
+
+static float fast_expf(float x) {
+    float em1, n;
+    float scale = fast_exp_parts(x, &em1, &n);
+    float y = (em1 + 1.0f) * scale;
+    return x > FAST_EXP_HI ? INFINITY : (FAST_EXP_LO > x ? 0.0f : y);
+}
+
+// e^x - 1 without the cancellation of expf(x) - 1 when n = 0, i.e. |x| < ln(2) / 2
+static float fast_expm1f(float x) {
+    float em1, n;
+    float scale = fast_exp_parts(x, &em1, &n);
+    float y = (em1 + 1.0f) * scale - 1.0f;
+    y = 0.5f > fabsf(n) ? em1 : y;
+    return x > FAST_EXP_HI ? INFINITY : y;
+}
+
+static float fast_logf(float x) {
+    // subnormals are scaled into the normal range first
+    float xs = FLT_MIN > x ? x * 8388608.0f : x;
+    float adjust = FLT_MIN > x ? 23.0f : 0.0f;
+    uint32_t bits = float_to_bits(xs);
+    float e = (float)(bits >> 23) - (126.0f + adjust);
+    float m = bits_to_float((bits & 0x007fffffu) | 0x3f000000u);  // in [0.5, 1)
+    bool low = FAST_SQRT_HALF > m;
+    e = e - (low ? 1.0f : 0.0f);
+    float t = (m - 1.0f) + (low ? m : 0.0f);
+    float z = t * t;
+    float p = 7.0376836292e-2f;
+    p = p * t - 1.1514610310e-1f;
+    p = p * t + 1.1676998740e-1f;
+    p = p * t - 1.2420140846e-1f;
+    p = p * t + 1.4249322787e-1f;
+    p = p * t - 1.6668057665e-1f;
+    p = p * t + 2.0000714765e-1f;
+    p = p * t - 2.4999993993e-1f;
+    p = p * t + 3.3333331174e-1f;
+    float y = p * t * z;
+    y = y + e * FAST_LN2_LO;
+    y = y - 0.5f * z;
+    float r = t + y;
+    r = r + e * FAST_LN2_HI;
+    r = x > FLT_MAX ? x : r;
+    // log(-x) is NaN, log(0) is -inf, and NaN + -inf keeps NaN inputs
+    return x > 0.0f ? r : (0.0f > x ? NAN : x + -INFINITY);
+}
+
+static float fast_tanhf(float x) {
+    float a = fabsf(x), z = x * x;
+    float p = -5.70498872745e-3f;
+    p = p * z + 2.06390887954e-2f;
+    p = p * z - 5.37397155531e-2f;
+    p = p * z + 1.33314422036e-1f;
+    p = p * z - 3.33332819422e-1f;
+    float small = p * z * x + x;
+    float large = copysignf(1.0f - 2.0f / (fast_expf(a + a) + 1.0f), x);
+    return FAST_TANH_SMALL > a ? small : large;
+}
+
+static float fast_sigmoidf(float x) { return 1.0f / (1.0f + fast_expf(0.0f - x)); }
+
+static void exp_fast_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = fast_expf(x[i]);
+    }
+}
+
+static void log_fast_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = fast_logf(x[i]);
+    }
+}
+
+static void sigmoid_fast_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = fast_sigmoidf(x[i]);
+    }
+}
+
+static void tanh_fast_scalar(const float* x, float* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = fast_tanhf(x[i]);
+    }
+}
+
+static void elu_fast_scalar(const float* x, float alpha, float scale, float* out, size_t n) {
+    float neg_scale = scale * alpha;
+    for(size_t i = 0; i < n; i++) {
+        out[i] = x[i] > 0.0f ? scale * x[i] : neg_scale * fast_expm1f(x[i]);
+    }
+}
+
+static void use_fast_scalar(ElemwiseKernels* k) {
+    k->sigmoid = sigmoid_fast_scalar;
+    k->tanh = tanh_fast_scalar;
+    k->elu = elu_fast_scalar;
+    k->exp = exp_fast_scalar;
+    k->log = log_fast_scalar;
+    k->scalar_exp = fast_expf;
+    k->scalar_log = fast_logf;
+}
+
+static const ElemwiseKernels scalar_kernels = {
+    .add = add_scalar,
+    .sub = sub_scalar,
+    .mul = mul_scalar,
+    .div = div_scalar,
+    .max = max_scalar,
+    .min = min_scalar,
+    .abs = abs_scalar,
+    .square = square_scalar,
+    .reciprocal = reciprocal_scalar,
+    .relu = relu_scalar,
+    .sigmoid = sigmoid_scalar,
+    .tanh = tanh_scalar,
+    .elu = elu_scalar,
+    .exp = exp_scalar,
+    .log = log_scalar,
+    .scalar_exp = expf,
+    .scalar_log = logf,
+    .scale = scale_scalar,
+    .abs_grad = abs_grad_scalar,
+    .relu_grad = relu_grad_scalar,
+    .reciprocal_grad = reciprocal_grad_scalar,
+    .sigmoid_grad = sigmoid_grad_scalar,
+    .tanh_grad = tanh_grad_scalar,
+    .elu_grad = elu_grad_scalar,
+    .div_grad_y = div_grad_y_scalar,
+    .max_index = max_index_scalar,
+    .min_index = min_index_scalar,
+    .reduce_sum = reduce_sum_scalar,
+    .dot = dot_scalar,
+    .reduce_max = reduce_max_scalar,
+    .reduce_min = reduce_min_scalar,
+    .reduce_max_index = reduce_max_index_scalar,
+    .reduce_min_index = reduce_min_index_scalar,
+};
+
+// Usable before cten_initilize() runs the detection
+ElemwiseKernels _cten_kernels = scalar_kernels;
+
+#ifdef SIMD_X86
+/* Vector kernels, written once against the V_* operations and expanded for each instruction set
+ * below. V_SELECT_GT0(v, a, b) and V_SELECT_LT0(v, a, b) pick a where v > 0 (v < 0) and b
+ * elsewhere, NaN included, like the scalar comparisons; V_SELECT_GT(u, v, a, b) does so for
+ * u > v. V_POW2N(t) builds 2^n from the FAST_ROUND_MAGIC sum t = n + 1.5 * 2^23, V_EXPONENT and
+ * V_MANTISSA split a positive float into its biased exponent (as a float) and a mantissa in
+ * [0.5, 1), V_COPYSIGN(a, x) gives a non-negative a the sign of x, and V_SET1_BITS(i) broadcasts
+ * the bits of an int32. */
+
+#define V_MADD(a, b, c) V_ADD(V_MUL(a, b), c)
+
+#define SIMD_BINARY(name, sfx, EXPR)                                                               \
+    static V_TARGET void name##_##sfx(const float* x, const float* y, float* out, size_t n) {      \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_TYPE u = V_LOAD(x + i), v = V_LOAD(y + i);                                           \
+            V_STORE(out + i, EXPR);                                                                \
+        }                                                                                          \
+        name##_scalar(x + i, y + i, out + i, n - i);                                               \
+    }
+
+#define SIMD_UNARY(name, sfx, EXPR)                                                                \
+    static V_TARGET void name##_##sfx(const float* x, float* out, size_t n) {                      \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_TYPE v = V_LOAD(x + i);                                                              \
+            V_STORE(out + i, EXPR);                                                                \
+        }                                                                                          \
+        name##_scalar(x + i, out + i, n - i);                                                      \
+    }
+
+// Four accumulators hide the latency of COMBINE; their lanes and the tail are folded in order by
+// the portable loop, after V_ZEROUPPER so that non-VEX code does not run with dirty upper halves.
+#define SIMD_REDUCE(name, sfx, INIT, COMBINE)                                                      \
+    static V_TARGET float name##_##sfx(const float* x, size_t n) {                                 \
+        V_TYPE a0 = INIT, a1 = INIT, a2 = INIT, a3 = INIT;                                         \
+        size_t i = 0;                                                                              \
+        for(; i + 4 * V_WIDTH <= n; i += 4 * V_WIDTH) {                                            \
+            a0 = COMBINE(V_LOAD(x + i), a0);                                                       \
+            a1 = COMBINE(V_LOAD(x + i + V_WIDTH), a1);                                             \
+            a2 = COMBINE(V_LOAD(x + i + 2 * V_WIDTH), a2);                                         \
+            a3 = COMBINE(V_LOAD(x + i + 3 * V_WIDTH), a3);                                         \
+        }                                                                                          \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            a0 = COMBINE(V_LOAD(x + i), a0);                                                       \
+        }                                                                                          \
+        float lanes[V_WIDTH + 1];                                                                  \
+        V_STORE(lanes, COMBINE(COMBINE(a1, a0), COMBINE(a3, a2)));                                 \
+        V_ZEROUPPER();                                                                             \
+        lanes[V_WIDTH] = name##_scalar(x + i, n - i);                                              \
+        return name##_scalar(lanes, V_WIDTH + 1);                                                  \
+    }
+
+// The indices are blended as float bit patterns, never computed on
+#define SIMD_INDEX(name, sfx, SELECT)                                                              \
+    static V_TARGET void name##_##sfx(                                                             \
+        const float* x, float* best, int32_t* idx, int32_t pos, size_t n) {                        \
+        V_TYPE vpos = V_SET1_BITS(pos);                                                            \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_TYPE u = V_LOAD(x + i), v = V_LOAD(best + i);                                        \
+            V_STORE((float*)(idx + i), SELECT(u, v, vpos, V_LOAD((const float*)(idx + i))));      \
+            V_STORE(best + i, SELECT(u, v, u, v));                                                 \
+        }                                                                                          \
+        name##_scalar(x + i, best + i, idx + i, pos, n - i);                                       \
+    }
+
+// Extreme and first position in one pass: lane k keeps its first best value and the offset of
+// the vector it came from, so it sits at lane_at[k] + k. Lanes fold to the earliest of equal
+// values, and the tail, which lies after every lane, only wins when strictly BETTER.
+#define SIMD_REDUCE_INDEX(name, sfx, INIT, SELECT, BETTER)                                         \
+    static V_TARGET float name##_##sfx(const float* x, size_t n, size_t* pos) {                    \
+        V_TYPE best = V_SET1(INIT), at = V_SET1_BITS(0);                                           \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_TYPE u = V_LOAD(x + i);                                                              \
+            at = SELECT(u, best, V_SET1_BITS((int32_t)i), at);                                     \
+            best = SELECT(u, best, u, best);                                                       \
+        }                                                                                          \
+        float lanes[V_WIDTH];                                                                      \
+        int32_t lane_at[V_WIDTH];                                                                  \
+        V_STORE(lanes, best);                                                                      \
+        V_STORE((float*)lane_at, at);                                                              \
+        V_ZEROUPPER();                                                                             \
+        float v = lanes[0];                                                                        \
+        size_t p = (size_t)lane_at[0];                                                             \
+        for(size_t k = 1; k < V_WIDTH; k++) {                                                      \
+            size_t q = (size_t)lane_at[k] + k;                                                     \
+            if(lanes[k] BETTER v || (lanes[k] == v && q < p)) {                                    \
+                v = lanes[k];                                                                      \
+                p = q;                                                                             \
+            }                                                                                      \
+        }                                                                                          \
+        size_t t;                                                                                  \
+        float tail = name##_scalar(x + i, n - i, &t);                                              \
+        if(tail BETTER v) {                                                                        \
+            v = tail;                                                                              \
+            p = i + t;                                                                             \
+        }                                                                                          \
+        *pos = p;                                                                                  \
+        return v;                                                                                  \
+    }
+
+// the larger (smaller) of u and v, v where u is NaN, as in max_scalar (min_scalar)
+#define V_SELECT_LT(u, v, a, b) V_SELECT_GT(v, u, a, b)
+#define V_MAX(u, v) V_SELECT_GT(u, v, u, v)
+#define V_MIN(u, v) V_SELECT_LT(u, v, u, v)
+
+#define SIMD_KERNELS(sfx)                                                                          \
+    SIMD_BINARY(add, sfx, V_ADD(u, v))                                                             \
+    SIMD_BINARY(sub, sfx, V_SUB(u, v))                                                             \
+    SIMD_BINARY(mul, sfx, V_MUL(u, v))                                                             \
+    SIMD_BINARY(div, sfx, V_DIV(u, v))                                                             \
+    SIMD_BINARY(max, sfx, V_MAX(u, v))                                                             \
+    SIMD_BINARY(min, sfx, V_MIN(u, v))                                                             \
+    SIMD_INDEX(max_index, sfx, V_SELECT_GT)                                                        \
+    SIMD_INDEX(min_index, sfx, V_SELECT_LT)                                                        \
+    SIMD_REDUCE(sum_block, sfx, V_ZERO, V_ADD)                                                     \
+    SIMD_REDUCE(reduce_max, sfx, V_SET1(-INFINITY), V_MAX)                                         \
+    SIMD_REDUCE(reduce_min, sfx, V_SET1(INFINITY), V_MIN)                                          \
+    SIMD_REDUCE_INDEX(reduce_max_index, sfx, -INFINITY, V_SELECT_GT, >)                            \
+    SIMD_REDUCE_INDEX(reduce_min_index, sfx, INFINITY, V_SELECT_LT, <)                             \
+                                                                                                   \
+    static V_TARGET float dot_block_##sfx(const float* x, const float* y, size_t n) {              \
+        V_TYPE a0 = V_ZERO, a1 = V_ZERO, a2 = V_ZERO, a3 = V_ZERO;                                 \
+        size_t i = 0;                                                                              \
+        for(; i + 4 * V_WIDTH <= n; i += 4 * V_WIDTH) {                                            \
+            a0 = V_MADD(V_LOAD(x + i), V_LOAD(y + i), a0);                                         \
+            a1 = V_MADD(V_LOAD(x + i + V_WIDTH), V_LOAD(y + i + V_WIDTH), a1);                     \
+            a2 = V_MADD(V_LOAD(x + i + 2 * V_WIDTH), V_LOAD(y + i + 2 * V_WIDTH), a2);             \
+            a3 = V_MADD(V_LOAD(x + i + 3 * V_WIDTH), V_LOAD(y + i + 3 * V_WIDTH), a3);             \
+        }                                                                                          \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            a0 = V_MADD(V_LOAD(x + i), V_LOAD(y + i), a0);                                         \
+        }                                                                                          \
+        float lanes[V_WIDTH + 1];                                                                  \
+        V_STORE(lanes, V_ADD(V_ADD(a1, a0), V_ADD(a3, a2)));                                       \
+        V_ZEROUPPER();                                                                             \
+        lanes[V_WIDTH] = dot_block_scalar(x + i, y + i, n - i);                                    \
+        return sum_block_scalar(lanes, V_WIDTH + 1);                                               \
+    }                                                                                              \
+                                                                                                   \
+    static float reduce_sum_##sfx(const float* x, size_t n) {                                      \
+        return pairwise_sum(sum_block_##sfx, x, n);                                                \
+    }                                                                                              \
+                                                                                                   \
+    static float dot_##sfx(const float* x, const float* y, size_t n) {                             \
+        return pairwise_dot(dot_block_##sfx, x, y, n);                                             \
+    }                                                                                              \
+    SIMD_BINARY(div_grad_y, sfx, V_DIV(V_SUB(V_ZERO, u), V_MUL(v, v)))                             \
+    SIMD_UNARY(abs, sfx, V_ABS(v))                                                                 \
+    SIMD_UNARY(square, sfx, V_MUL(v, v))                                                           \
+    SIMD_UNARY(reciprocal, sfx, V_DIV(V_SET1(1.0f), v))                                            \
+    SIMD_UNARY(relu, sfx, V_SELECT_GT0(v, v, V_ZERO))                                              \
+    SIMD_UNARY(abs_grad,                                                                           \
+               sfx,                                                                                \
+               V_SELECT_GT0(v, V_SET1(1.0f), V_SELECT_LT0(v, V_SET1(-1.0f), V_ZERO)))              \
+    SIMD_UNARY(relu_grad, sfx, V_SELECT_GT0(v, V_SET1(1.0f), V_ZERO))                              \
+    SIMD_UNARY(reciprocal_grad, sfx, V_DIV(V_SET1(-1.0f), V_MUL(v, v)))                            \
+    SIMD_UNARY(sigmoid_grad, sfx, V_MUL(v, V_SUB(V_SET1(1.0f), v)))                                \
+    SIMD_UNARY(tanh_grad, sfx, V_SUB(V_SET1(1.0f), V_MUL(v, v)))                                   \
+                                                                                                   \
+    static V_TARGET void scale_##sfx(const float* x, float s, float* out, size_t n) {              \
+        V_TYPE vs = V_SET1(s);                                                                     \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_STORE(out + i, V_MUL(vs, V_LOAD(x + i)));                                            \
+        }                                                                                          \
+        scale_scalar(x + i, s, out + i, n - i);                                                    \
+    }                                                                                              \
+                                                                                                   \
+    static V_TARGET void elu_grad_##sfx(                                                           \
+        const float* x, const float* y, float a, float b, float* out, size_t n) {                  \
+        V_TYPE va = V_SET1(a), vb = V_SET1(b);                                                     \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_TYPE v = V_LOAD(x + i);                                                              \
+            V_STORE(out + i, V_SELECT_GT0(v, va, V_ADD(V_LOAD(y + i), vb)));                       \
+        }                                                                                          \
+        elu_grad_scalar(x + i, y + i, a, b, out + i, n - i);                                       \
+    }                                                                                              \
+                                                                                                   \
+    static inline V_TARGET V_TYPE exp_parts_##sfx(V_TYPE x, V_TYPE* em1, V_TYPE* n) {              \
+        V_TYPE hi = V_SET1(FAST_EXP_HI), lo = V_SET1(FAST_EXP_LO);                                 \
+        V_TYPE c = V_SELECT_GT(x, hi, hi, x);                                                      \
+        c = V_SELECT_GT(lo, c, lo, c);                                                             \
+        V_TYPE t = V_MADD(c, V_SET1(FAST_LOG2E), V_SET1(FAST_ROUND_MAGIC));                        \
+        *n = V_SUB(t, V_SET1(FAST_ROUND_MAGIC));                                                   \
+        V_TYPE r = V_SUB(c, V_MUL(*n, V_SET1(FAST_LN2_HI)));                                       \
+        r = V_SUB(r, V_MUL(*n, V_SET1(FAST_LN2_LO)));                                              \
+        V_TYPE q = V_SET1(1.9875691500e-4f);                                                       \
+        q = V_MADD(q, r, V_SET1(1.3981999507e-3f));                                                \
+        q = V_MADD(q, r, V_SET1(8.3334519073e-3f));                                                \
+        q = V_MADD(q, r, V_SET1(4.1665795894e-2f));                                                \
+        q = V_MADD(q, r, V_SET1(1.6666665459e-1f));                                                \
+        q = V_MADD(q, r, V_SET1(5.0000001201e-1f));                                                \
+        *em1 = V_MADD(q, V_MUL(r, r), r);                                                          \
+        return V_POW2N(t);                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    static inline V_TARGET V_TYPE exp_##sfx(V_TYPE x) {                                            \
+        V_TYPE em1, n;                                                                             \
+        V_TYPE scale = exp_parts_##sfx(x, &em1, &n);                                               \
+        V_TYPE y = V_MUL(V_ADD(em1, V_SET1(1.0f)), scale);                                         \
+        y = V_SELECT_GT(V_SET1(FAST_EXP_LO), x, V_ZERO, y);                                        \
+        return V_SELECT_GT(x, V_SET1(FAST_EXP_HI), V_SET1(INFINITY), y);                           \
+    }                                                                                              \
+                                                                                                   \
+    static inline V_TARGET V_TYPE expm1_##sfx(V_TYPE x) {                                          \
+        V_TYPE em1, n;                                                                             \
+        V_TYPE scale = exp_parts_##sfx(x, &em1, &n);                                               \
+        V_TYPE y = V_SUB(V_MUL(V_ADD(em1, V_SET1(1.0f)), scale), V_SET1(1.0f));                    \
+        y = V_SELECT_GT(V_SET1(0.5f), V_ABS(n), em1, y);                                           \
+        return V_SELECT_GT(x, V_SET1(FAST_EXP_HI), V_SET1(INFINITY), y);                           \
+    }                                                                                              \
+                                                                                                   \
+    static inline V_TARGET V_TYPE log_##sfx(V_TYPE x) {                                            \
+        V_TYPE tiny = V_SET1(FLT_MIN), sqrt_half = V_SET1(FAST_SQRT_HALF);                         \
+        V_TYPE xs = V_SELECT_GT(tiny, x, V_MUL(x, V_SET1(8388608.0f)), x);                         \
+        V_TYPE adjust = V_SELECT_GT(tiny, x, V_SET1(23.0f), V_ZERO);                               \
+        V_TYPE e = V_SUB(V_EXPONENT(xs), V_ADD(V_SET1(126.0f), adjust));                           \
+        V_TYPE m = V_MANTISSA(xs);                                                                 \
+        e = V_SUB(e, V_SELECT_GT(sqrt_half, m, V_SET1(1.0f), V_ZERO));                             \
+        V_TYPE t = V_ADD(V_SUB(m, V_SET1(1.0f)), V_SELECT_GT(sqrt_half, m, m, V_ZERO));            \
+        V_TYPE z = V_MUL(t, t);                                                                    \
+        V_TYPE p = V_SET1(7.0376836292e-2f);                                                       \
+        p = V_MADD(p, t, V_SET1(-1.1514610310e-1f));                                               \
+        p = V_MADD(p, t, V_SET1(1.1676998740e-1f));                                                \
+        p = V_MADD(p, t, V_SET1(-1.2420140846e-1f));                                               \
+        p = V_MADD(p, t, V_SET1(1.4249322787e-1f));                                                \
+        p = V_MADD(p, t, V_SET1(-1.6668057665e-1f));                                               \
+        p = V_MADD(p, t, V_SET1(2.0000714765e-1f));                                                \
+        p = V_MADD(p, t, V_SET1(-2.4999993993e-1f));                                               \
+        p = V_MADD(p, t, V_SET1(3.3333331174e-1f));                                                \
+        V_TYPE y = V_MUL(V_MUL(p, t), z);                                                          \
+        y = V_MADD(e, V_SET1(FAST_LN2_LO), y);                                                     \
+        y = V_SUB(y, V_MUL(V_SET1(0.5f), z));                                                      \
+        V_TYPE r = V_ADD(t, y);                                                                    \
+        r = V_MADD(e, V_SET1(FAST_LN2_HI), r);                                                     \
+        r = V_SELECT_GT(x, V_SET1(FLT_MAX), x, r);                                                 \
+        V_TYPE not_positive = V_SELECT_GT(V_ZERO, x, V_SET1(NAN), V_ADD(x, V_SET1(-INFINITY)));    \
+        return V_SELECT_GT(x, V_ZERO, r, not_positive);                                            \
+    }                                                                                              \
+                                                                                                   \
+    static inline V_TARGET V_TYPE tanh_##sfx(V_TYPE x) {                                           \
+        V_TYPE a = V_ABS(x), z = V_MUL(x, x);                                                      \
+        V_TYPE p = V_SET1(-5.70498872745e-3f);                                                     \
+        p = V_MADD(p, z, V_SET1(2.06390887954e-2f));                                               \
+        p = V_MADD(p, z, V_SET1(-5.37397155531e-2f));                                              \
+        p = V_MADD(p, z, V_SET1(1.33314422036e-1f));                                               \
+        p = V_MADD(p, z, V_SET1(-3.33332819422e-1f));                                              \
+        V_TYPE small = V_MADD(V_MUL(p, z), x, x);                                                  \
+        V_TYPE e = exp_##sfx(V_ADD(a, a));                                                         \
+        V_TYPE large = V_SUB(V_SET1(1.0f), V_DIV(V_SET1(2.0f), V_ADD(e, V_SET1(1.0f))));           \
+        return V_SELECT_GT(V_SET1(FAST_TANH_SMALL), a, small, V_COPYSIGN(large, x));               \
+    }                                                                                              \
+                                                                                                   \
+    SIMD_UNARY(exp_fast, sfx, exp_##sfx(v))                                                        \
+    SIMD_UNARY(log_fast, sfx, log_##sfx(v))                                                        \
+    SIMD_UNARY(tanh_fast, sfx, tanh_##sfx(v))                                                      \
+    SIMD_UNARY(sigmoid_fast,                                                                       \
+               sfx,                                                                                \
+               V_DIV(V_SET1(1.0f), V_ADD(V_SET1(1.0f), exp_##sfx(V_SUB(V_ZERO, v)))))              \
+                                                                                                   \
+    static V_TARGET void elu_fast_##sfx(                                                           \
+        const float* x, float alpha, float scale, float* out, size_t n) {                          \
+        V_TYPE vs = V_SET1(scale), vn = V_SET1(scale * alpha);                                     \
+        size_t i = 0;                                                                              \
+        for(; i + V_WIDTH <= n; i += V_WIDTH) {                                                    \
+            V_TYPE v = V_LOAD(x + i);                                                              \
+            V_STORE(out + i, V_SELECT_GT0(v, V_MUL(vs, v), V_MUL(vn, expm1_##sfx(v))));            \
+        }                                                                                          \
+        elu_fast_scalar(x + i, alpha, scale, out + i, n - i);                                      \
+    }                                                                                              \
+                                                                                                   \
+    static void use_##sfx(ElemwiseKernels* k, bool fast) {                                         \
+        k->add = add_##sfx;                                                                        \
+        k->sub = sub_##sfx;                                                                        \
+        k->mul = mul_##sfx;                                                                        \
+        k->div = div_##sfx;                                                                        \
+        k->max = max_##sfx;                                                                        \
+        k->min = min_##sfx;                                                                        \
+        k->abs = abs_##sfx;                                                                        \
+        k->square = square_##sfx;                                                                  \
+        k->reciprocal = reciprocal_##sfx;                                                          \
+        k->relu = relu_##sfx;                                                                      \
+        k->scale = scale_##sfx;                                                                    \
+        k->abs_grad = abs_grad_##sfx;                                                              \
+        k->relu_grad = relu_grad_##sfx;                                                            \
+        k->reciprocal_grad = reciprocal_grad_##sfx;                                                \
+        k->sigmoid_grad = sigmoid_grad_##sfx;                                                      \
+        k->tanh_grad = tanh_grad_##sfx;                                                            \
+        k->elu_grad = elu_grad_##sfx;                                                              \
+        k->div_grad_y = div_grad_y_##sfx;                                                          \
+        k->max_index = max_index_##sfx;                                                            \
+        k->min_index = min_index_##sfx;                                                            \
+        k->reduce_sum = reduce_sum_##sfx;                                                          \
+        k->dot = dot_##sfx;                                                                        \
+        k->reduce_max = reduce_max_##sfx;                                                          \
+        k->reduce_min = reduce_min_##sfx;                                                          \
+        k->reduce_max_index = reduce_max_index_##sfx;                                              \
+        k->reduce_min_index = reduce_min_index_##sfx;                                              \
+        if(fast) {                                                                                 \
+            k->sigmoid = sigmoid_fast_##sfx;                                                       \
+            k->tanh = tanh_fast_##sfx;                                                             \
+            k->elu = elu_fast_##sfx;                                                               \
+            k->exp = exp_fast_##sfx;                                                               \
+            k->log = log_fast_##sfx;                                                               \
+        }                                                                                          \
+    }
+
+// SSE2
+#define V_TARGET SIMD_TARGET("sse2")
+#define V_TYPE __m128
+#define V_WIDTH 4
+#define V_LOAD _mm_loadu_ps
+#define V_STORE _mm_storeu_ps
+#define V_SET1 _mm_set1_ps
+#define V_ZERO _mm_setzero_ps()
+#define V_ADD _mm_add_ps
+#define V_SUB _mm_sub_ps
+#define V_MUL _mm_mul_ps
+#define V_DIV _mm_div_ps
+#define V_ABS(v) _mm_andnot_ps(_mm_set1_ps(-0.0f), v)
+#define V_BLEND(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define V_SELECT_GT(u, v, a, b) V_BLEND(_mm_cmpgt_ps(u, v), a, b)
+#define V_SELECT_GT0(v, a, b) V_SELECT_GT(v, V_ZERO, a, b)
+#define V_SELECT_LT0(v, a, b) V_SELECT_GT(V_ZERO, v, a, b)
+#define V_BITS _mm_castps_si128
+#define V_POW2N(t)                                                                                 \
+    _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(V_BITS(t), _mm_set1_epi32(127)), 23))
+#define V_EXPONENT(x) _mm_cvtepi32_ps(_mm_srli_epi32(V_BITS(x), 23))
+#define V_MANTISSA(x)                                                                              \
+    _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(V_BITS(x), _mm_set1_epi32(0x007fffff)),            \
+                                  _mm_set1_epi32(0x3f000000)))
+#define V_COPYSIGN(a, x) _mm_or_ps(a, _mm_and_ps(x, _mm_set1_ps(-0.0f)))
+#define V_SET1_BITS(i) _mm_castsi128_ps(_mm_set1_epi32(i))
+#define V_ZEROUPPER()
+SIMD_KERNELS(sse2)
+#undef V_TARGET
+#undef V_TYPE
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ZERO
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_ABS
+#undef V_BLEND
+#undef V_SELECT_GT
+#undef V_SELECT_GT0
+#undef V_SELECT_LT0
+#undef V_BITS
+#undef V_POW2N
+#undef V_EXPONENT
+#undef V_MANTISSA
+#undef V_COPYSIGN
+#undef V_SET1_BITS
+#undef V_ZEROUPPER
+
+// AVX2
+#define V_TARGET SIMD_TARGET("avx2")
+#define V_TYPE __m256
+#define V_WIDTH 8
+#define V_LOAD _mm256_loadu_ps
+#define V_STORE _mm256_storeu_ps
+#define V_SET1 _mm256_set1_ps
+#define V_ZERO _mm256_setzero_ps()
+#define V_ADD _mm256_add_ps
+#define V_SUB _mm256_sub_ps
+#define V_MUL _mm256_mul_ps
+#define V_DIV _mm256_div_ps
+#define V_ABS(v) _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v)
+#define V_SELECT_GT(u, v, a, b) _mm256_blendv_ps(b, a, _mm256_cmp_ps(u, v, _CMP_GT_OQ))
+#define V_SELECT_GT0(v, a, b) V_SELECT_GT(v, V_ZERO, a, b)
+#define V_SELECT_LT0(v, a, b) V_SELECT_GT(V_ZERO, v, a, b)
+#define V_BITS _mm256_castps_si256
+#define V_POW2N(t)                                                                                 \
+    _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(V_BITS(t), _mm256_set1_epi32(127)), 23))
+#define V_EXPONENT(x) _mm256_cvtepi32_ps(_mm256_srli_epi32(V_BITS(x), 23))
+#define V_MANTISSA(x)                                                                              \
+    _mm256_castsi256_ps(_mm256_or_si256(                                                           \
+        _mm256_and_si256(V_BITS(x), _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000)))
+#define V_COPYSIGN(a, x) _mm256_or_ps(a, _mm256_and_ps(x, _mm256_set1_ps(-0.0f)))
+#define V_SET1_BITS(i) _mm256_castsi256_ps(_mm256_set1_epi32(i))
+#define V_ZEROUPPER _mm256_zeroupper
+SIMD_KERNELS(avx2)
+#undef V_TARGET
+#undef V_TYPE
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ZERO
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_ABS
+#undef V_SELECT_GT
+#undef V_SELECT_GT0
+#undef V_SELECT_LT0
+#undef V_BITS
+#undef V_POW2N
+#undef V_EXPONENT
+#undef V_MANTISSA
+#undef V_COPYSIGN
+#undef V_SET1_BITS
+#undef V_ZEROUPPER
+
+// AVX-512 (foundation subset only)
+#define V_TARGET SIMD_TARGET("avx512f")
+#define V_TYPE __m512
+#define V_WIDTH 16
+#define V_LOAD _mm512_loadu_ps
+#define V_STORE _mm512_storeu_ps
+#define V_SET1 _mm512_set1_ps
+#define V_ZERO _mm512_setzero_ps()
+#define V_ADD _mm512_add_ps
+#define V_SUB _mm512_sub_ps
+#define V_MUL _mm512_mul_ps
+#define V_DIV _mm512_div_ps
+#define V_ABS _mm512_abs_ps
+#define V_SELECT_GT(u, v, a, b) _mm512_mask_blend_ps(_mm512_cmp_ps_mask(u, v, _CMP_GT_OQ), b, a)
+#define V_SELECT_GT0(v, a, b) V_SELECT_GT(v, V_ZERO, a, b)
+#define V_SELECT_LT0(v, a, b) V_SELECT_GT(V_ZERO, v, a, b)
+#define V_BITS _mm512_castps_si512
+#define V_POW2N(t)                                                                                 \
+    _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(V_BITS(t), _mm512_set1_epi32(127)), 23))
+#define V_EXPONENT(x) _mm512_cvtepi32_ps(_mm512_srli_epi32(V_BITS(x), 23))
+#define V_MANTISSA(x)                                                                              \
+    _mm512_castsi512_ps(_mm512_or_si512(                                                           \
+        _mm512_and_si512(V_BITS(x), _mm512_set1_epi32(0x007fffff)), _mm512_set1_epi32(0x3f000000)))
+// _mm512_or_ps needs AVX-512DQ, so the sign goes through the integer unit
+#define V_COPYSIGN(a, x)                                                                           \
+    _mm512_castsi512_ps(                                                                           \
+        _mm512_or_si512(V_BITS(a), _mm512_and_si512(V_BITS(x), _mm512_set1_epi32(INT32_MIN))))
+#define V_SET1_BITS(i) _mm512_castsi512_ps(_mm512_set1_epi32(i))
+#define V_ZEROUPPER _mm256_zeroupper
+SIMD_KERNELS(avx512)
+#undef V_TARGET
+#undef V_TYPE
+#undef V_WIDTH
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ZERO
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_ABS
+#undef V_SELECT_GT
+#undef V_SELECT_GT0
+#undef V_SELECT_LT0
+#undef V_BITS
+#undef V_POW2N
+#undef V_EXPONENT
+#undef V_MANTISSA
+#undef V_COPYSIGN
+#undef V_SET1_BITS
+#undef V_ZEROUPPER
+#endif
+
+/* Level selection */
+
+static cten_SimdLevel g_simd_supported = cten_SimdLevel_Scalar;
+static cten_SimdLevel g_simd_level = cten_SimdLevel_Scalar;
+static cten_MathMode g_math_mode = cten_MathMode_Precise;
+
+static const char* const simd_level_names[] = {"scalar", "sse2", "avx2", "avx512"};
+static const char* const math_mode_names[] = {"precise", "fast"};
+
+static void select_kernels() {
+    ElemwiseKernels k = scalar_kernels;
+    bool fast = g_math_mode == cten_MathMode_Fast;
+    if(fast) use_fast_scalar(&k);
+#ifdef SIMD_X86
+    switch(g_simd_level) {
+        case cten_SimdLevel_Scalar: break;
+        case cten_SimdLevel_SSE2: use_sse2(&k, fast); break;
+        case cten_SimdLevel_AVX2: use_avx2(&k, fast); break;
+        case cten_SimdLevel_AVX512: use_avx512(&k, fast); break;
+    }
+#endif
+    _cten_kernels = k;
+}
+
+static cten_SimdLevel detect_simd_level() {
+#if defined(SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    int max_leaf = regs[0];
+    __cpuid(regs, 1);
+    // AVX state must be enabled by the OS (OSXSAVE, then the YMM/ZMM bits of XCR0)
+    bool os_avx = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+    bool os_avx512 = os_avx && (_xgetbv(0) & 0xe6) == 0xe6;
+    if(max_leaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        if(os_avx512 && (regs[1] & (1 << 16))) return cten_SimdLevel_AVX512;
+        if(os_avx && (regs[1] & (1 << 5))) return cten_SimdLevel_AVX2;
+    }
+    return cten_SimdLevel_SSE2;
+#elif defined(SIMD_X86)
+    // checks the OS-enabled register state as well as the CPUID bits
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return cten_SimdLevel_AVX512;
+    if(__builtin_cpu_supports("avx2")) return cten_SimdLevel_AVX2;
+    return cten_SimdLevel_SSE2;
+#else
+    return cten_SimdLevel_Scalar;
+#endif
+}
+
+void _cten_simd_init() {
+    g_simd_supported = detect_simd_level();
+    cten_SimdLevel level = g_simd_supported;
+    const char* env = getenv("CTEN_SIMD");
+    if(env != NULL && env[0] != '\0') {
+        int found = -1;
+        for(int i = 0; i <= cten_SimdLevel_AVX512; i++) {
+            if(strcmp(env, simd_level_names[i]) == 0) found = i;
+        }
+        cten_assert(found >= 0, "CTEN_SIMD: unknown level '%s' (scalar, sse2, avx2, avx512)", env);
+        level = (cten_SimdLevel)found;
+    }
+    env = getenv("CTEN_MATH");
+    if(env != NULL && env[0] != '\0') {
+        int found = -1;
+        for(int i = 0; i <= cten_MathMode_Fast; i++) {
+            if(strcmp(env, math_mode_names[i]) == 0) found = i;
+        }
+        cten_assert(found >= 0, "CTEN_MATH: unknown mode '%s' (precise, fast)", env);
+        g_math_mode = (cten_MathMode)found;
+    }
+    cten_set_simd_level(level);
+}
+
+cten_SimdLevel cten_set_simd_level(cten_SimdLevel level) {
+    if(level > g_simd_supported) level = g_simd_supported;
+    if(level < cten_SimdLevel_Scalar) level = cten_SimdLevel_Scalar;
+    g_simd_level = level;
+    select_kernels();
+    return level;
+}
+
+cten_SimdLevel cten_simd_level() { return g_simd_level; }
+
+const char* cten_simd_level_name(cten_SimdLevel level) {
+    if(level < cten_SimdLevel_Scalar || level > cten_SimdLevel_AVX512) return "unknown";
+    return simd_level_names[level];
+}
+
+cten_MathMode cten_math_mode() { return g_math_mode; }
+
+void cten_set_math_mode(cten_MathMode mode) {
+    cten_assert(mode == cten_MathMode_Precise || mode == cten_MathMode_Fast,
+                "unknown math mode %d",
+                (int)mode);
+    g_math_mode = mode;
+    select_kernels();
+}
@@ -1,4 +1,5 @@
 #include "cten.h"
+#include "cten_internal.h"
 
 #include <assert.h>
 #include <stdarg.h>
@@ -6,7 +7,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
-#include <time.h>
 #include <limits.h>
 
 bool va_arg_is_present(va_list args) {
@@ -18,12 +18,22 @@ Tensor GradFn_mean(Tensor self, int i);
 Tensor GradFn_sum(Tensor self, int i);
 Tensor GradFn_max_all(Tensor self, int i);
 Tensor GradFn_min_all(Tensor self, int i);
-Tensor GradFn_reduce_dim(Tensor self, int i);
+
+// Visits the elements of `t` as float32 blocks `x[0..n)`, widening reduced-precision storage.
+#define FOREACH_F32_BLOCK(t, x, n, BODY)                                                        \
+    do {                                                                                        \
+        float block_buf[_CTEN_LOAD_BLOCK];                                                      \
+        size_t span = _cten_load_span((t).data);                                                \
+        for(size_t base = 0; base < (t).data->numel; base += span) {                            \
+            size_t n = (t).data->numel - base < span ? (t).data->numel - base : span;           \
+            const float* x = _cten_load_f32((t).data, base, n, block_buf);                      \
+            BODY                                                                                \
+        }                                                                                       \
+    } while(0)
 
 Tensor Tensor_mean_all(Tensor self) {
     float total = 0.0f;
-    for(int i = 0; i < self.data->numel; i++)
-        total += self.data->flex[i];
+    FOREACH_F32_BLOCK(self, x, n, { total += _cten_kernels.reduce_sum(x, n); });
     Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, self.node != NULL);
     res.data->flex[0] = total / self.data->numel;
     if(res.node != NULL) {
@@ -36,20 +46,12 @@ Tensor Tensor_mean_all(Tensor self) {
 }
 
 Tensor Tensor_mean_dim(Tensor self, int dim) {
-    Tensor res = Tensor_reduce_dim(self, dim, "mean");
-    if(res.node != NULL) {
-        res.node->grad_fn = GradFn_mean;
-        res.node->inputs[0] = self;
-        res.node->n_inputs = 1;
-        res.node->name = "Mean";
-    }
-    return res;
+    return Tensor_reduce(self, TensorReduceOp_Mean, &dim, 1, false);
 }
 
 Tensor Tensor_sum_all(Tensor self) {
     float total = 0.0f;
-    for(int i = 0; i < self.data->numel; i++)
-        total += self.data->flex[i];
+    FOREACH_F32_BLOCK(self, x, n, { total += _cten_kernels.reduce_sum(x, n); });
     Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, self.node != NULL);
     res.data->flex[0] = total;
     if(res.node != NULL) {
@@ -62,14 +64,7 @@ Tensor Tensor_sum_all(Tensor self) {
 }
 
 Tensor Tensor_sum_dim(Tensor self, int dim) {
-    Tensor res = Tensor_reduce_dim(self, dim, "sum");
-    if(res.node != NULL) {
-        res.node->grad_fn = GradFn_sum;
-        res.node->inputs[0] = self;
-        res.node->n_inputs = 1;
-        res.node->name = "Sum";
-    }
-    return res;
+    return Tensor_reduce(self, TensorReduceOp_Sum, &dim, 1, false);
 }
 
 Tensor Tensor_max_all(Tensor self) {
@@ -77,10 +72,11 @@ Tensor Tensor_max_all(Tensor self) {
     Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, requires_grad);
 
     if(self.data->numel == 0) cten_assert(false, "max on empty tensor");
-    float max_val = self.data->flex[0];
-    for(int i = 1; i < self.data->numel; i++) {
-        if(self.data->flex[i] > max_val) { max_val = self.data->flex[i]; }
-    }
+    float max_val = -INFINITY;
+    FOREACH_F32_BLOCK(self, x, n, {
+        float block_max = _cten_kernels.reduce_max(x, n);
+        if(block_max > max_val) max_val = block_max;
+    });
     res.data->flex[0] = max_val;
 
     if(requires_grad) {
@@ -93,56 +89,11 @@ Tensor Tensor_max_all(Tensor self) {
 }
 
 TensorMaxMinResult Tensor_max_dim(Tensor self, int dim) {
-    int ndim = TensorShape_dim(self.shape);
+    self = _cten_as_f32(self);
     dim = TensorShape_asdim(self.shape, dim);
 
-    TensorShape out_shape = {0};
-    int out_shape_len = 0;
-    for(int i = 0; i < ndim; i++) {
-        if(i != dim) out_shape[out_shape_len++] = self.shape[i];
-    }
-
-    bool requires_grad = !cten_is_eval() && (self.node != NULL);
-    Tensor values = Tensor_new(out_shape, requires_grad);
-    Tensor indices = Tensor_new(out_shape, false);
-
-    int dim_size = self.shape[dim];
-    for(int i = 0; i < values.data->numel; ++i) {
-        float best_val = -INFINITY;
-        int best_idx = -1;
-
-        for(int j = 0; j < dim_size; ++j) {
-            int in_linear_idx = 0, stride = 1, out_i_rem = i, out_idx_tracker = out_shape_len - 1;
-            for(int k = ndim - 1; k >= 0; --k) {
-                int current_dim_idx;
-                if(k == dim) {
-                    current_dim_idx = j;
-                } else {
-                    int dim_k = out_shape[out_idx_tracker--];
-                    current_dim_idx = out_i_rem % dim_k;
-                    out_i_rem /= dim_k;
-                }
-                in_linear_idx += current_dim_idx * stride;
-                stride *= self.shape[k];
-            }
-            float current_val = self.data->flex[in_linear_idx];
-            if(current_val > best_val) {
-                best_val = current_val;
-                best_idx = j;
-            }
-        }
-        values.data->flex[i] = best_val;
-        indices.data->flex[i] = (float)best_idx;
-    }
-
-    if(requires_grad) {
-        values.node->grad_fn = GradFn_reduce_dim;
-        values.node->inputs[0] = self;
-        values.node->inputs[1] = indices;
-        values.node->n_inputs = 2;
-        values.node->name = "MaxDim";
-    }
-
+    Tensor indices;
+    Tensor values = _cten_reduce_autograd(self, TensorReduceOp_Max, 1 << dim, false, &indices);
     TensorMaxMinResult result = {values, indices};
     return result;
 }
@@ -152,10 +103,11 @@ Tensor Tensor_min_all(Tensor self) {
     Tensor res = Tensor_new((TensorShape){1, 0, 0, 0}, requires_grad);
 
     if(self.data->numel == 0) cten_assert(false, "min on empty tensor");
-    float min_val = self.data->flex[0];
-    for(int i = 1; i < self.data->numel; i++) {
-        if(self.data->flex[i] < min_val) { min_val = self.data->flex[i]; }
-    }
+    float min_val = INFINITY;
+    FOREACH_F32_BLOCK(self, x, n, {
+        float block_min = _cten_kernels.reduce_min(x, n);
+        if(block_min < min_val) min_val = block_min;
+    });
     res.data->flex[0] = min_val;
 
     if(requires_grad) {
@@ -168,56 +120,11 @@ Tensor Tensor_min_all(Tensor self) {
 }
 
 TensorMaxMinResult Tensor_min_dim(Tensor self, int dim) {
-    int ndim = TensorShape_dim(self.shape);
+    self = _cten_as_f32(self);
     dim = TensorShape_asdim(self.shape, dim);
 
-    TensorShape out_shape = {0};
-    int out_shape_len = 0;
-    for(int i = 0; i < ndim; i++) {
-        if(i != dim) out_shape[out_shape_len++] = self.shape[i];
-    }
-
-    bool requires_grad = !cten_is_eval() && (self.node != NULL);
-    Tensor values = Tensor_new(out_shape, requires_grad);
-    Tensor indices = Tensor_new(out_shape, false);
-
-    int dim_size = self.shape[dim];
-    for(int i = 0; i < values.data->numel; ++i) {
-        float best_val = INFINITY;
-        int best_idx = -1;
-
-        for(int j = 0; j < dim_size; ++j) {
-            int in_linear_idx = 0, stride = 1, out_i_rem = i, out_idx_tracker = out_shape_len - 1;
-            for(int k = ndim - 1; k >= 0; --k) {
-                int current_dim_idx;
-                if(k == dim) {
-                    current_dim_idx = j;
-                } else {
-                    int dim_k = out_shape[out_idx_tracker--];
-                    current_dim_idx = out_i_rem % dim_k;
-                    out_i_rem /= dim_k;
-                }
-                in_linear_idx += current_dim_idx * stride;
-                stride *= self.shape[k];
-            }
-            float current_val = self.data->flex[in_linear_idx];
-            if(current_val < best_val) {
-                best_val = current_val;
-                best_idx = j;
-            }
-        }
-        values.data->flex[i] = best_val;
-        indices.data->flex[i] = (float)best_idx;
-    }
-
-    if(requires_grad) {
-        values.node->grad_fn = GradFn_reduce_dim;
-        values.node->inputs[0] = self;
-        values.node->inputs[1] = indices;
-        values.node->n_inputs = 2;
-        values.node->name = "MinDim";
-    }
-
+    Tensor indices;
+    Tensor values = _cten_reduce_autograd(self, TensorReduceOp_Min, 1 << dim, false, &indices);
     TensorMaxMinResult result = {values, indices};
     return result;
 }
@@ -246,17 +153,65 @@ void cten_assert_dim(const char* title, int a, int b) {
     cten_assert(a == b, "%s: %d != %d", title, a, b);
 }
 
+static Tensor broadcast_expand(Tensor src, TensorShape result_shape, int ndim) {
+    src = _cten_as_f32(src);
+    // stride of `src` along each result dimension; 0 where `src` is broadcast
+    size_t src_strides[CTEN_MAX_DIMS] = {0};
+    int offset = ndim - src.ndim;
+    size_t stride = 1;
+    for(int d = ndim - 1; d >= offset; d--) {
+        int src_dim = src.shape[d - offset];
+        src_strides[d] = (src_dim == 1) ? 0 : stride;
+        stride *= src_dim;
+    }
+
+    Tensor res = Tensor_new(result_shape, src.node != NULL);
+
+    // fast paths: a scalar, or `src` matching the trailing result dims (e.g. a bias row)
+    if(src.numel == 1) {
+        for(size_t i = 0; i < res.numel; i++) {
+            res.data->flex[i] = src.data->flex[0];
+        }
+        return res;
+    }
+    if(memcmp(src.shape, result_shape + offset, sizeof(int) * src.ndim) == 0) {
+        for(size_t i = 0; i < res.numel; i += src.numel) {
+            memcpy(res.data->flex + i, src.data->flex, sizeof(float) * src.numel);
+        }
+        return res;
+    }
+
+    int idx[CTEN_MAX_DIMS] = {0};
+    size_t src_idx = 0;
+    for(size_t i = 0; i < res.numel; i++) {
+        res.data->flex[i] = src.data->flex[src_idx];
+        // advance the multi-index like an odometer, innermost dimension first
+        for(int d = ndim - 1; d >= 0; d--) {
+            src_idx += src_strides[d];
+            if(++idx[d] < result_shape[d]) break;
+            src_idx -= src_strides[d] * result_shape[d];
+            idx[d] = 0;
+        }
+    }
+    return res;
+}
+
 bool cten_elemwise_broadcast(Tensor* a, Tensor* b) {
     Tensor orig_a = *a;
     Tensor orig_b = *b;
 
+    // fast path: identical shapes need no expansion
+    if(orig_a.ndim == orig_b.ndim && memcmp(orig_a.shape, orig_b.shape, sizeof(TensorShape)) == 0) {
+        return true;
+    }
+
     // 1. Determine the result shape from the two input shapes
     TensorShape result_shape;
-    int a_ndims = TensorShape_dim(orig_a.shape);
-    int b_ndims = TensorShape_dim(orig_b.shape);
+    int a_ndims = orig_a.ndim;
+    int b_ndims = orig_b.ndim;
     int max_ndims = (a_ndims > b_ndims) ? a_ndims : b_ndims;
 
-    if(max_ndims > 4) return false;
+    if(max_ndims > CTEN_MAX_DIMS) return false;
     memset(result_shape, 0, sizeof(TensorShape));
 
     for(int i = 0; i < max_ndims; i++) {
@@ -272,56 +227,12 @@ bool cten_elemwise_broadcast(Tensor* a, Tensor* b) {
         }
     }
 
-    // 2. Check if tensor 'a' needs to be expanded
+    // 2. Expand whichever operand does not already have the result shape
     if(memcmp(orig_a.shape, result_shape, sizeof(TensorShape)) != 0) {
-        Tensor new_a = Tensor_new(result_shape, orig_a.node != NULL);
-        for(int i = 0; i < new_a.data->numel; i++) {
-            int rem = i;
-            int idx[4] = {0};
-            for(int d = max_ndims - 1; d >= 0; d--) {
-                idx[d] = rem % result_shape[d];
-                rem /= result_shape[d];
-            }
-
-            int source_idx = 0;
-            int stride = 1;
-            // iterating backwards over the original tensor's dimensions
-            for(int d = a_ndims - 1; d >= 0; d--) {
-                int original_dim_size = orig_a.shape[d];
-                int result_dim_coord = idx[max_ndims - a_ndims + d];
-                // if original dimension was 1, it's broadcast; its index is 0.
-                int dim_idx = (original_dim_size == 1) ? 0 : result_dim_coord;
-                source_idx += dim_idx * stride;
-                stride *= original_dim_size;
-            }
-            new_a.data->flex[i] = orig_a.data->flex[source_idx];
-        }
-        *a = new_a;
+        *a = broadcast_expand(orig_a, result_shape, max_ndims);
     }
-
-    // 3. Check if tensor 'b' needs to be expanded
     if(memcmp(orig_b.shape, result_shape, sizeof(TensorShape)) != 0) {
-        Tensor new_b = Tensor_new(result_shape, orig_b.node != NULL);
-        for(int i = 0; i < new_b.data->numel; i++) {
-            int rem = i;
-            int idx[4] = {0};
-            for(int d = max_ndims - 1; d >= 0; d--) {
-                idx[d] = rem % result_shape[d];
-                rem /= result_shape[d];
-            }
-
-            int source_idx = 0;
-            int stride = 1;
-            for(int d = b_ndims - 1; d >= 0; d--) {
-                int original_dim_size = orig_b.shape[d];
-                int result_dim_coord = idx[max_ndims - b_ndims + d];
-                int dim_idx = (original_dim_size == 1) ? 0 : result_dim_coord;
-                source_idx += dim_idx * stride;
-                stride *= original_dim_size;
-            }
-            new_b.data->flex[i] = orig_b.data->flex[source_idx];
-        }
-        *b = new_b;
+        *b = broadcast_expand(orig_b, result_shape, max_ndims);
     }
     return true;
 }
@@ -331,7 +242,7 @@ Tensor reduce_gradient_for_broadcasting(Tensor grad,
                                         TensorShape broadcasted_shape) {
     Tensor result = grad;
 
-    for(int dim = 3; dim >= 0; dim--) {
+    for(int dim = CTEN_MAX_DIMS - 1; dim >= 0; dim--) {
         int orig_size = original_shape[dim];
         int broad_size = broadcasted_shape[dim];
         int grad_size = result.shape[dim];
@@ -339,19 +250,17 @@ Tensor reduce_gradient_for_broadcasting(Tensor grad,
         // Case 1: dim was broadcasted from size 1 to size N
         if(orig_size == 1 && broad_size > 1 && grad_size == broad_size) {
             Tensor summed = Tensor_sum(result, dim);
-            TensorShape new_shape = {result.shape[0],
-                                     result.shape[1],
-                                     result.shape[2],
-                                     result.shape[3]};
+            TensorShape new_shape;
+            memcpy(new_shape, result.shape, sizeof(TensorShape));
             new_shape[dim] = 1;
             result = Tensor_new(new_shape, false);
 
             if(summed.data->numel == 1) {
-                for(int i = 0; i < result.data->numel; i++) {
+                for(size_t i = 0; i < result.data->numel; i++) {
                     result.data->flex[i] = summed.data->flex[0];
                 }
             } else {
-                for(int i = 0; i < result.data->numel && i < summed.data->numel; i++) {
+                for(size_t i = 0; i < result.data->numel && i < summed.data->numel; i++) {
                     result.data->flex[i] = summed.data->flex[i];
                 }
             }
@@ -359,17 +268,14 @@ Tensor reduce_gradient_for_broadcasting(Tensor grad,
         // Case 2: dim was added (original was 0, broadcasted > 0)
         else if(orig_size == 0 && broad_size > 0 && grad_size == broad_size) {
             Tensor summed = Tensor_sum(result, dim);
-            TensorShape new_shape = {result.shape[0],
-                                     result.shape[1],
-                                     result.shape[2],
-                                     result.shape[3]};
-            new_shape[dim] = 0;
-            for(int d = dim; d < 3; d++) {
-                if(d + 1 < 4) { new_shape[d] = new_shape[d + 1]; }
+            TensorShape new_shape;
+            memcpy(new_shape, result.shape, sizeof(TensorShape));
+            for(int d = dim; d < CTEN_MAX_DIMS - 1; d++) {
+                new_shape[d] = new_shape[d + 1];
             }
-            new_shape[3] = 0;  // clearing last dim
+            new_shape[CTEN_MAX_DIMS - 1] = 0;  // clearing last dim
             result = Tensor_new(new_shape, false);
-            for(int i = 0; i < result.data->numel && i < summed.data->numel; i++) {
+            for(size_t i = 0; i < result.data->numel && i < summed.data->numel; i++) {
                 result.data->flex[i] = summed.data->flex[i];
             }
         }
@@ -430,9 +336,8 @@ void Tensor_shuffle_dataset(const float (*X)[4],
     }
 
     // Fisher-Yates shuffle
-    srand((unsigned)time(NULL));
     for(int i = n_samples - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
+        int j = (int)(_cten_rand_u32() % (uint32_t)(i + 1));
         int tmp = indices[i];
         indices[i] = indices[j];
         indices[j] = tmp;
@@ -450,82 +355,30 @@ void Tensor_shuffle_dataset(const float (*X)[4],
 }
 
 Tensor Tensor_reduce_dim(Tensor self, int dim, const char* operation) {
-    int ndim = TensorShape_dim(self.shape);
-    if(dim < 0) {
-        if(dim < -ndim) {
-            printf("dim %d out of range", dim);
-            exit(-1);
-        }
-        dim += ndim;
-    }
-    if(dim >= ndim) {
-        printf("dim %d out of range", dim);
-        exit(-1);
-    }
-
-    TensorShape out_shape = {0, 0, 0, 0};
-    int out_idx = 0;
-    for(int i = 0; i < ndim; i++) {
-        if(i != dim) { out_shape[out_idx++] = self.shape[i]; }
-    }
-
-    int dim_size = self.shape[dim];
-    Tensor res = Tensor_zeros(out_shape, self.node != NULL);
-
-    int total_out_elements = res.data->numel;
-
-    for(int out_i = 0; out_i < total_out_elements; out_i++) {
-        int out_indices[4] = {0};
-        int remaining = out_i;
-        for(int j = out_idx - 1; j >= 0; j--) {
-            out_indices[j] = remaining % out_shape[j];
-            remaining /= out_shape[j];
-        }
-
-        for(int d = 0; d < dim_size; d++) {
-            int in_indices[4] = {0};
-            int out_pos = 0;
-            for(int j = 0; j < ndim; j++) {
-                if(j == dim) {
-                    in_indices[j] = d;
-                } else {
-                    in_indices[j] = out_indices[out_pos++];
-                }
-            }
-
-            int in_linear = 0;
-            int stride = 1;
-            for(int j = ndim - 1; j >= 0; j--) {
-                in_linear += in_indices[j] * stride;
-                stride *= self.shape[j];
-            }
-
-            res.data->flex[out_i] += self.data->flex[in_linear];
-        }
-
-        if(strcmp(operation, "mean") == 0) { res.data->flex[out_i] /= dim_size; }
-    }
-
-    return res;
+    self = _cten_as_f32(self);
+    dim = TensorShape_asdim(self.shape, dim);
+    TensorReduceOp op = strcmp(operation, "mean") == 0 ? TensorReduceOp_Mean : TensorReduceOp_Sum;
+    return _cten_reduce(self, op, 1 << dim, false, self.node != NULL, NULL);
 }
 
 Tensor Tensor_unsqueeze(Tensor self, int dim) {
-    int old_ndim = TensorShape_dim(self.shape);
+    int old_ndim = self.ndim;
     cten_assert(dim >= 0 && dim <= old_ndim, "Unsqueeze dim out of bounds");
+    cten_assert(old_ndim < CTEN_MAX_DIMS, "Unsqueeze exceeds %d dimensions", CTEN_MAX_DIMS);
 
     TensorShape new_shape = {0};
     int old_idx = 0;
     // insert a '1' at the 'dim' position in the new shape.
-    for(int i = 0; i < old_ndim + 1 && i < 4; i++) {
+    for(int i = 0; i < old_ndim + 1; i++) {
         if(i == dim) {
             new_shape[i] = 1;
         } else {
-            if(old_idx < 4) { new_shape[i] = self.shape[old_idx++]; }
+            new_shape[i] = self.shape[old_idx++];
         }
     }
 
     Tensor res = self;
-    memcpy(res.shape, new_shape, sizeof(TensorShape));
+    _cten_set_shape(&res, new_shape);
 
     return res;
 }
@@ -537,10 +390,8 @@ void cten_clip_grad_norm(Tensor* params, int n_params, float max_norm) {
     for(int i = 0; i < n_params; i++) {
         Tensor t = params[i];
         if(t.node == NULL || t.node->grad.data == NULL) { continue; }
-        for(int j = 0; j < t.data->numel; j++) {
-            float g = t.node->grad.data->flex[j];
-            total_norm += g * g;
-        }
+        const float* g = t.node->grad.data->flex;
+        total_norm += _cten_kernels.dot(g, g, t.data->numel);
     }
     total_norm = sqrtf(total_norm);
     if(total_norm > max_norm) {
@@ -548,9 +399,9 @@ void cten_clip_grad_norm(Tensor* params, int n_params, float max_norm) {
         for(int i = 0; i < n_params; i++) {
             Tensor t = params[i];
             if(t.node == NULL || t.node->grad.data == NULL) { continue; }
-            for(int j = 0; j < t.data->numel; j++) {
-                t.node->grad.data->flex[j] *= scale;
-            }
+            _cten_assert_writable("cten_clip_grad_norm()", t.node->grad);
+            float* g = t.node->grad.data->flex;
+            _cten_kernels.scale(g, scale, g, t.data->numel);
         }
     }
 }
@@ -569,8 +420,9 @@ void cten_clip_grad_value_range(Tensor* params, int n_params, float min_value, f
     for(int i = 0; i < n_params; i++) {
         Tensor t = params[i];
         if(t.node == NULL || t.node->grad.data == NULL) { continue; }
+        _cten_assert_writable("cten_clip_grad_value_range()", t.node->grad);
 
-        for(int j = 0; j < t.data->numel; j++) {
+        for(size_t j = 0; j < t.data->numel; j++) {
             float* grad_ptr = &t.node->grad.data->flex[j];
             float grad_val = *grad_ptr;
             total_count++;
@@ -593,8 +445,9 @@ void cten_clip_grad_positive(Tensor* params, int n_params, float max_value) {
     for(int i = 0; i < n_params; i++) {
         Tensor t = params[i];
         if(t.node == NULL || t.node->grad.data == NULL) continue;
+        _cten_assert_writable("cten_clip_grad_positive()", t.node->grad);
 
-        for(int j = 0; j < t.data->numel; j++) {
+        for(size_t j = 0; j < t.data->numel; j++) {
             float* grad_ptr = &t.node->grad.data->flex[j];
             float grad_val = *grad_ptr;
             total_count++;
@@ -615,8 +468,9 @@ void cten_clip_grad_negative(Tensor* params, int n_params, float min_value) {
     for(int i = 0; i < n_params; i++) {
         Tensor t = params[i];
         if(t.node == NULL || t.node->grad.data == NULL) continue;
+        _cten_assert_writable("cten_clip_grad_negative()", t.node->grad);
 
-        for(int j = 0; j < t.data->numel; j++) {
+        for(size_t j = 0; j < t.data->numel; j++) {
             float* grad_ptr = &t.node->grad.data->flex[j];
             float grad_val = *grad_ptr;
             total_count++;
@@ -87,13 +87,9 @@ int main() {
             int current_batch_size = (i + batch_size > n_train_samples) ? (n_train_samples - i) : batch_size;
 
             cten_begin_malloc(PoolId_Default);
-            Tensor input = Tensor_zeros((TensorShape){current_batch_size, 1}, false);
-            Tensor y_true = Tensor_zeros((TensorShape){current_batch_size, 1}, false);
-
-            for (int j = 0; j < current_batch_size; j++) {
-                input.data->flex[j] = x_data[i + j];
-                y_true.data->flex[j] = y_data[i + j];
-            }
+            // view the batch in place, the samples are never copied
+            Tensor input = Tensor_from_buffer((TensorShape){current_batch_size, 1}, x_data + i, FloatBuffer_ReadOnly);
+            Tensor y_true = Tensor_from_buffer((TensorShape){current_batch_size, 1}, y_data + i, FloatBuffer_ReadOnly);
 
             optim_adam_zerograd(optimizer);
             Tensor y_pred = Model_forward(&model, input);
@@ -129,8 +125,7 @@ int main() {
     float total_test_mse = 0;
     for (int i = n_train_samples; i < n_samples; i++) {
         cten_begin_malloc(PoolId_Default);
-        Tensor input = Tensor_zeros((TensorShape){1, 1}, false);
-        input.data->flex[0] = x_data[i];
+        Tensor input = Tensor_from_buffer((TensorShape){1, 1}, x_data + i, FloatBuffer_ReadOnly);
         
         Tensor y_pred = Model_forward(&model, input);
 
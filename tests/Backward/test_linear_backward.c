@@ -272,5 +272,201 @@ void test_linear_backward() {
         }
     }
 
+
+    // Test Case 5: Fused linear + activation matches the unfused graph, forward and backward
+    {
+        const char* tc_name = "linear_act_matches_unfused";
+        const nn_Activation acts[] = {nn_Activation_None,
+                                      nn_Activation_ReLU,
+                                      nn_Activation_Sigmoid,
+                                      nn_Activation_Tanh,
+                                      nn_Activation_ELU,
+                                      nn_Activation_SELU};
+        // {batch, in, out}: unpacked small path, then the packed GEMM with ragged tiles
+        const int shapes[][3] = {
+            {3,  5, 4 },
+            {10, 6, 11},
+        };
+        int sub_test_id = 1;
+        for(int s = 0; s < 2; s++) {
+            int batch = shapes[s][0], in = shapes[s][1], out = shapes[s][2];
+            for(int a = 0; a < (int)(sizeof(acts) / sizeof(acts[0])); a++) {
+                Tensor x[2], w[2], b[2];
+                for(int k = 0; k < 2; k++) {
+                    x[k] = Tensor_new((TensorShape){batch, in}, true);
+                    w[k] = Tensor_new((TensorShape){in, out}, true);
+                    b[k] = Tensor_new((TensorShape){1, out}, true);
+                    for(int i = 0; i < batch * in; i++) {
+                        x[k].data->flex[i] = ((i * 7) % 13 - 6) * 0.1f;
+                    }
+                    for(int i = 0; i < in * out; i++) {
+                        w[k].data->flex[i] = ((i * 5) % 11 - 5) * 0.1f;
+                    }
+                    for(int i = 0; i < out; i++) {
+                        b[k].data->flex[i] = (i % 3 - 1) * 0.2f;
+                    }
+                }
+                Tensor grad_output = Tensor_new((TensorShape){batch, out}, false);
+                for(int i = 0; i < batch * out; i++) {
+                    grad_output.data->flex[i] = ((i * 3) % 7 - 3) * 0.25f;
+                }
+
+                Tensor fused = nn_linear_act(x[0], w[0], b[0], acts[a]);
+                Tensor z = Tensor_add(Tensor_matmul(x[1], w[1]), b[1]);
+                Tensor unfused = z;
+                switch(acts[a]) {
+                    case nn_Activation_None: break;
+                    case nn_Activation_ReLU: unfused = nn_relu(z); break;
+                    case nn_Activation_Sigmoid: unfused = nn_sigmoid(z); break;
+                    case nn_Activation_Tanh: unfused = nn_tanh(z); break;
+                    case nn_Activation_ELU: unfused = nn_elu(z, 1.0f); break;
+                    case nn_Activation_SELU: unfused = nn_selu(z); break;
+                }
+                Tensor_backward(fused, grad_output);
+                Tensor_backward(unfused, grad_output);
+
+                compare_tensors(&fused, &unfused, op_name, tc_name, sub_test_id++, 1e-5f);
+                compare_tensors(&x[0].node->grad,
+                                &x[1].node->grad,
+                                op_name,
+                                tc_name,
+                                sub_test_id++,
+                                1e-5f);
+                compare_tensors(&w[0].node->grad,
+                                &w[1].node->grad,
+                                op_name,
+                                tc_name,
+                                sub_test_id++,
+                                1e-5f);
+                compare_tensors(&b[0].node->grad,
+                                &b[1].node->grad,
+                                op_name,
+                                tc_name,
+                                sub_test_id++,
+                                1e-5f);
+            }
+        }
+    }
+
+    // Test Case 6: Prepacked weights match unpacked ones and follow optimizer updates
+    {
+        const char* tc_name = "linear_packed_weight";
+        // {batch, in, out}: too few rows to use the panels, the packed GEMM over several KC
+        // slabs, and more columns than one NC block
+        const int shapes[][3] = {
+            {1,  300, 21  },
+            {12, 300, 21  },
+            {9,  5,   2100},
+        };
+        int sub_test_id = 1;
+        for(int s = 0; s < 3; s++) {
+            int batch = shapes[s][0], in = shapes[s][1], out = shapes[s][2];
+            Tensor x[2], w[2], b[2];
+            for(int k = 0; k < 2; k++) {
+                x[k] = Tensor_new((TensorShape){batch, in}, true);
+                w[k] = Tensor_new((TensorShape){in, out}, true);
+                b[k] = Tensor_new((TensorShape){1, out}, true);
+                for(int i = 0; i < batch * in; i++) {
+                    x[k].data->flex[i] = ((i * 7) % 13 - 6) * 0.1f;
+                }
+                for(int i = 0; i < in * out; i++) {
+                    w[k].data->flex[i] = ((i * 5) % 11 - 5) * 0.01f;
+                }
+                for(int i = 0; i < out; i++) {
+                    b[k].data->flex[i] = (i % 3 - 1) * 0.2f;
+                }
+            }
+            Tensor_pack_weight(w[0], true);
+            Tensor params[2][2] = {
+                {w[0], b[0]},
+                {w[1], b[1]},
+            };
+            optim_sgd* optimizer[2];
+            for(int k = 0; k < 2; k++) {
+                optimizer[k] = optim_sgd_new(2, params[k], 0.0f);
+                optim_sgd_config(optimizer[k], 0.1f, 0.0f);
+            }
+
+            // a training step, then a forward pass that must see the updated weight
+            for(int step = 0; step < 2; step++) {
+                Tensor y[2];
+                for(int k = 0; k < 2; k++) {
+                    optim_sgd_zerograd(optimizer[k]);
+                    y[k] = nn_linear_act(x[k], w[k], b[k], nn_Activation_ReLU);
+                    Tensor_backward(Tensor_sum(y[k]), (Tensor){0});
+                    optim_sgd_step(optimizer[k]);
+                }
+                compare_tensors(&y[0], &y[1], op_name, tc_name, sub_test_id++, 1e-4f);
+                compare_tensors(&x[0].node->grad,
+                                &x[1].node->grad,
+                                op_name,
+                                tc_name,
+                                sub_test_id++,
+                                1e-4f);
+                compare_tensors(&w[0].node->grad,
+                                &w[1].node->grad,
+                                op_name,
+                                tc_name,
+                                sub_test_id++,
+                                1e-4f);
+            }
+
+            // Tensor_matmul reads the same panels, and Tensor_set() invalidates them
+            Tensor_set(w[0], 0, 0, 0, 0, 0.5f);
+            Tensor_set(w[1], 0, 0, 0, 0, 0.5f);
+            Tensor m0 = Tensor_matmul(x[0], w[0]);
+            Tensor m1 = Tensor_matmul(x[1], w[1]);
+            compare_tensors(&m0, &m1, op_name, tc_name, sub_test_id++, 1e-4f);
+        }
+    }
+
+
+    // Test Case 7: Fused activation gradient when the first inputs need no gradient
+    {
+        const char* tc_name = "linear_act_constant_inputs";
+        int sub_test_id = 1;
+        // which of x, w and b require a gradient
+        const bool needs[][3] = {
+            {false, true,  true},
+            {false, false, true},
+        };
+        for(int c = 0; c < 2; c++) {
+            Tensor x[2], w[2], b[2], y[2];
+            for(int k = 0; k < 2; k++) {
+                x[k] = Tensor_new((TensorShape){4, 3}, needs[c][0]);
+                w[k] = Tensor_new((TensorShape){3, 5}, needs[c][1]);
+                b[k] = Tensor_new((TensorShape){1, 5}, needs[c][2]);
+                for(int i = 0; i < 12; i++) {
+                    x[k].data->flex[i] = ((i * 7) % 13 - 6) * 0.1f;
+                }
+                for(int i = 0; i < 15; i++) {
+                    w[k].data->flex[i] = ((i * 5) % 11 - 5) * 0.1f;
+                }
+                for(int i = 0; i < 5; i++) {
+                    b[k].data->flex[i] = (i % 3 - 1) * 0.2f;
+                }
+            }
+            y[0] = nn_linear_act(x[0], w[0], b[0], nn_Activation_Tanh);
+            y[1] = nn_tanh(Tensor_add(Tensor_matmul(x[1], w[1]), b[1]));
+            for(int k = 0; k < 2; k++) {
+                Tensor_backward(Tensor_sum(Tensor_mulf(y[k], 2.0f)), (Tensor){0});
+            }
+            if(needs[c][1]) {
+                compare_tensors(&w[0].node->grad,
+                                &w[1].node->grad,
+                                op_name,
+                                tc_name,
+                                sub_test_id++,
+                                1e-5f);
+            }
+            compare_tensors(&b[0].node->grad,
+                            &b[1].node->grad,
+                            op_name,
+                            tc_name,
+                            sub_test_id++,
+                            1e-5f);
+        }
+    }
+
     cten_free(pool_id);
 }
\ No newline at end of file
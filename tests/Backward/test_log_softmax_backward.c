@@ -0,0 +1,93 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+
+// dL/dx_j = g_j - softmax_j * sum_k(g_k) over each slice of x[outer, dim_size, inner]
+static void log_softmax_grad_reference(const float* x,
+                                       const float* g,
+                                       float* gx,
+                                       int outer,
+                                       int dim_size,
+                                       int inner) {
+    for(int o = 0; o < outer; o++) {
+        for(int in = 0; in < inner; in++) {
+            const float* xs = x + o * dim_size * inner + in;
+            const float* gs = g + o * dim_size * inner + in;
+            double max_val = -INFINITY, sum = 0.0, g_sum = 0.0;
+            for(int k = 0; k < dim_size; k++) {
+                max_val = fmax(max_val, xs[k * inner]);
+                g_sum += gs[k * inner];
+            }
+            for(int k = 0; k < dim_size; k++) {
+                sum += exp(xs[k * inner] - max_val);
+            }
+            for(int k = 0; k < dim_size; k++) {
+                double s = exp(xs[k * inner] - max_val) / sum;
+                gx[o * dim_size * inner + in + k * inner] = (float)(gs[k * inner] - s * g_sum);
+            }
+        }
+    }
+}
+
+void test_log_softmax_backward() {
+    const char* op_name = "log_softmax_backward";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    // Test Case 1: Short rows along the last dimension
+    {
+        const char* tc_name = "short_rows_last_dim";
+        TensorShape shape = {2, 3};
+        float x_data[] = {0.5f, -1.0f, 2.0f, 3.0f, 3.0f, -2.0f};
+        float g_data[] = {1.0f, 0.0f, -2.0f, 0.5f, 1.5f, 1.0f};
+        float exp_grad[6];
+        log_softmax_grad_reference(x_data, g_data, exp_grad, 2, 3, 1);
+
+        Tensor x = create_test_tensor(shape, x_data, true);
+        Tensor_backward(nn_log_softmax(x, 1), create_test_tensor(shape, g_data, false));
+        Tensor expected_grad = create_test_tensor(shape, exp_grad, false);
+        compare_tensors(&x.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 2: Strided dimension
+    {
+        const char* tc_name = "strided_dim_0";
+        TensorShape shape = {3, 4};
+        float x_data[] =
+            {0.1f, -0.4f, 1.2f, 0.0f, 2.2f, -1.0f, 0.3f, 0.9f, -0.7f, 0.6f, 1.1f, -2.0f};
+        float g_data[] =
+            {1.0f, -1.0f, 0.5f, 2.0f, 0.0f, 0.3f, -0.2f, 1.0f, 0.7f, 0.1f, 0.0f, -1.5f};
+        float exp_grad[12];
+        log_softmax_grad_reference(x_data, g_data, exp_grad, 1, 3, 4);
+
+        Tensor x = create_test_tensor(shape, x_data, true);
+        Tensor_backward(nn_log_softmax(x, 0), create_test_tensor(shape, g_data, false));
+        Tensor expected_grad = create_test_tensor(shape, exp_grad, false);
+        compare_tensors(&x.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 3: Long rows along the last dimension with a weighted upstream
+    {
+        const char* tc_name = "long_rows_last_dim_weighted";
+        enum { ROWS = 3, COLS = 400 };
+        static float x_data[ROWS * COLS];
+        static float g_data[ROWS * COLS];
+        static float exp_grad[ROWS * COLS];
+        for(int i = 0; i < ROWS * COLS; i++) {
+            x_data[i] = (float)((i * 41) % 67) * 0.2f - 6.0f;
+            g_data[i] = (float)((i * 13) % 7) * 0.5f - 1.5f;
+        }
+        log_softmax_grad_reference(x_data, g_data, exp_grad, ROWS, COLS, 1);
+
+        TensorShape shape = {ROWS, COLS};
+        Tensor x = create_test_tensor(shape, x_data, true);
+        Tensor_backward(nn_log_softmax(x, 1), create_test_tensor(shape, g_data, false));
+        Tensor expected_grad = create_test_tensor(shape, exp_grad, false);
+        compare_tensors(&x.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    cten_free(pool_id);
+}
@@ -145,5 +145,142 @@ void test_matmul_backward() {
         compare_tensors(&W.node->grad, &expected_grad_w, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
     }
 
+
+    // Test Case 5: Batched input against a shared weight, weighted by an upstream gradient
+    {
+        const char* tc_name = "matmul_batched_shared_weight_backward";
+        TensorShape a_shape = {2, 2, 3};
+        TensorShape b_shape = {3, 2};
+        TensorShape w_shape = {2, 2, 2};
+
+        float a_data[] =
+            {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+        float b_data[] = {1.0f, -1.0f, 2.0f, 0.0f, 0.0f, 3.0f};
+        float w_data[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+
+        // dz/dA[i] = W[i] @ B^T; dz/dB = sum_i A[i]^T @ W[i], since B is shared by both batches
+        float exp_grad_a[] =
+            {-1.0f, 2.0f, 6.0f, -1.0f, 6.0f, 12.0f, -1.0f, 10.0f, 18.0f, -1.0f, 14.0f, 24.0f};
+        float exp_grad_b[] = {118.0f, 140.0f, 134.0f, 160.0f, 150.0f, 180.0f};
+
+        Tensor A = create_test_tensor(a_shape, a_data, true);
+        Tensor B = create_test_tensor(b_shape, b_data, true);
+        Tensor W = create_test_tensor(w_shape, w_data, false);
+
+        Tensor z = Tensor_sum(Tensor_mul(Tensor_matmul(A, B), W));
+
+        Tensor grad_dummy = {0};
+        Tensor_backward(z, grad_dummy);
+
+        Tensor expected_grad_a = create_test_tensor(a_shape, exp_grad_a, false);
+        Tensor expected_grad_b = create_test_tensor(b_shape, exp_grad_b, false);
+
+        compare_tensors(&A.node->grad, &expected_grad_a, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        compare_tensors(&B.node->grad, &expected_grad_b, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 6: Both operands broadcast over different batch dimensions
+    {
+        const char* tc_name = "matmul_broadcast_batch_backward";
+        TensorShape a_shape = {2, 1, 2, 2};
+        TensorShape b_shape = {1, 3, 2, 2};
+
+        float a_data[] = {1.0f, 2.0f, 3.0f, 4.0f, -1.0f, 0.0f, 2.0f, 1.0f};
+        float b_data[] = {1.0f, 0.0f, 0.0f, 1.0f, 2.0f, 1.0f, 1.0f, 2.0f, 0.0f, -1.0f, 1.0f, 0.0f};
+
+        // each gradient is reduced over the batch dimension its operand was broadcast along
+        float exp_grad_a[] = {3.0f, 5.0f, 3.0f, 5.0f, 3.0f, 5.0f, 3.0f, 5.0f};
+        float exp_grad_b[] =
+            {5.0f, 5.0f, 7.0f, 7.0f, 5.0f, 5.0f, 7.0f, 7.0f, 5.0f, 5.0f, 7.0f, 7.0f};
+
+        Tensor A = create_test_tensor(a_shape, a_data, true);
+        Tensor B = create_test_tensor(b_shape, b_data, true);
+        Tensor C = Tensor_matmul(A, B);  // {2,3,2,2}
+        Tensor z = Tensor_sum(C);
+
+        Tensor grad_dummy = {0};
+        Tensor_backward(z, grad_dummy);
+
+        Tensor expected_grad_a = create_test_tensor(a_shape, exp_grad_a, false);
+        Tensor expected_grad_b = create_test_tensor(b_shape, exp_grad_b, false);
+
+        compare_tensors(&A.node->grad, &expected_grad_a, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        compare_tensors(&B.node->grad, &expected_grad_b, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+
+    // Test Case 7: Gradients large enough for the packed GEMM, read through transposed strides
+    {
+        const char* tc_name = "matmul_packed_transposed_backward";
+        const int m = 20, k = 13, n = 17;
+        Tensor A = Tensor_new((TensorShape){m, k}, true);
+        Tensor B = Tensor_new((TensorShape){k, n}, true);
+        Tensor W = Tensor_new((TensorShape){m, n}, false);
+        // small integers keep every partial sum exact
+        for(int i = 0; i < m * k; i++) A.data->flex[i] = (float)((i * 7) % 9 - 4);
+        for(int i = 0; i < k * n; i++) B.data->flex[i] = (float)((i * 5) % 7 - 3);
+        for(int i = 0; i < m * n; i++) W.data->flex[i] = (float)((i * 3) % 5 - 2);
+
+        // z = sum((A @ B) * W): dA = W @ B^T and dB = A^T @ W
+        Tensor expected_grad_a = Tensor_zeros((TensorShape){m, k}, false);
+        Tensor expected_grad_b = Tensor_zeros((TensorShape){k, n}, false);
+        for(int i = 0; i < m; i++) {
+            for(int kk = 0; kk < k; kk++) {
+                for(int j = 0; j < n; j++) {
+                    float w = W.data->flex[i * n + j];
+                    expected_grad_a.data->flex[i * k + kk] += w * B.data->flex[kk * n + j];
+                    expected_grad_b.data->flex[kk * n + j] += A.data->flex[i * k + kk] * w;
+                }
+            }
+        }
+
+        Tensor z = Tensor_sum(Tensor_mul(Tensor_matmul(A, B), W));
+        Tensor grad_dummy = {0};
+        Tensor_backward(z, grad_dummy);
+
+        compare_tensors(&A.node->grad, &expected_grad_a, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        compare_tensors(&B.node->grad, &expected_grad_b, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 8: Many small products, one operand shared across an outer batch dimension
+    {
+        const char* tc_name = "matmul_many_heads_backward";
+        // A is [heads, groups, m, k] and B is [groups, k, n]: B's gradient sums over the heads
+        const int heads = 6, groups = 4, m = 9, k = 8, n = 5;
+        Tensor A = Tensor_new((TensorShape){heads, groups, m, k}, true);
+        Tensor B = Tensor_new((TensorShape){groups, k, n}, true);
+        Tensor W = Tensor_new((TensorShape){heads, groups, m, n}, false);
+        for(int i = 0; i < (int)A.numel; i++) A.data->flex[i] = (float)((i * 7) % 9 - 4);
+        for(int i = 0; i < (int)B.numel; i++) B.data->flex[i] = (float)((i * 5) % 7 - 3);
+        for(int i = 0; i < (int)W.numel; i++) W.data->flex[i] = (float)((i * 3) % 5 - 2);
+
+        Tensor expected_grad_a = Tensor_zeros(A.shape, false);
+        Tensor expected_grad_b = Tensor_zeros(B.shape, false);
+        for(int h = 0; h < heads; h++) {
+            for(int g = 0; g < groups; g++) {
+                const float* a = A.data->flex + (h * groups + g) * m * k;
+                const float* b = B.data->flex + g * k * n;
+                const float* w = W.data->flex + (h * groups + g) * m * n;
+                float* da = expected_grad_a.data->flex + (h * groups + g) * m * k;
+                float* db = expected_grad_b.data->flex + g * k * n;
+                for(int i = 0; i < m; i++) {
+                    for(int kk = 0; kk < k; kk++) {
+                        for(int j = 0; j < n; j++) {
+                            da[i * k + kk] += w[i * n + j] * b[kk * n + j];
+                            db[kk * n + j] += a[i * k + kk] * w[i * n + j];
+                        }
+                    }
+                }
+            }
+        }
+
+        Tensor z = Tensor_sum(Tensor_mul(Tensor_matmul(A, B), W));
+        Tensor grad_dummy = {0};
+        Tensor_backward(z, grad_dummy);
+
+        compare_tensors(&A.node->grad, &expected_grad_a, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        compare_tensors(&B.node->grad, &expected_grad_b, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
     cten_free(pool_id);
 }
\ No newline at end of file
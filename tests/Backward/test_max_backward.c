@@ -162,5 +162,23 @@ void test_max_backward() {
         compare_tensors(&t.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
     }
 
+    // Test Case 8: The upstream gradient reaches the maxima only, scaled per output
+    {
+        const char* tc_name = "max_dim_sparse_upstream_backward";
+        TensorShape m_shape = {2, 3};
+        float data[] = {1.0f, 4.0f, 2.0f, 7.0f, -1.0f, 7.0f};
+        float w_data[] = {2.0f, -3.0f};
+        // z = sum(max(x, 1) * w): row 0 peaks at index 1, row 1 first at index 0
+        float exp_grad[] = {0.0f, 2.0f, 0.0f, -3.0f, 0.0f, 0.0f};
+
+        Tensor t = create_test_tensor(m_shape, data, true);
+        Tensor w = create_test_tensor((TensorShape){2}, w_data, false);
+        TensorMaxMinResult max_res = Tensor_max(t, 1);
+        Tensor_backward(Tensor_sum(Tensor_mul(max_res.values, w)), (Tensor){0});
+
+        Tensor expected_grad = create_test_tensor(m_shape, exp_grad, false);
+        compare_tensors(&t.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
     cten_free(pool_id);
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <stdio.h>
+
+// x[2, 3, 2] shared by the test cases
+static float x_data[] = {1.0f, -2.0f, 3.0f, 0.5f, 4.0f, -1.0f, 2.0f, 2.0f, -3.0f, 5.0f, 0.0f, 1.0f};
+
+void test_reduce_backward() {
+    const char* op_name = "reduce_backward";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+    TensorShape x_shape = {2, 3, 2};
+
+    // Test Case 1: Sum over non-adjacent dimensions, z = sum(reduce(x) * w)
+    {
+        const char* tc_name = "reduce_sum_multi_axis_backward";
+        int dims[] = {0, 2};
+        float w_data[] = {1.0f, 2.0f, 3.0f};
+        // dz/dx[i, j, k] = w[j]
+        float exp_grad[] = {1, 1, 2, 2, 3, 3, 1, 1, 2, 2, 3, 3};
+
+        Tensor x = create_test_tensor(x_shape, x_data, true);
+        Tensor w = create_test_tensor((TensorShape){3}, w_data, false);
+        Tensor r = Tensor_reduce(x, TensorReduceOp_Sum, dims, 2, false);
+        Tensor_backward(Tensor_sum(Tensor_mul(r, w)), (Tensor){0});
+
+        Tensor expected_grad = create_test_tensor(x_shape, exp_grad, false);
+        compare_tensors(&x.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 2: Mean with keepdim, z = sum(reduce(x) * w)
+    {
+        const char* tc_name = "reduce_mean_keepdim_backward";
+        int dim = 1;
+        float w_data[] = {1.0f, 2.0f, 3.0f, 4.0f};
+        // dz/dx[i, j, k] = w[i, 0, k] / 3
+        float exp_grad[12];
+        for(int i = 0; i < 12; i++) {
+            exp_grad[i] = w_data[(i / 6) * 2 + i % 2] / 3.0f;
+        }
+
+        Tensor x = create_test_tensor(x_shape, x_data, true);
+        Tensor w = create_test_tensor((TensorShape){2, 1, 2}, w_data, false);
+        Tensor r = Tensor_reduce(x, TensorReduceOp_Mean, &dim, 1, true);
+        Tensor_backward(Tensor_sum(Tensor_mul(r, w)), (Tensor){0});
+
+        Tensor expected_grad = create_test_tensor(x_shape, exp_grad, false);
+        compare_tensors(&x.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 3: Max sends the upstream gradient to the first maximum only
+    {
+        const char* tc_name = "reduce_max_first_position_backward";
+        int dims[] = {0, 2};
+        float w_data[] = {1.0f, 2.0f, 3.0f};
+        // maxima x[1, 0, 0] (tied with x[1, 0, 1]), x[1, 1, 1] and x[0, 2, 0]
+        float exp_grad[] = {0, 0, 0, 0, 3, 0, 1, 0, 0, 2, 0, 0};
+
+        Tensor x = create_test_tensor(x_shape, x_data, true);
+        Tensor w = create_test_tensor((TensorShape){3}, w_data, false);
+        Tensor r = Tensor_reduce(x, TensorReduceOp_Max, dims, 2, false);
+        Tensor_backward(Tensor_sum(Tensor_mul(r, w)), (Tensor){0});
+
+        Tensor expected_grad = create_test_tensor(x_shape, exp_grad, false);
+        compare_tensors(&x.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 4: The gradient of LogSumExp is the softmax of its input
+    {
+        const char* tc_name = "reduce_logsumexp_backward";
+        TensorShape l_shape = {2, 3};
+        float l_data[] = {1000.0f, 1001.0f, 1002.0f, -1.0f, 0.0f, 1.0f};
+        float exp_grad[] = {0.090031f, 0.244728f, 0.665241f, 0.090031f, 0.244728f, 0.665241f};
+        int dim = -1;
+
+        Tensor l = create_test_tensor(l_shape, l_data, true);
+        Tensor r = Tensor_reduce(l, TensorReduceOp_LogSumExp, &dim, 1, false);
+        Tensor_backward(Tensor_sum(r), (Tensor){0});
+
+        Tensor expected_grad = create_test_tensor(l_shape, exp_grad, false);
+        compare_tensors(&l.node->grad, &expected_grad, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    cten_free(pool_id);
+}
@@ -2,6 +2,7 @@
 #include "../test_utils.h"
 #include "../csv_reporter.h"
 #include "../test_config.h"
+#include <math.h>
 #include <stdio.h>
 
 void test_softmax_backward() {
@@ -551,5 +552,47 @@ void test_softmax_backward() {
                         TEST_FLOAT_TOLERANCE);
     }
 
+    // Test Case 11: Long rows over the last dimension with a varying upstream gradient
+    {
+        const char* tc_name = "long_rows_last_dim_weighted";
+        enum { rows = 2, cols = 700 };
+        static float input[rows * cols], upstream[rows * cols], expected[rows * cols];
+        for(int i = 0; i < rows * cols; i++) {
+            input[i] = (float)((i * 29) % 53) * 0.1f - 2.5f;
+            upstream[i] = (float)(i % 11) - 5.0f;
+        }
+        for(int r = 0; r < rows; r++) {
+            const float* x = input + r * cols;
+            const float* g = upstream + r * cols;
+            double s[cols], max_val = x[0], sum = 0.0, dot = 0.0;
+            for(int k = 1; k < cols; k++) {
+                max_val = fmax(max_val, x[k]);
+            }
+            for(int k = 0; k < cols; k++) {
+                s[k] = exp(x[k] - max_val);
+                sum += s[k];
+            }
+            for(int k = 0; k < cols; k++) {
+                s[k] /= sum;
+                dot += g[k] * s[k];
+            }
+            for(int k = 0; k < cols; k++) {
+                expected[r * cols + k] = (float)(s[k] * (g[k] - dot));
+            }
+        }
+        TensorShape shape = {rows, cols};
+        Tensor t_input = create_test_tensor(shape, input, true);
+        Tensor t_upstream = create_test_tensor(shape, upstream, false);
+        Tensor t_expected = create_test_tensor(shape, expected, false);
+
+        Tensor_backward(nn_softmax(t_input, 1), t_upstream);
+        compare_tensors(&t_input.node->grad,
+                        &t_expected,
+                        op_name,
+                        tc_name,
+                        1,
+                        TEST_FLOAT_TOLERANCE);
+    }
+
     cten_free(pool_id);
 }
@@ -474,5 +474,44 @@ void test_add_operator() {
         }
     }
 
+    // Test Case 7: Tensors beyond four dimensions
+    {
+        const char* tc_name = "add_high_rank_broadcasting";
+
+        // Sub-test 1: rank-7 + rank-3 broadcast in the middle dimensions
+        {
+            TensorShape s1 = {1, 1, 1, 1, 1, 2, 3};
+            TensorShape s2 = {2, 1, 1};
+            TensorShape exp_shape = {1, 1, 1, 1, 2, 2, 3};
+            float d1[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+            float d2[] = {10.0f, 20.0f};
+            float exp_d[] = {11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f,
+                             21.0f, 22.0f, 23.0f, 24.0f, 25.0f, 26.0f};
+
+            Tensor t1 = create_test_tensor(s1, d1, false);
+            Tensor t2 = create_test_tensor(s2, d2, false);
+            Tensor expected_res = create_test_tensor(exp_shape, exp_d, false);
+            Tensor actual_res = Tensor_add(t1, t2);
+
+            compare_tensors(&actual_res, &expected_res, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        }
+
+        // Sub-test 2: rank-8 + trailing row
+        {
+            TensorShape s1 = {1, 1, 1, 1, 1, 1, 2, 2};
+            TensorShape s2 = {2};
+            float d1[] = {1.0f, 2.0f, 3.0f, 4.0f};
+            float d2[] = {10.0f, 20.0f};
+            float exp_d[] = {11.0f, 22.0f, 13.0f, 24.0f};
+
+            Tensor t1 = create_test_tensor(s1, d1, false);
+            Tensor t2 = create_test_tensor(s2, d2, false);
+            Tensor expected_res = create_test_tensor(s1, exp_d, false);
+            Tensor actual_res = Tensor_add(t1, t2);
+
+            compare_tensors(&actual_res, &expected_res, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+        }
+    }
+
     cten_free(pool_id);
 }
@@ -0,0 +1,206 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#define SESSIONS 4
+#define SESSION_STEPS 20
+
+// A small regression model trained from a seeded initialization in its own context; returns the
+// final loss, so sessions with the same seed must agree exactly.
+static float train_session(uint64_t seed) {
+    cten_Context* ctx = cten_context_new();
+    cten_Context* prev = cten_set_context(ctx);
+    cten_seed(seed);
+    cten_begin_malloc(0);
+    Tensor w1 = Glorot_init((TensorShape){4, 16}, true);
+    Tensor b1 = Tensor_zeros((TensorShape){16}, true);
+    Tensor w2 = Glorot_init((TensorShape){16, 1}, true);
+    Tensor params[] = {w1, b1, w2};
+    optim_sgd* optim = optim_sgd_new(3, params, 0.0f);
+    optim_sgd_config(optim, 0.05f, 0.9f);
+    Tensor x = Tensor_new((TensorShape){32, 4}, false);
+    Tensor y = Tensor_new((TensorShape){32, 1}, false);
+    for(int i = 0; i < 32; i++) {
+        float sum = 0.0f;
+        for(int j = 0; j < 4; j++) {
+            float v = (float)((i * 5 + j * 3) % 11) / 11.0f - 0.5f;
+            x.data->flex[i * 4 + j] = v;
+            sum += v * (float)(j + 1);
+        }
+        y.data->flex[i] = sinf(sum);
+    }
+    cten_end_malloc();
+
+    float loss_value = 0.0f;
+    for(int step = 0; step < SESSION_STEPS; step++) {
+        cten_begin_malloc(1);
+        optim_sgd_zerograd(optim);
+        Tensor pred = Tensor_matmul(nn_elu(nn_linear(x, w1, b1), 0.5f), w2);
+        Tensor loss = nn_huber_loss(y, pred, 0.25f);
+        Tensor_backward(loss, (Tensor){0});
+        optim_sgd_step(optim);
+        loss_value = loss.data->flex[0];
+        cten_end_malloc();
+        cten_free(1);
+    }
+    cten_set_context(prev);
+    cten_context_free(ctx);
+    return loss_value;
+}
+
+#ifndef _WIN32
+typedef struct {
+    uint64_t seed;
+    float loss;
+} SessionArgs;
+
+static void* session_thread(void* p) {
+    SessionArgs* args = p;
+    args->loss = train_session(args->seed);
+    return NULL;
+}
+#endif
+
+void test_context_operator() {
+    const char* op_name = "context";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    // Test Case 1: Eval mode and pools belong to the bound context
+    {
+        const char* tc_name = "context_isolation";
+        cten_Context* ctx = cten_context_new();
+        cten_Context* prev = cten_set_context(ctx);
+        bool bound = cten_context() == ctx;
+        cten_begin_eval();
+        cten_set_context(prev);
+        bool default_eval = cten_is_eval();
+        cten_set_context(ctx);
+        bool ctx_eval = cten_is_eval();
+        cten_end_eval();
+        cten_set_context(prev);
+        // freeing pool 0 of ctx leaves the default context's pool 0 alone
+        Tensor t = Tensor_ones((TensorShape){3}, false);
+        cten_set_context(ctx);
+        cten_begin_malloc(pool_id);
+        Tensor_ones((TensorShape){3}, false);
+        cten_end_malloc();
+        cten_free(pool_id);
+        cten_set_context(prev);
+        bool kept = t.data->flex[2] == 1.0f;
+        cten_set_context(ctx);
+        cten_context_free(ctx);
+        bool restored = cten_context() == prev;
+        bool ok = bound && !default_eval && ctx_eval && kept && restored;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   ok ? "/" : "context_state_leaked/" PLATFORM_NAME);
+    }
+
+    // Test Case 2: Seeding makes initialization reproducible in any context
+    {
+        const char* tc_name = "seeded_init";
+        cten_seed(42);
+        Tensor a = Glorot_init((TensorShape){8, 8}, false);
+        cten_Context* ctx = cten_context_new();
+        cten_Context* prev = cten_set_context(ctx);
+        cten_seed(42);
+        cten_begin_malloc(pool_id);
+        Tensor b = Glorot_init((TensorShape){8, 8}, false);
+        Tensor c = Glorot_init((TensorShape){8, 8}, false);
+        cten_end_malloc();
+        bool same = memcmp(a.data->flex, b.data->flex, sizeof(float) * 64) == 0;
+        bool advanced = memcmp(b.data->flex, c.data->flex, sizeof(float) * 64) != 0;
+        bool in_range = true;
+        float scale = sqrtf(6.0f / 16.0f);
+        for(int i = 0; i < 64; i++) {
+            in_range = in_range && fabsf(a.data->flex[i]) <= scale;
+        }
+        cten_set_context(prev);
+        cten_context_free(ctx);
+        bool ok = same && advanced && in_range;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   ok ? "/" : "seed_not_reproducible/" PLATFORM_NAME);
+    }
+
+    // Test Case 3: Each ELU node keeps its own alpha for the backward pass
+    {
+        const char* tc_name = "elu_alpha_per_node";
+        TensorShape shape = {2};
+        float x_data[] = {-1.0f, 2.0f};
+        Tensor x = create_test_tensor(shape, x_data, true);
+        Tensor y1 = nn_elu(x, 0.5f);
+        Tensor y2 = nn_elu(x, 2.0f);
+        Tensor_backward(Tensor_sum(y1), (Tensor){0});
+        float exp_d1[] = {0.5f * expf(-1.0f), 1.0f};
+        Tensor expected = create_test_tensor(shape, exp_d1, false);
+        compare_tensors(&x.node->grad, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        x.node->grad = (Tensor){0};
+        Tensor_backward(Tensor_sum(y2), (Tensor){0});
+        float exp_d2[] = {2.0f * expf(-1.0f), 1.0f};
+        expected = create_test_tensor(shape, exp_d2, false);
+        compare_tensors(&x.node->grad, &expected, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 4: Each Huber loss node keeps its own delta for the backward pass
+    {
+        const char* tc_name = "huber_delta_per_node";
+        TensorShape shape = {2};
+        float t_data[] = {0.0f, 0.0f};
+        float p_data[] = {0.5f, -3.0f};
+        Tensor y_true = create_test_tensor(shape, t_data, false);
+        Tensor y_pred = create_test_tensor(shape, p_data, true);
+        Tensor loss1 = nn_huber_loss(y_true, y_pred, 1.0f);
+        Tensor loss2 = nn_huber_loss(y_true, y_pred, 0.1f);
+        Tensor_backward(loss1, (Tensor){0});
+        float exp_d1[] = {0.25f, -0.5f};
+        Tensor expected = create_test_tensor(shape, exp_d1, false);
+        compare_tensors(&y_pred.node->grad, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        y_pred.node->grad = (Tensor){0};
+        Tensor_backward(loss2, (Tensor){0});
+        float exp_d2[] = {0.05f, -0.05f};
+        expected = create_test_tensor(shape, exp_d2, false);
+        compare_tensors(&y_pred.node->grad, &expected, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 5: Training sessions on concurrent threads match the same sessions run in turn
+    {
+        const char* tc_name = "concurrent_sessions";
+        float serial[SESSIONS];
+        for(int s = 0; s < SESSIONS; s++) {
+            serial[s] = train_session(100 + s);
+        }
+        bool ok = true;
+#ifndef _WIN32
+        pthread_t threads[SESSIONS];
+        SessionArgs args[SESSIONS];
+        for(int s = 0; s < SESSIONS; s++) {
+            args[s] = (SessionArgs){100 + s, NAN};
+            pthread_create(&threads[s], NULL, session_thread, &args[s]);
+        }
+        for(int s = 0; s < SESSIONS; s++) {
+            pthread_join(threads[s], NULL);
+            ok = ok && memcmp(&args[s].loss, &serial[s], sizeof(float)) == 0;
+        }
+#endif
+        for(int s = 0; s < SESSIONS; s++) {
+            ok = ok && isfinite(serial[s]);
+        }
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   ok ? "/" : "sessions_differ/" PLATFORM_NAME);
+    }
+
+    cten_free(pool_id);
+}
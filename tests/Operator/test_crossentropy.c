@@ -0,0 +1,224 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+
+static Tensor ce_of_softmax(Tensor y_true, Tensor z) {
+    return nn_crossentropy(y_true, nn_softmax(z, 1));
+}
+
+static Tensor nll_of_log_softmax(Tensor y_true, Tensor z) {
+    return nn_nll_loss(y_true, nn_log_softmax(z, 1));
+}
+
+void test_crossentropy_operator() {
+    const char* op_name = "crossentropy";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    int32_t labels_data[] = {2, 0, 1};
+    float onehot_data[] = {0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    TensorShape m_shape = {3, 3};
+
+    // Test Case 1: Int32 class labels give the same loss and gradient as one-hot targets
+    {
+        const char* tc_name = "crossentropy_int32_labels";
+        float probs_data[] = {0.2f, 0.3f, 0.5f, 0.7f, 0.2f, 0.1f, 0.25f, 0.25f, 0.5f};
+
+        Tensor labels = Tensor_from_int_buffer((TensorShape){3}, labels_data, FloatBuffer_ReadOnly);
+        Tensor onehot = create_test_tensor(m_shape, onehot_data, false);
+        Tensor p_sparse = create_test_tensor(m_shape, probs_data, true);
+        Tensor p_dense = create_test_tensor(m_shape, probs_data, true);
+
+        Tensor loss_sparse = nn_crossentropy(labels, p_sparse);
+        Tensor loss_dense = nn_crossentropy(onehot, p_dense);
+        compare_tensors(&loss_sparse, &loss_dense, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        Tensor_backward(loss_sparse, (Tensor){0});
+        Tensor_backward(loss_dense, (Tensor){0});
+        compare_tensors(&p_sparse.node->grad,
+                        &p_dense.node->grad,
+                        op_name,
+                        tc_name,
+                        2,
+                        TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 2: Softmax cross-entropy with labels converted from a float tensor
+    {
+        const char* tc_name = "softmax_crossentropy_int32_labels";
+        float logits_data[] = {1.5f, -0.3f, 0.2f, 0.0f, 2.0f, -1.0f, 0.7f, 0.7f, 0.1f};
+        float label_values[] = {2.0f, 0.0f, 1.0f};
+
+        Tensor labels = Tensor_to(create_test_tensor((TensorShape){3}, label_values, false),
+                                  TensorDType_I32);
+        Tensor onehot = create_test_tensor(m_shape, onehot_data, false);
+        Tensor z_sparse = create_test_tensor(m_shape, logits_data, true);
+        Tensor z_dense = create_test_tensor(m_shape, logits_data, true);
+
+        Tensor loss_sparse = nn_softmax_crossentropy(labels, z_sparse);
+        Tensor loss_dense = nn_softmax_crossentropy(onehot, z_dense);
+        compare_tensors(&loss_sparse, &loss_dense, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        Tensor_backward(loss_sparse, (Tensor){0});
+        Tensor_backward(loss_dense, (Tensor){0});
+        compare_tensors(&z_sparse.node->grad,
+                        &z_dense.node->grad,
+                        op_name,
+                        tc_name,
+                        2,
+                        TEST_FLOAT_TOLERANCE);
+
+        bool dtype_ok = Tensor_dtype(labels) == TensorDType_I32 && labels.data->flexi[0] == 2 &&
+                        labels.data->flexi[2] == 1;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   3,
+                                   dtype_ok ? "/" : "int32_labels_mismatch/" PLATFORM_NAME);
+    }
+
+    // Test Case 3: Long rows against a double reference, with a non-unit upstream gradient
+    {
+        const char* tc_name = "softmax_crossentropy_long_rows";
+        enum { ROWS = 4, COLS = 300 };
+        static float logits_data[ROWS * COLS];
+        static float exp_grad[ROWS * COLS];
+        int32_t row_labels[ROWS] = {0, 299, 17, 150};
+        double exp_loss = 0.0;
+        for(int r = 0; r < ROWS; r++) {
+            double max_val = -INFINITY, sum = 0.0;
+            for(int k = 0; k < COLS; k++) {
+                logits_data[r * COLS + k] = (float)((r * 131 + k * 29) % 97) * 0.125f - 6.0f;
+                max_val = fmax(max_val, logits_data[r * COLS + k]);
+            }
+            for(int k = 0; k < COLS; k++) {
+                sum += exp(logits_data[r * COLS + k] - max_val);
+            }
+            double lse = max_val + log(sum);
+            exp_loss += lse - logits_data[r * COLS + row_labels[r]];
+            for(int k = 0; k < COLS; k++) {
+                double onehot = k == row_labels[r] ? 1.0 : 0.0;
+                exp_grad[r * COLS + k] =
+                    (float)(2.0 * (exp(logits_data[r * COLS + k] - lse) - onehot) / ROWS);
+            }
+        }
+        float exp_loss_data[] = {(float)(exp_loss / ROWS)};
+        float upstream_data[] = {2.0f};
+
+        Tensor labels =
+            Tensor_from_int_buffer((TensorShape){ROWS}, row_labels, FloatBuffer_ReadOnly);
+        Tensor z = create_test_tensor((TensorShape){ROWS, COLS}, logits_data, true);
+        Tensor loss = nn_softmax_crossentropy(labels, z);
+        Tensor expected_loss = create_test_tensor((TensorShape){1}, exp_loss_data, false);
+        compare_tensors(&loss, &expected_loss, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        Tensor_backward(loss, create_test_tensor((TensorShape){1}, upstream_data, false));
+        Tensor expected_grad = create_test_tensor((TensorShape){ROWS, COLS}, exp_grad, false);
+        compare_tensors(&z.node->grad,
+                        &expected_grad,
+                        op_name,
+                        tc_name,
+                        2,
+                        TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 4: Confident wrong predictions give the exact loss instead of saturating
+    {
+        const char* tc_name = "softmax_crossentropy_large_logits";
+        float logits_data[] = {0.0f, 100.0f, 1000.0f, 1000.0f};
+        int32_t row_labels[] = {0, 1};
+        // 100 + log(1 + e^-100) and log(2), averaged over the two rows
+        float exp_data[] = {(100.0f + 0.693147f) / 2.0f};
+        // softmax - onehot over the two rows
+        float exp_grad[] = {-0.5f, 0.5f, 0.25f, -0.25f};
+
+        Tensor labels = Tensor_from_int_buffer((TensorShape){2}, row_labels, FloatBuffer_ReadOnly);
+        Tensor z = create_test_tensor((TensorShape){2, 2}, logits_data, true);
+        Tensor loss = nn_softmax_crossentropy(labels, z);
+        Tensor expected = create_test_tensor((TensorShape){1}, exp_data, false);
+        compare_tensors(&loss, &expected, op_name, tc_name, 1, 1e-3f);
+
+        Tensor_backward(loss, (Tensor){0});
+        Tensor expected_grad = create_test_tensor((TensorShape){2, 2}, exp_grad, false);
+        compare_tensors(&z.node->grad,
+                        &expected_grad,
+                        op_name,
+                        tc_name,
+                        2,
+                        TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 5: NLL of log-softmax matches softmax cross-entropy, for labels and one-hot
+    {
+        const char* tc_name = "nll_of_log_softmax";
+        float logits_data[] = {1.5f, -0.3f, 0.2f, 0.0f, 2.0f, -1.0f, 0.7f, 0.7f, 0.1f};
+        Tensor labels = Tensor_from_int_buffer((TensorShape){3}, labels_data, FloatBuffer_ReadOnly);
+        Tensor onehot = create_test_tensor(m_shape, onehot_data, false);
+        Tensor targets[] = {labels, onehot};
+
+        for(int t = 0; t < 2; t++) {
+            Tensor z_nll = create_test_tensor(m_shape, logits_data, true);
+            Tensor z_fused = create_test_tensor(m_shape, logits_data, true);
+            Tensor loss_nll = nn_nll_loss(targets[t], nn_log_softmax(z_nll, 1));
+            Tensor loss_fused = nn_softmax_crossentropy(targets[t], z_fused);
+            compare_tensors(&loss_nll,
+                            &loss_fused,
+                            op_name,
+                            tc_name,
+                            2 * t + 1,
+                            TEST_FLOAT_TOLERANCE);
+
+            Tensor_backward(loss_nll, (Tensor){0});
+            Tensor_backward(loss_fused, (Tensor){0});
+            compare_tensors(&z_nll.node->grad,
+                            &z_fused.node->grad,
+                            op_name,
+                            tc_name,
+                            2 * t + 2,
+                            TEST_FLOAT_TOLERANCE);
+        }
+    }
+
+    // Test Case 6: Gradients of the mean losses against central differences
+    {
+        const char* tc_name = "finite_difference";
+        enum { ROWS = 5, COLS = 4 };
+        float logits_data[ROWS * COLS];
+        for(int i = 0; i < ROWS * COLS; i++) {
+            logits_data[i] = (float)((i * 7) % 11) * 0.3f - 1.5f;
+        }
+        int32_t row_labels[ROWS] = {3, 0, 2, 1, 2};
+        Tensor labels =
+            Tensor_from_int_buffer((TensorShape){ROWS}, row_labels, FloatBuffer_ReadOnly);
+        Tensor (*losses[])(Tensor, Tensor) = {
+            nn_softmax_crossentropy,
+            ce_of_softmax,
+            nll_of_log_softmax,
+        };
+
+        for(int l = 0; l < 3; l++) {
+            Tensor z = create_test_tensor((TensorShape){ROWS, COLS}, logits_data, true);
+            Tensor_backward(losses[l](labels, z), (Tensor){0});
+
+            const float eps = 1e-2f;
+            float numeric[ROWS * COLS];
+            cten_begin_eval();
+            for(int i = 0; i < ROWS * COLS; i++) {
+                float saved = z.data->flex[i];
+                z.data->flex[i] = saved + eps;
+                float up = losses[l](labels, z).data->flex[0];
+                z.data->flex[i] = saved - eps;
+                float down = losses[l](labels, z).data->flex[0];
+                z.data->flex[i] = saved;
+                numeric[i] = (up - down) / (2.0f * eps);
+            }
+            cten_end_eval();
+            Tensor expected = create_test_tensor((TensorShape){ROWS, COLS}, numeric, false);
+            compare_tensors(&z.node->grad, &expected, op_name, tc_name, l + 1, 1e-3f);
+        }
+    }
+
+    cten_free(pool_id);
+}
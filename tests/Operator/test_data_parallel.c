@@ -0,0 +1,193 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// The regression loss of src2/main.c, on a shrunk model
+static Tensor dp_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    TestMlp* m = (TestMlp*)params;
+    float delta = *(float*)user;
+    Tensor h = nn_elu(nn_linear(x, m->w1, m->b1), 1.0f);
+    Tensor y_pred = nn_linear(h, m->w2, m->b2);
+    return Tensor_add(nn_huber_loss(y, y_pred, delta), Tensor_mulf(nn_mae_loss(y, y_pred), 0.3f));
+}
+
+// A linear softmax classifier on w1 and b1, for the losses that average over rows of logits
+static Tensor dp_ce_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    (void)user;
+    return nn_softmax_crossentropy(y, nn_linear(x, params[0], params[1]));
+}
+
+// The loss and gradients of the whole batch in one graph, against those of the trainer
+static void compare_with_serial(const char* op_name,
+                                const char* tc_name,
+                                int sub_test,
+                                int n_samples,
+                                int n_shards) {
+    float delta = 0.5f;
+    Tensor x, y;
+    create_test_sine_data(&x, &y, n_samples);
+    TestMlp serial = create_test_mlp(7, 1, 16, 1), parallel = create_test_mlp(7, 1, 16, 1);
+
+    Tensor loss = dp_loss((Tensor*)&serial, x, y, &delta);
+    Tensor_backward(loss, (Tensor){0});
+
+    nn_data_parallel* dp = nn_data_parallel_new(4, (Tensor*)&parallel, n_shards);
+    float dp_loss_value = nn_data_parallel_backward(dp, dp_loss, &delta, x, y);
+    nn_data_parallel_free(dp);
+
+    Tensor expected_loss = create_test_tensor((TensorShape){1}, loss.data->flex, false);
+    Tensor actual_loss = create_test_tensor((TensorShape){1}, &dp_loss_value, false);
+    compare_tensors(&actual_loss, &expected_loss, op_name, tc_name, sub_test * 10, 1e-5f);
+    Tensor* s = (Tensor*)&serial;
+    Tensor* p = (Tensor*)&parallel;
+    for(int i = 0; i < 4; i++) {
+        compare_tensors(&p[i].node->grad,
+                        &s[i].node->grad,
+                        op_name,
+                        tc_name,
+                        sub_test * 10 + i + 1,
+                        1e-5f);
+    }
+}
+
+void test_data_parallel_operator() {
+    const char* op_name = "data_parallel";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+    int saved_threads = cten_num_threads();
+    cten_set_num_threads(4);
+
+    // Test Case 1: Sharded gradients match the whole batch in one graph
+    {
+        const char* tc_name = "gradients_match_serial";
+        compare_with_serial(op_name, tc_name, 1, 64, 4);
+        compare_with_serial(op_name, tc_name, 2, 256, 3);
+    }
+
+    // Test Case 2: Uneven shards, and more shards than samples
+    {
+        const char* tc_name = "uneven_shards";
+        compare_with_serial(op_name, tc_name, 1, 10, 4);
+        compare_with_serial(op_name, tc_name, 2, 3, 5);
+    }
+
+    // Test Case 3: The gradients do not depend on the thread count
+    {
+        const char* tc_name = "thread_count_independent";
+        float delta = 0.5f;
+        Tensor x, y;
+        create_test_sine_data(&x, &y, 200);
+        TestMlp models[2];
+        for(int t = 0; t < 2; t++) {
+            cten_set_num_threads(t == 0 ? 1 : 4);
+            models[t] = create_test_mlp(11, 1, 16, 1);
+            nn_data_parallel* dp = nn_data_parallel_new(4, (Tensor*)&models[t], 8);
+            nn_data_parallel_backward(dp, dp_loss, &delta, x, y);
+            nn_data_parallel_free(dp);
+        }
+        cten_set_num_threads(4);
+        Tensor* a = (Tensor*)&models[0];
+        Tensor* b = (Tensor*)&models[1];
+        bool same = true;
+        for(int i = 0; i < 4; i++) {
+            same = same && memcmp(a[i].node->grad.data->flex,
+                                  b[i].node->grad.data->flex,
+                                  sizeof(float) * a[i].numel) == 0;
+        }
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   same ? "/" : "threaded_result_differs/" PLATFORM_NAME);
+    }
+
+    // Test Case 4: Repeated calls accumulate like Tensor_backward
+    {
+        const char* tc_name = "accumulates";
+        float delta = 0.5f;
+        Tensor x, y;
+        create_test_sine_data(&x, &y, 32);
+        TestMlp once = create_test_mlp(3, 1, 16, 1), twice = create_test_mlp(3, 1, 16, 1);
+        nn_data_parallel* dp_once = nn_data_parallel_new(4, (Tensor*)&once, 4);
+        nn_data_parallel* dp_twice = nn_data_parallel_new(4, (Tensor*)&twice, 4);
+        nn_data_parallel_backward(dp_once, dp_loss, &delta, x, y);
+        nn_data_parallel_backward(dp_twice, dp_loss, &delta, x, y);
+        nn_data_parallel_backward(dp_twice, dp_loss, &delta, x, y);
+        nn_data_parallel_free(dp_once);
+        nn_data_parallel_free(dp_twice);
+        Tensor doubled = Tensor_mulf(once.w1.node->grad, 2.0f);
+        compare_tensors(&twice.w1.node->grad, &doubled, op_name, tc_name, 1, 1e-6f);
+    }
+
+    // Test Case 5: Training with Adam follows the single-threaded run
+    {
+        const char* tc_name = "adam_training_matches";
+        float delta = 1.0f;
+        Tensor x, y;
+        create_test_sine_data(&x, &y, 128);
+        TestMlp serial = create_test_mlp(5, 1, 16, 1), parallel = create_test_mlp(5, 1, 16, 1);
+        optim_adam* opt_s = optim_adam_new(4, (Tensor*)&serial, 0.01f, 0.9f, 0.999f, 1e-8f, 0.0f);
+        optim_adam* opt_p = optim_adam_new(4, (Tensor*)&parallel, 0.01f, 0.9f, 0.999f, 1e-8f, 0.0f);
+        nn_data_parallel* dp = nn_data_parallel_new(4, (Tensor*)&parallel, 4);
+        float first_loss = 0.0f, last_loss = 0.0f;
+        for(int step = 0; step < 30; step++) {
+            optim_adam_zerograd(opt_s);
+            Tensor_backward(dp_loss((Tensor*)&serial, x, y, &delta), (Tensor){0});
+            optim_adam_step(opt_s);
+            optim_adam_zerograd(opt_p);
+            last_loss = nn_data_parallel_backward(dp, dp_loss, &delta, x, y);
+            if(step == 0) first_loss = last_loss;
+            optim_adam_step(opt_p);
+        }
+        nn_data_parallel_free(dp);
+        Tensor* s = (Tensor*)&serial;
+        Tensor* p = (Tensor*)&parallel;
+        for(int i = 0; i < 4; i++) {
+            compare_tensors(&p[i], &s[i], op_name, tc_name, i + 1, 1e-4f);
+        }
+        bool decreasing = last_loss < first_loss;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   5,
+                                   decreasing ? "/" : "loss_not_decreasing/" PLATFORM_NAME);
+    }
+
+    // Test Case 6: A softmax classifier's sharded gradients match the whole batch
+    {
+        const char* tc_name = "softmax_crossentropy_matches_serial";
+        Tensor x = Tensor_new((TensorShape){40, 4}, false);
+        int32_t labels[40];
+        for(int i = 0; i < 40; i++) {
+            for(int k = 0; k < 4; k++) {
+                x.data->flex[i * 4 + k] = (float)((i * 7 + k * 13) % 17) / 17.0f - 0.5f;
+            }
+            labels[i] = i % 3;
+        }
+        Tensor y = Tensor_from_int_buffer((TensorShape){40}, labels, FloatBuffer_ReadOnly);
+        Tensor params[2][2];
+        for(int k = 0; k < 2; k++) {
+            cten_seed(3);
+            params[k][0] = Glorot_init((TensorShape){4, 3}, true);
+            params[k][1] = Tensor_zeros((TensorShape){1, 3}, true);
+        }
+
+        Tensor_backward(dp_ce_loss(params[0], x, y, NULL), (Tensor){0});
+        nn_data_parallel* dp = nn_data_parallel_new(2, params[1], 4);
+        nn_data_parallel_backward(dp, dp_ce_loss, NULL, x, y);
+        nn_data_parallel_free(dp);
+        for(int i = 0; i < 2; i++) {
+            compare_tensors(&params[1][i].node->grad,
+                            &params[0][i].node->grad,
+                            op_name,
+                            tc_name,
+                            i + 1,
+                            1e-5f);
+        }
+    }
+
+    cten_set_num_threads(saved_threads);
+    cten_free(pool_id);
+}
@@ -0,0 +1,134 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+
+void test_dtype_operator() {
+    const char* op_name = "dtype";
+    const float exact = 1e-30f;  // conversions are deterministic, so compare exactly
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    // Test Case 1: Values representable in half precision survive a round trip exactly
+    {
+        const char* tc_name = "dtype_roundtrip_exact";
+        TensorShape v_shape = {6};
+        // includes the largest finite half and the smallest half subnormal (2^-24)
+        float d[] = {0.0f, 1.5f, -2.25f, 65504.0f, 5.9604645e-8f, -0.0009765625f};
+
+        Tensor t = create_test_tensor(v_shape, d, false);
+        Tensor f16 = Tensor_to(t, TensorDType_F16);
+        Tensor back = Tensor_to(f16, TensorDType_F32);
+        compare_tensors(&back, &t, op_name, tc_name, 1, exact);
+
+        bool dtype_ok = Tensor_dtype(t) == TensorDType_F32 &&
+                        Tensor_dtype(f16) == TensorDType_F16 &&
+                        Tensor_dtype(back) == TensorDType_F32 && f16.node == NULL;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   2,
+                                   dtype_ok ? "/" : "dtype_mismatch/" PLATFORM_NAME);
+    }
+
+    // Test Case 2: Narrowing rounds to nearest, ties to even
+    {
+        const char* tc_name = "dtype_round_nearest_even";
+        TensorShape v_shape = {4};
+        // 1 + 2^-11 and 1 + 3*2^-11 are ties for half; 1 + 2^-8 and 1 + 3*2^-8 for bfloat16
+        float d_f16[] = {1.00048828125f, 1.00146484375f, 65519.0f, 0.1f};
+        float exp_f16[] = {1.0f, 1.001953125f, 65504.0f, 0.0999755859375f};
+        float d_bf16[] = {1.00390625f, 1.01171875f, 3.0e38f, -1.0e-3f};
+        float exp_bf16[] = {1.0f, 1.015625f, 3.00405527e38f, -0.00099945068359375f};
+
+        Tensor t16 = create_test_tensor(v_shape, d_f16, false);
+        Tensor r16 = Tensor_to(Tensor_to(t16, TensorDType_F16), TensorDType_F32);
+        Tensor e16 = create_test_tensor(v_shape, exp_f16, false);
+        compare_tensors(&r16, &e16, op_name, tc_name, 1, exact);
+
+        Tensor tb = create_test_tensor(v_shape, d_bf16, false);
+        Tensor rb = Tensor_to(Tensor_to(tb, TensorDType_BF16), TensorDType_F32);
+        Tensor eb = create_test_tensor(v_shape, exp_bf16, false);
+        compare_tensors(&rb, &eb, op_name, tc_name, 2, exact);
+
+        // values past the half range saturate to infinity
+        float d_big[] = {1e6f, -1e6f};
+        Tensor big = Tensor_to(create_test_tensor((TensorShape){2}, d_big, false), TensorDType_F16);
+        bool overflow_ok = isinf(Tensor_get(big, 0, 0, 0, 0)) && Tensor_get(big, 1, 0, 0, 0) < 0;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   3,
+                                   overflow_ok ? "/" : "f16_overflow_not_inf/" PLATFORM_NAME);
+    }
+
+    // Test Case 3: Operators widen reduced-precision operands and compute in float32
+    {
+        const char* tc_name = "dtype_mixed_operands";
+        TensorShape m_shape = {2, 3};
+        float d_w[] = {0.5f, -1.0f, 2.0f, 4.0f, 0.25f, -3.0f};
+        float d_x[] = {1.0f, 2.0f};
+        float d_b[] = {1.0f, 1.0f, 1.0f};
+        float exp_mm[] = {8.5f, -0.5f, -4.0f};
+        float exp_add[] = {1.5f, 0.0f, 3.0f, 5.0f, 1.25f, -2.0f};
+        float exp_sum[] = {2.75f};
+
+        Tensor w = create_test_tensor(m_shape, d_w, false);
+        Tensor w_bf16 = Tensor_to(w, TensorDType_BF16);
+        Tensor w_f16 = Tensor_to(w, TensorDType_F16);
+        Tensor x = create_test_tensor((TensorShape){1, 2}, d_x, false);
+        Tensor b = create_test_tensor((TensorShape){3}, d_b, false);
+
+        Tensor mm = Tensor_matmul(x, w_bf16);
+        Tensor exp_mm_t = create_test_tensor((TensorShape){1, 3}, exp_mm, false);
+        compare_tensors(&mm, &exp_mm_t, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        Tensor added = Tensor_add(w_f16, b);
+        Tensor exp_add_t = create_test_tensor(m_shape, exp_add, false);
+        compare_tensors(&added, &exp_add_t, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+
+        Tensor summed = Tensor_sum(w_f16);
+        Tensor exp_sum_t = create_test_tensor((TensorShape){1}, exp_sum, false);
+        compare_tensors(&summed, &exp_sum_t, op_name, tc_name, 3, TEST_FLOAT_TOLERANCE);
+
+        bool f32_results = Tensor_dtype(mm) == TensorDType_F32 &&
+                           Tensor_dtype(added) == TensorDType_F32 &&
+                           Tensor_get(w_f16, 1, 2, 0, 0) == -3.0f;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   4,
+                                   f32_results ? "/" : "result_dtype_mismatch/" PLATFORM_NAME);
+    }
+
+
+    // Test Case 4: nn_linear with a half-precision weight matches float32, streamed for one row
+    // and through the GEMM (widened, then reading prepacked panels) for more
+    {
+        const char* tc_name = "linear_f16_weight";
+        enum { IN = 7, OUT = 5, MAX_ROWS = 12 };
+        float d_w[IN * OUT], d_x[MAX_ROWS * IN], d_b[OUT];
+        // quarters in [-2, 2) are exact in half precision
+        for(int i = 0; i < IN * OUT; i++) {
+            d_w[i] = (float)((i * 5) % 16) * 0.25f - 2.0f;
+        }
+        for(int i = 0; i < MAX_ROWS * IN; i++) {
+            d_x[i] = (float)((i * 7) % 13) * 0.1f - 0.6f;
+        }
+        for(int i = 0; i < OUT; i++) {
+            d_b[i] = (float)(i % 3) * 0.5f - 0.5f;
+        }
+        Tensor w = create_test_tensor((TensorShape){IN, OUT}, d_w, false);
+        Tensor b = create_test_tensor((TensorShape){1, OUT}, d_b, false);
+        const int rows[] = {1, MAX_ROWS, MAX_ROWS};
+        for(int c = 0; c < 3; c++) {
+            Tensor w_f16 = Tensor_to(w, TensorDType_F16);
+            if(c == 2) Tensor_pack_weight(w_f16, false);
+            Tensor x = create_test_tensor((TensorShape){rows[c], IN}, d_x, false);
+            Tensor actual = nn_linear_act(x, w_f16, b, nn_Activation_Tanh);
+            Tensor expected = nn_linear_act(x, w, b, nn_Activation_Tanh);
+            compare_tensors(&actual, &expected, op_name, tc_name, c + 1, TEST_FLOAT_TOLERANCE);
+        }
+    }
+
+    cten_free(pool_id);
+}
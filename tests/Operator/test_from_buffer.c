@@ -0,0 +1,54 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <stdio.h>
+
+void test_from_buffer_operator() {
+    const char* op_name = "from_buffer";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    // Test Case 1: Wrapping a caller array views its elements in place
+    {
+        const char* tc_name = "from_buffer_view";
+        TensorShape m_shape = {2, 3};
+        float storage[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+        Tensor t = Tensor_from_buffer(m_shape, storage, 0);
+        Tensor expected = create_test_tensor(m_shape, storage, false);
+        compare_tensors(&t, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        // writes through the caller array are visible without copying
+        storage[4] = 50.0f;
+        float exp_d[] = {50.0f};
+        Tensor picked = create_test_tensor((TensorShape){1}, exp_d, false);
+        Tensor observed = create_test_tensor((TensorShape){1}, NULL, false);
+        observed.data->flex[0] = t.data->flex[4];
+        compare_tensors(&observed, &picked, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 2: Read-only constant tables can feed operators
+    {
+        const char* tc_name = "from_buffer_readonly_operand";
+        static const float weights[] = {0.5f, -1.0f, 2.0f, 4.0f};
+        TensorShape w_shape = {2, 2};
+        float d_x[] = {1.0f, 2.0f};
+        float exp_d[] = {4.5f, 7.0f};
+
+        Tensor w = Tensor_from_buffer(w_shape, weights, FloatBuffer_ReadOnly);
+        Tensor x = create_test_tensor((TensorShape){1, 2}, d_x, false);
+        Tensor actual_res = Tensor_matmul(x, w);
+        Tensor expected_res = create_test_tensor((TensorShape){1, 2}, exp_d, false);
+        compare_tensors(&actual_res, &expected_res, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        bool flags_ok = Tensor_is_readonly(w) && !Tensor_is_readonly(actual_res) &&
+                        Tensor_is_readonly(Tensor_unsqueeze(w, 0));
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   2,
+                                   flags_ok ? "/" : "readonly_flag_mismatch/" PLATFORM_NAME);
+    }
+
+    cten_free(pool_id);
+}
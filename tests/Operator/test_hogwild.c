@@ -0,0 +1,179 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static Tensor hw_sine_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    TestMlp* m = (TestMlp*)params;
+    (void)user;
+    Tensor h = nn_elu(nn_linear(x, m->w1, m->b1), 1.0f);
+    return nn_mse_loss(y, nn_linear(h, m->w2, m->b2));
+}
+
+static Tensor hw_iris_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    TestMlp* m = (TestMlp*)params;
+    (void)user;
+    Tensor h = nn_relu(nn_linear(x, m->w1, m->b1));
+    return nn_softmax_crossentropy(y, nn_linear(h, m->w2, m->b2));
+}
+
+// The gradient of sum(w) is all ones, so every step moves each element by exactly -lr
+static Tensor hw_sum_loss(Tensor* params, Tensor x, Tensor y, void* user) {
+    (void)x;
+    (void)y;
+    (void)user;
+    return Tensor_sum(params[0]);
+}
+
+void test_hogwild_operator() {
+    const char* op_name = "hogwild";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+    int saved_threads = cten_num_threads();
+
+    // Test Case 1: One worker is minibatch SGD with momentum and weight decay
+    {
+        const char* tc_name = "single_worker_matches_sgd";
+        cten_set_num_threads(1);
+        Tensor x, y;
+        create_test_sine_data(&x, &y, 100);
+        TestMlp serial = create_test_mlp(9, 1, 8, 1), hogwild = create_test_mlp(9, 1, 8, 1);
+        optim_sgd* opt = optim_sgd_new(4, (Tensor*)&serial, 0.01f);
+        optim_sgd_config(opt, 0.05f, 0.9f);
+        float serial_loss = 0.0f;
+        for(int step = 0; step < 25; step++) {
+            // batches of 32 rows, the last one 4 rows long
+            int lo = step % 4 * 32, hi = lo + 32 < 100 ? lo + 32 : 100;
+            Tensor xb = Tensor_from_buffer((TensorShape){hi - lo, 1},
+                                           x.data->flex + lo,
+                                           FloatBuffer_ReadOnly);
+            Tensor yb = Tensor_from_buffer((TensorShape){hi - lo, 1},
+                                           y.data->flex + lo,
+                                           FloatBuffer_ReadOnly);
+            optim_sgd_zerograd(opt);
+            Tensor loss = hw_sine_loss((Tensor*)&serial, xb, yb, NULL);
+            Tensor_backward(loss, (Tensor){0});
+            optim_sgd_step(opt);
+            serial_loss += loss.data->flex[0] / 25.0f;
+        }
+
+        nn_hogwild* hw = nn_hogwild_new(4, (Tensor*)&hogwild, 1, 0.01f);
+        nn_hogwild_config(hw, 0.05f, 0.9f);
+        // each call starts again from the first batch, and the velocity carries over
+        float hw_loss = nn_hogwild_train(hw, hw_sine_loss, NULL, x, y, 32, 8) * 8.0f;
+        hw_loss += nn_hogwild_train(hw, hw_sine_loss, NULL, x, y, 32, 17) * 17.0f;
+        hw_loss /= 25.0f;
+        nn_hogwild_free(hw);
+        cten_set_num_threads(saved_threads);
+
+        Tensor* s = (Tensor*)&serial;
+        Tensor* h = (Tensor*)&hogwild;
+        for(int i = 0; i < 4; i++) {
+            compare_tensors(&h[i], &s[i], op_name, tc_name, i + 1, 1e-5f);
+        }
+        Tensor expected_loss = create_test_tensor((TensorShape){1}, &serial_loss, false);
+        Tensor actual_loss = create_test_tensor((TensorShape){1}, &hw_loss, false);
+        compare_tensors(&actual_loss, &expected_loss, op_name, tc_name, 5, 1e-5f);
+    }
+
+    // Test Case 2: Concurrent updates are never lost
+    {
+        const char* tc_name = "no_lost_updates";
+        cten_set_num_threads(4);
+        Tensor w = Tensor_zeros((TensorShape){64}, true);
+        Tensor frozen = Tensor_ones((TensorShape){8}, false);
+        Tensor params[] = {w, frozen};
+        Tensor x = Tensor_zeros((TensorShape){16, 1}, false);
+        nn_hogwild* hw = nn_hogwild_new(2, params, 4, 0.0f);
+        nn_hogwild_config(hw, 1.0f, 0.0f);
+        nn_hogwild_train(hw, hw_sum_loss, NULL, x, (Tensor){0}, 4, 1000);
+        float untouched = nn_hogwild_train(hw, hw_sum_loss, NULL, x, (Tensor){0}, 4, 0);
+        nn_hogwild_free(hw);
+        cten_set_num_threads(saved_threads);
+
+        bool exact = true;
+        for(int i = 0; i < 64; i++) {
+            exact = exact && w.data->flex[i] == -1000.0f;
+        }
+        bool frozen_kept = true;
+        for(int i = 0; i < 8; i++) {
+            frozen_kept = frozen_kept && frozen.data->flex[i] == 1.0f;
+        }
+        bool ok = exact && frozen_kept && w.node->grad.data == NULL && untouched == 0.0f;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   ok ? "/" : "update_lost/" PLATFORM_NAME);
+    }
+
+    // Test Case 3: Sine regression converges with concurrent workers
+    {
+        const char* tc_name = "sine_converges";
+        cten_set_num_threads(4);
+        Tensor x, y;
+        create_test_sine_data(&x, &y, 256);
+        TestMlp m = create_test_mlp(21, 1, 32, 1);
+        nn_hogwild* hw = nn_hogwild_new(4, (Tensor*)&m, 0, 0.0f);
+        nn_hogwild_config(hw, 0.02f, 0.9f);
+        float first = nn_hogwild_train(hw, hw_sine_loss, NULL, x, y, 16, 16);
+        float last = first;
+        for(int epoch = 0; epoch < 40; epoch++) {
+            last = nn_hogwild_train(hw, hw_sine_loss, NULL, x, y, 16, 16);
+        }
+        nn_hogwild_free(hw);
+        cten_set_num_threads(saved_threads);
+        bool ok = isfinite(last) && last < 0.25f * first;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   ok ? "/" : "loss_not_decreasing/" PLATFORM_NAME);
+    }
+
+    // Test Case 4: Iris classification reaches a high training accuracy
+    {
+        const char* tc_name = "iris_converges";
+        cten_set_num_threads(4);
+        const float(*X)[4];
+        const int* labels;
+        int n = load_iris_dataset(&X, &labels);
+        float X_norm[150][4], X_shuffled[150][4];
+        int y_shuffled[150];
+        Tensor_normalize_dataset(X, X_norm, n, n, 4);
+        cten_seed(5);
+        Tensor_shuffle_dataset((const float(*)[4])X_norm, labels, X_shuffled, y_shuffled, n, 4);
+        Tensor x = Tensor_from_buffer((TensorShape){n, 4},
+                                      (float*)X_shuffled,
+                                      FloatBuffer_ReadOnly);
+        Tensor y = Tensor_from_int_buffer((TensorShape){n},
+                                          (int32_t*)y_shuffled,
+                                          FloatBuffer_ReadOnly);
+
+        TestMlp m = create_test_mlp(13, 4, 16, 3);
+        nn_hogwild* hw = nn_hogwild_new(4, (Tensor*)&m, 0, 0.0f);
+        nn_hogwild_config(hw, 0.1f, 0.5f);
+        nn_hogwild_train(hw, hw_iris_loss, NULL, x, y, 10, 600);
+        nn_hogwild_free(hw);
+        cten_set_num_threads(saved_threads);
+
+        cten_begin_eval();
+        Tensor logits = nn_linear(nn_relu(nn_linear(x, m.w1, m.b1)), m.w2, m.b2);
+        cten_end_eval();
+        int pred[150];
+        Tensor_argmax(logits, pred);
+        int correct = 0;
+        for(int i = 0; i < n; i++) {
+            correct += pred[i] == y_shuffled[i];
+        }
+        bool ok = correct >= n * 9 / 10;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   ok ? "/" : "accuracy_too_low/" PLATFORM_NAME);
+    }
+
+    cten_set_num_threads(saved_threads);
+    cten_free(pool_id);
+}
@@ -0,0 +1,74 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <math.h>
+#include <stdio.h>
+
+void test_log_softmax_operator() {
+    const char* op_name = "log_softmax";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    float input_data[] = {-0.973596f, -0.593090f, 0.240839f,  0.778621f,  -0.619067f,
+                          1.254894f,  -0.395984f, -1.496162f, 0.154189f,  0.167212f,
+                          0.130392f,  -0.652786f, 0.904415f,  -0.958059f, -1.114413f,
+                          -0.863093f, -0.971413f, 0.044263f,  -0.548822f, 0.153366f};
+    TensorShape shape = {4, 5};
+
+    // Test Case 1: Last dimension matches log(softmax)
+    {
+        const char* tc_name = "log_softmax_last_dim";
+        Tensor x = create_test_tensor(shape, input_data, false);
+        Tensor res = nn_log_softmax(x, 1);
+        Tensor expected = nn_log(nn_softmax(x, 1));
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 2: Strided dimension matches log(softmax)
+    {
+        const char* tc_name = "log_softmax_strided_dim";
+        Tensor x = create_test_tensor(shape, input_data, false);
+        Tensor res = nn_log_softmax(x, 0);
+        Tensor expected = nn_log(nn_softmax(x, 0));
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 3: Confident rows stay finite where the probability underflows
+    {
+        const char* tc_name = "log_softmax_confident_rows";
+        float data[] = {0.0f, 200.0f, -300.0f, 0.0f};
+        float exp_data[] = {-200.0f, 0.0f, -300.0f, 0.0f};
+        Tensor x = create_test_tensor((TensorShape){2, 2}, data, false);
+        Tensor res = nn_log_softmax(x, 1);
+        Tensor expected = create_test_tensor((TensorShape){2, 2}, exp_data, false);
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 4: Long rows against a double reference
+    {
+        const char* tc_name = "log_softmax_long_rows";
+        enum { ROWS = 3, COLS = 500 };
+        static float data[ROWS * COLS];
+        static float exp_data[ROWS * COLS];
+        for(int r = 0; r < ROWS; r++) {
+            double max_val = -INFINITY, sum = 0.0;
+            for(int k = 0; k < COLS; k++) {
+                data[r * COLS + k] = (float)((r * 53 + k * 31) % 89) * 0.25f - 11.0f;
+                max_val = fmax(max_val, data[r * COLS + k]);
+            }
+            for(int k = 0; k < COLS; k++) {
+                sum += exp(data[r * COLS + k] - max_val);
+            }
+            for(int k = 0; k < COLS; k++) {
+                exp_data[r * COLS + k] = (float)(data[r * COLS + k] - max_val - log(sum));
+            }
+        }
+        Tensor x = create_test_tensor((TensorShape){ROWS, COLS}, data, false);
+        Tensor res = nn_log_softmax(x, 1);
+        Tensor expected = create_test_tensor((TensorShape){ROWS, COLS}, exp_data, false);
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    cten_free(pool_id);
+}
@@ -166,5 +166,88 @@ void test_max_operator() {
                         TEST_FLOAT_TOLERANCE);
     }
 
+    // Test Case 10: Indices come back as int32 and feed the backward pass directly
+    {
+        const char* tc_name = "max_dim_int32_indices";
+        TensorShape m_shape = {2, 3};
+        float d1[] = {5.0f, 9.0f, 7.0f, 2.0f, 1.0f, 8.0f};
+        float exp_grad[] = {0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+        Tensor t1 = create_test_tensor(m_shape, d1, true);
+        TensorMaxMinResult actual = Tensor_max(t1, 1);
+        bool idx_ok = Tensor_dtype(actual.indices) == TensorDType_I32 &&
+                      actual.indices.data->flexi[0] == 1 && actual.indices.data->flexi[1] == 2;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   idx_ok ? "/" : "int32_indices_mismatch/" PLATFORM_NAME);
+
+        Tensor_backward(Tensor_sum(actual.values), (Tensor){0});
+        Tensor expected_grad = create_test_tensor(m_shape, exp_grad, false);
+        compare_tensors(&t1.node->grad, &expected_grad, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 11: Max of a long vector, found in the vector body and in the ragged tail
+    {
+        const char* tc_name = "max_all_long_vector";
+        enum { n = 1027 };
+        static float d1[n];
+        for(int i = 0; i < n; i++) {
+            d1[i] = (float)(i % 17) - 8.0f;
+        }
+        float exp_body[] = {50.0f};
+        float exp_tail[] = {100.0f};
+
+        d1[500] = 50.0f;
+        Tensor t_body = create_test_tensor((TensorShape){n}, d1, false);
+        d1[n - 1] = 100.0f;
+        Tensor t_tail = create_test_tensor((TensorShape){n}, d1, false);
+
+        Tensor body = Tensor_max(t_body);
+        Tensor tail = Tensor_max(t_tail);
+        Tensor expected_body = create_test_tensor((TensorShape){1}, exp_body, false);
+        Tensor expected_tail = create_test_tensor((TensorShape){1}, exp_tail, false);
+        compare_tensors(&body, &expected_body, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+        compare_tensors(&tail, &expected_tail, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 12: Max along long rows keeps the first index across vector lanes and the tail
+    {
+        const char* tc_name = "max_dim_long_rows_first_index";
+        enum { rows = 3, cols = 70 };
+        static float d1[rows * cols];
+        for(int i = 0; i < rows * cols; i++) {
+            d1[i] = (float)(i % 7) - 3.0f;
+        }
+        // row 0: ties in different lanes, row 1: maximum in the tail, row 2: tail ties the body
+        d1[3] = d1[20] = d1[35] = 9.0f;
+        d1[cols + 66] = d1[cols + 67] = 9.0f;
+        d1[2 * cols + 10] = d1[2 * cols + 68] = 9.0f;
+        float exp_values[] = {9.0f, 9.0f, 9.0f};
+        int exp_indices[] = {3, 66, 10};
+
+        Tensor t = create_test_tensor((TensorShape){rows, cols}, d1, false);
+        TensorMaxMinResult actual = Tensor_max(t, 1);
+        Tensor expected_values = create_test_tensor((TensorShape){rows}, exp_values, false);
+        compare_tensors(&actual.values,
+                        &expected_values,
+                        op_name,
+                        tc_name,
+                        1,
+                        TEST_FLOAT_TOLERANCE);
+
+        int argmax[rows];
+        Tensor_argmax(t, argmax);
+        bool indices_ok = true;
+        for(int i = 0; i < rows; i++) {
+            indices_ok = indices_ok && actual.indices.data->flexi[i] == exp_indices[i] &&
+                         argmax[i] == exp_indices[i];
+        }
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   2,
+                                   indices_ok ? "/" : "indices/" PLATFORM_NAME);
+    }
+
     cten_free(pool_id);
 }
@@ -0,0 +1,93 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <stdio.h>
+
+void test_quantize_operator() {
+    const char* op_name = "quantize";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    // Test Case 1: Weights and inputs on the int8 grids only pick up float rounding
+    {
+        const char* tc_name = "qlinear_exact_grid";
+        // every column peaks at 1.27, so the weight scale is 0.01 and all weights are integers
+        float w_data[] = {1.27f, 0.02f, -0.5f, -1.27f, 0.25f, 0.64f};
+        float b_data[] = {0.1f, -0.2f};
+        float x_data[] = {0.5f, 1.0f, 2.55f, 0.0f, 0.01f, 1.23f};
+
+        Tensor w = create_test_tensor((TensorShape){3, 2}, w_data, false);
+        Tensor b = create_test_tensor((TensorShape){1, 2}, b_data, false);
+        Tensor x = create_test_tensor((TensorShape){2, 3}, x_data, false);
+
+        // a non-negative range puts the zero point at -128
+        nn_qrange range = nn_qrange_new();
+        nn_qrange_observe(&range, x);
+        nn_qlinear* q = nn_qlinear_new(w, b, range);
+
+        Tensor actual = nn_qlinear_forward(q, x);
+        Tensor expected = nn_linear(x, w, b);
+        compare_tensors(&actual, &expected, op_name, tc_name, 1, 1e-4f);
+    }
+
+    // Test Case 2: Signed activations and batched input stay within quantization error
+    {
+        const char* tc_name = "qlinear_matches_float";
+        float w_data[] = {0.31f,  -0.72f, 0.05f,  0.88f, -0.14f, -0.43f,
+                          -0.27f, 0.66f,  0.19f,  0.02f, -0.95f, 0.51f};
+        float b_data[] = {0.2f, -0.1f, 0.05f};
+        float x_data[] = {-0.9f, 0.4f, 0.15f, -0.3f, 0.7f,  -0.55f, 0.05f, 1.0f,
+                          0.25f, -1.0f, 0.6f, 0.8f,  -0.2f, 0.35f,  -0.75f, 0.1f};
+
+        Tensor w = create_test_tensor((TensorShape){4, 3}, w_data, false);
+        Tensor b = create_test_tensor((TensorShape){1, 3}, b_data, false);
+        Tensor x = create_test_tensor((TensorShape){4, 4}, x_data, false);
+
+        nn_qrange range = nn_qrange_new();
+        nn_qrange_observe(&range, x);
+        nn_qlinear* q = nn_qlinear_new(w, b, range);
+
+        Tensor actual = nn_qlinear_forward(q, x);
+        Tensor expected = nn_linear(x, w, b);
+        // half an input step (2/255) and half a weight step (~0.95/127) over four terms
+        compare_tensors(&actual, &expected, op_name, tc_name, 1, 0.03f);
+
+        // leading dimensions are flattened into the batch
+        Tensor x3 = create_test_tensor((TensorShape){2, 2, 4}, x_data, false);
+        Tensor actual3 = nn_qlinear_forward(q, x3);
+        Tensor expected3 = create_test_tensor((TensorShape){2, 2, 3}, actual.data->flex, false);
+        compare_tensors(&actual3, &expected3, op_name, tc_name, 2, 1e-6f);
+
+        bool smaller = nn_qlinear_nbytes(q) < sizeof(float) * (w.numel + b.numel) + 64;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   3,
+                                   smaller ? "/" : "qlinear_nbytes_not_smaller/" PLATFORM_NAME);
+    }
+
+    // Test Case 3: Inputs outside the calibrated range saturate at its edges
+    {
+        const char* tc_name = "qlinear_saturate";
+        float w_data[] = {0.5f, -1.0f};
+        float b_data[] = {0.0f, 0.25f};
+        float calib_data[] = {-1.0f, 2.0f};
+        float x_data[] = {10.0f, -10.0f};
+        float edge_data[] = {2.0f, -1.0f};
+
+        Tensor w = create_test_tensor((TensorShape){1, 2}, w_data, false);
+        Tensor b = create_test_tensor((TensorShape){1, 2}, b_data, false);
+        Tensor calib = create_test_tensor((TensorShape){2, 1}, calib_data, false);
+
+        nn_qrange range = nn_qrange_new();
+        nn_qrange_observe(&range, calib);
+        nn_qlinear* q = nn_qlinear_new(w, b, range);
+
+        Tensor actual = nn_qlinear_forward(q, create_test_tensor((TensorShape){2, 1}, x_data, false));
+        Tensor expected =
+            nn_qlinear_forward(q, create_test_tensor((TensorShape){2, 1}, edge_data, false));
+        compare_tensors(&actual, &expected, op_name, tc_name, 1, 1e-6f);
+    }
+
+    cten_free(pool_id);
+}
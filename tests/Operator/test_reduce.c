@@ -0,0 +1,135 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <stdio.h>
+
+// x[2, 3, 2] shared by the test cases
+static float x_data[] = {1.0f, -2.0f, 3.0f, 0.5f, 4.0f, -1.0f, 2.0f, 2.0f, -3.0f, 5.0f, 0.0f, 1.0f};
+
+void test_reduce_operator() {
+    const char* op_name = "reduce";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+    TensorShape x_shape = {2, 3, 2};
+
+    // Test Case 1: Sum over two non-adjacent dimensions, dropped and kept
+    {
+        const char* tc_name = "reduce_sum_multi_axis";
+        int dims[] = {0, 2};
+        float exp_data[] = {3.0f, 5.5f, 4.0f};
+        Tensor x = create_test_tensor(x_shape, x_data, false);
+
+        Tensor res = Tensor_reduce(x, TensorReduceOp_Sum, dims, 2, false);
+        Tensor expected = create_test_tensor((TensorShape){3}, exp_data, false);
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        Tensor res_keep = Tensor_reduce(x, TensorReduceOp_Sum, dims, 2, true);
+        Tensor expected_keep = create_test_tensor((TensorShape){1, 3, 1}, exp_data, false);
+        compare_tensors(&res_keep, &expected_keep, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 2: Mean over every dimension
+    {
+        const char* tc_name = "reduce_mean_all_dims";
+        float exp_data[] = {12.5f / 12.0f};
+        Tensor x = create_test_tensor(x_shape, x_data, false);
+        Tensor res = Tensor_reduce(x, TensorReduceOp_Mean, NULL, 0, false);
+        Tensor expected = create_test_tensor((TensorShape){1}, exp_data, false);
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 3: Max and min over the trailing dimensions, given as negative indices
+    {
+        const char* tc_name = "reduce_max_min_trailing";
+        int dims[] = {-1, -2};
+        float exp_max[] = {4.0f, 5.0f};
+        float exp_min[] = {-2.0f, -3.0f};
+        Tensor x = create_test_tensor(x_shape, x_data, false);
+
+        Tensor max = Tensor_reduce(x, TensorReduceOp_Max, dims, 2, false);
+        Tensor expected_max = create_test_tensor((TensorShape){2}, exp_max, false);
+        compare_tensors(&max, &expected_max, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+
+        Tensor min = Tensor_reduce(x, TensorReduceOp_Min, dims, 2, false);
+        Tensor expected_min = create_test_tensor((TensorShape){2}, exp_min, false);
+        compare_tensors(&min, &expected_min, op_name, tc_name, 2, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 4: ArgMax counts over the flattened reduced dimensions, first maximum on ties
+    {
+        const char* tc_name = "reduce_argmax";
+        int dims_trailing[] = {1, 2};
+        int dims_outer[] = {0, 2};
+        int exp_trailing[] = {4, 3};
+        int exp_outer[] = {2, 3, 0};  // x[:, 0, :] = {1, -2, 2, 2}
+        Tensor x = create_test_tensor(x_shape, x_data, false);
+
+        Tensor trailing = Tensor_reduce(x, TensorReduceOp_ArgMax, dims_trailing, 2, false);
+        Tensor outer = Tensor_reduce(x, TensorReduceOp_ArgMax, dims_outer, 2, false);
+        bool trailing_ok = Tensor_dtype(trailing) == TensorDType_I32 && trailing.numel == 2;
+        for(int i = 0; trailing_ok && i < 2; i++) {
+            trailing_ok = trailing.data->flexi[i] == exp_trailing[i];
+        }
+        bool outer_ok = Tensor_dtype(outer) == TensorDType_I32 && outer.numel == 3;
+        for(int i = 0; outer_ok && i < 3; i++) {
+            outer_ok = outer.data->flexi[i] == exp_outer[i];
+        }
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   trailing_ok ? "/" : "trailing/" PLATFORM_NAME);
+        csv_reporter_record_result(op_name, tc_name, 2, outer_ok ? "/" : "outer/" PLATFORM_NAME);
+    }
+
+    // Test Case 5: LogSumExp stays finite where exp overflows
+    {
+        const char* tc_name = "reduce_logsumexp_large_values";
+        TensorShape l_shape = {2, 3};
+        float l_data[] = {1000.0f, 1001.0f, 1002.0f, -1.0f, 0.0f, 1.0f};
+        // max + log(1 + e^-1 + e^-2)
+        float exp_data[] = {1002.407606f, 1.407606f};
+        int dim = 1;
+        Tensor l = create_test_tensor(l_shape, l_data, false);
+        Tensor res = Tensor_reduce(l, TensorReduceOp_LogSumExp, &dim, 1, false);
+        Tensor expected = create_test_tensor((TensorShape){2}, exp_data, false);
+        compare_tensors(&res, &expected, op_name, tc_name, 1, 1e-3f);
+    }
+
+    // Test Case 6: Kept and reduced dimensions interleaved, against a direct loop
+    {
+        const char* tc_name = "reduce_interleaved_matches_loop";
+        TensorShape shape = {2, 3, 4, 5};
+        float data[120];
+        for(int i = 0; i < 120; i++) {
+            data[i] = (float)((i * 37) % 23) - 11.0f;
+        }
+        float exp_data[8] = {0};
+        for(int a = 0; a < 2; a++) {
+            for(int b = 0; b < 3; b++) {
+                for(int c = 0; c < 4; c++) {
+                    for(int d = 0; d < 5; d++) {
+                        exp_data[a * 4 + c] += data[((a * 3 + b) * 4 + c) * 5 + d];
+                    }
+                }
+            }
+        }
+        int dims[] = {3, 1};
+        Tensor x = create_test_tensor(shape, data, false);
+        Tensor res = Tensor_reduce(x, TensorReduceOp_Sum, dims, 2, true);
+        Tensor expected = create_test_tensor((TensorShape){2, 1, 4, 1}, exp_data, false);
+        compare_tensors(&res, &expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 7: One multi-axis call matches chained single-axis sums
+    {
+        const char* tc_name = "reduce_matches_chained_sums";
+        int dims[] = {0, 1};
+        Tensor x = create_test_tensor(x_shape, x_data, false);
+        Tensor res = Tensor_reduce(x, TensorReduceOp_Sum, dims, 2, false);
+        Tensor chained = Tensor_sum(Tensor_sum(x, 1), 0);
+        compare_tensors(&res, &chained, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    cten_free(pool_id);
+}
@@ -0,0 +1,193 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#define SIMD_TEST_N 37
+#define SIMD_TEST_OPS 13
+#define SIMD_TEST_OUTPUTS (2 * SIMD_TEST_OPS + 2)
+
+// Forward results and input gradients of every dispatched elementwise kernel on x and y
+static int run_elementwise(const float* x_data, const float* y_data, Tensor* out) {
+    int n_out = 0;
+    TensorShape shape = {SIMD_TEST_N};
+    for(int op = 0; op < SIMD_TEST_OPS; op++) {
+        Tensor x = create_test_tensor(shape, (float*)x_data, true);
+        Tensor y = create_test_tensor(shape, (float*)y_data, true);
+        Tensor res;
+        switch(op) {
+            case 0: res = Tensor_add(x, y); break;
+            case 1: res = Tensor_sub(x, y); break;
+            case 2: res = Tensor_mul(x, y); break;
+            case 3: res = Tensor_div(x, y); break;
+            case 4: res = Tensor_abs(x); break;
+            case 5: res = Tensor_square(x); break;
+            case 6: res = Tensor_reciprocal(y); break;
+            case 7: res = nn_relu(x); break;
+            case 8: res = nn_sigmoid(x); break;
+            case 9: res = nn_tanh(x); break;
+            case 10: res = nn_exp(x); break;
+            case 11: res = nn_log(Tensor_square(y)); break;
+            default: res = nn_elu(x, 0.7f); break;
+        }
+        Tensor_backward(Tensor_sum(res), (Tensor){0});
+        out[n_out++] = res;
+        out[n_out++] = op == 6 || op == 11 ? y.node->grad : x.node->grad;
+    }
+    Tensor x = create_test_tensor(shape, (float*)x_data, true);
+    Tensor res = nn_selu(x);
+    Tensor_backward(Tensor_sum(res), (Tensor){0});
+    out[n_out++] = res;
+    out[n_out++] = x.node->grad;
+    return n_out;
+}
+
+// Runs every level against the portable kernels in the active math mode, one result per level
+// (the CSV keeps a single entry per sub-test)
+static void check_levels(const char* op_name, const char* tc_name, float rel_tolerance) {
+    float x_data[SIMD_TEST_N], y_data[SIMD_TEST_N];
+    for(int i = 0; i < SIMD_TEST_N; i++) {
+        x_data[i] = ((i * 7) % 19 - 9) * 0.25f;  // includes zeros
+        y_data[i] = ((i * 5) % 13 + 1) * (i % 2 ? 0.5f : -0.5f);
+    }
+
+    cten_SimdLevel best = cten_simd_level();
+    Tensor expected[SIMD_TEST_OUTPUTS], actual[SIMD_TEST_OUTPUTS];
+    cten_set_simd_level(cten_SimdLevel_Scalar);
+    int n_out = run_elementwise(x_data, y_data, expected);
+
+    int sub_test_id = 1;
+    for(int level = cten_SimdLevel_Scalar; level <= (int)best; level++) {
+        cten_SimdLevel selected = cten_set_simd_level((cten_SimdLevel)level);
+        run_elementwise(x_data, y_data, actual);
+        int mismatch = (int)selected == level ? -1 : n_out;
+        for(int k = 0; k < n_out && mismatch < 0; k++) {
+            for(size_t i = 0; i < expected[k].numel; i++) {
+                float a = actual[k].data->flex[i], e = expected[k].data->flex[i];
+                if(!compare_floats(a, e, rel_tolerance * fmaxf(1.0f, fabsf(e)))) mismatch = k;
+            }
+        }
+        char detail[64];
+        snprintf(detail,
+                 sizeof(detail),
+                 "%s_output_%d_mismatch/" PLATFORM_NAME,
+                 cten_simd_level_name(selected),
+                 mismatch);
+        csv_reporter_record_result(op_name, tc_name, sub_test_id++, mismatch < 0 ? "/" : detail);
+    }
+    cten_set_simd_level(best);
+}
+
+// Error of `got` in units in the last place of the float nearest to `ref`
+static double ulp_error(float got, double ref) {
+    if(isnan(ref) || isnan(got)) return isnan(ref) && isnan(got) ? 0.0 : INFINITY;
+    if(isinf((float)ref) || isinf(got)) return got == (float)ref ? 0.0 : INFINITY;
+    int exponent;
+    frexp(fmax(fabs(ref), FLT_MIN), &exponent);
+    return fabs(got - ref) / ldexp(1.0, exponent - 24);
+}
+
+void test_simd_operator() {
+    const char* op_name = "simd";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+
+    // Test Case 1: Every instruction set level matches the portable kernels, tails included
+    {
+        const char* tc_name = "simd_levels_match_scalar";
+        check_levels(op_name, tc_name, 1e-6f);
+    }
+
+    // Test Case 2: Fast math agrees across levels up to fused multiply-add rounding
+    {
+        const char* tc_name = "simd_levels_match_scalar_fast_math";
+        cten_set_math_mode(cten_MathMode_Fast);
+        check_levels(op_name, tc_name, 1e-6f);
+        cten_set_math_mode(cten_MathMode_Precise);
+    }
+
+    // Test Case 3: Fast math stays within its documented ULP bounds on a dense sweep
+    {
+        const char* tc_name = "fast_math_ulp_bounds";
+        enum { n = 40000 };
+        static float x_data[n];
+        const char* names[] = {"exp", "log", "sigmoid", "tanh", "elu"};
+        const double bounds[] = {1.5, 1.5, 3.0, 2.0, 2.0};
+        // sweep ranges; log is swept over ln x in [-69, 69] instead
+        const double lo[] = {-87.0, -69.0, -30.0, -10.0, -20.0};
+        const double hi[] = {88.0, 69.0, 30.0, 10.0, 0.0};
+
+        cten_set_math_mode(cten_MathMode_Fast);
+        for(int f = 0; f < 5; f++) {
+            for(int i = 0; i < n; i++) {
+                double v = lo[f] + (hi[f] - lo[f]) * i / (n - 1);
+                x_data[i] = (float)(f == 1 ? exp(v) : v);
+            }
+            Tensor x = create_test_tensor((TensorShape){n}, x_data, false);
+            Tensor y;
+            switch(f) {
+                case 0: y = nn_exp(x); break;
+                case 1: y = nn_log(x); break;
+                case 2: y = nn_sigmoid(x); break;
+                case 3: y = nn_tanh(x); break;
+                default: y = nn_elu(x, 1.0f); break;
+            }
+            double max_err = 0.0;
+            for(int i = 0; i < n; i++) {
+                double xd = x_data[i], ref;
+                switch(f) {
+                    case 0: ref = exp(xd); break;
+                    case 1: ref = log(xd); break;
+                    case 2: ref = 1.0 / (1.0 + exp(-xd)); break;
+                    case 3: ref = tanh(xd); break;
+                    default: ref = expm1(xd); break;
+                }
+                max_err = fmax(max_err, ulp_error(y.data->flex[i], ref));
+            }
+            char detail[64];
+            snprintf(detail,
+                     sizeof(detail),
+                     "%s_%.2f_ulp/" PLATFORM_NAME,
+                     names[f],
+                     max_err);
+            csv_reporter_record_result(op_name,
+                                       tc_name,
+                                       f + 1,
+                                       max_err <= bounds[f] ? "/" : detail);
+        }
+        cten_set_math_mode(cten_MathMode_Precise);
+    }
+
+    // Test Case 4: Fast math keeps the special values of libm
+    {
+        const char* tc_name = "fast_math_special_values";
+        float x_data[] = {INFINITY, -INFINITY, NAN, 0.0f, -1.0f, 100.0f, -100.0f, 1e-40f};
+        TensorShape shape = {8};
+        cten_set_math_mode(cten_MathMode_Fast);
+        Tensor x = create_test_tensor(shape, x_data, false);
+        const float* e = nn_exp(x).data->flex;
+        const float* l = nn_log(x).data->flex;
+        const float* s = nn_sigmoid(x).data->flex;
+        const float* t = nn_tanh(x).data->flex;
+        cten_set_math_mode(cten_MathMode_Precise);
+
+        bool exp_ok = isinf(e[0]) && e[0] > 0 && e[1] == 0.0f && isnan(e[2]) && e[3] == 1.0f &&
+                      isinf(e[5]) && e[6] == 0.0f;
+        bool log_ok = isinf(l[0]) && l[0] > 0 && isnan(l[1]) && isnan(l[2]) && isinf(l[3]) &&
+                      l[3] < 0 && isnan(l[4]) && fabsf(l[7] - logf(1e-40f)) < 1e-4f;
+        bool sigmoid_ok = s[0] == 1.0f && s[1] == 0.0f && isnan(s[2]) && s[3] == 0.5f;
+        bool tanh_ok = t[0] == 1.0f && t[1] == -1.0f && isnan(t[2]) && t[3] == 0.0f;
+        csv_reporter_record_result(op_name, tc_name, 1, exp_ok ? "/" : "exp/" PLATFORM_NAME);
+        csv_reporter_record_result(op_name, tc_name, 2, log_ok ? "/" : "log/" PLATFORM_NAME);
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   3,
+                                   sigmoid_ok ? "/" : "sigmoid/" PLATFORM_NAME);
+        csv_reporter_record_result(op_name, tc_name, 4, tanh_ok ? "/" : "tanh/" PLATFORM_NAME);
+    }
+
+    cten_free(pool_id);
+}
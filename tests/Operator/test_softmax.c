@@ -2,6 +2,7 @@
 #include "../test_utils.h"
 #include "../csv_reporter.h"
 #include "../test_config.h"
+#include <math.h>
 #include <stdio.h>
 
 void test_softmax_operator() {
@@ -306,5 +307,33 @@ void test_softmax_operator() {
         compare_tensors(&t_output_10, &t_expected_10, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
     }
 
+    // Test Case 11: Long rows over the last dimension, spanning more than one chunk of rows
+    {
+        const char* tc_name = "softmax_long_rows_last_dim";
+        enum { rows = 5, cols = 1000 };
+        static float input[rows * cols], expected[rows * cols];
+        for(int i = 0; i < rows * cols; i++) {
+            input[i] = (float)((i * 37) % 101) * 0.2f - 10.0f + (i / cols) * 50.0f;
+        }
+        for(int r = 0; r < rows; r++) {
+            const float* x = input + r * cols;
+            double max_val = x[0], sum = 0.0;
+            for(int k = 1; k < cols; k++) {
+                max_val = fmax(max_val, x[k]);
+            }
+            for(int k = 0; k < cols; k++) {
+                sum += exp(x[k] - max_val);
+            }
+            for(int k = 0; k < cols; k++) {
+                expected[r * cols + k] = (float)(exp(x[k] - max_val) / sum);
+            }
+        }
+        TensorShape shape = {rows, cols};
+        Tensor t_input = create_test_tensor(shape, input, false);
+        Tensor t_output = nn_softmax(t_input, 1);
+        Tensor t_expected = create_test_tensor(shape, expected, false);
+        compare_tensors(&t_output, &t_expected, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
     cten_free(pool_id);
 }
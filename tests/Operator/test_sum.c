@@ -2,6 +2,7 @@
 #include "../test_utils.h"
 #include "../csv_reporter.h"
 #include "../test_config.h"
+#include <math.h>
 #include <stdio.h>
 
 void test_sum_operator() {
@@ -217,5 +218,43 @@ void test_sum_operator() {
         }
     }
 
+    // Test Case 6: Reduction on a rank-5 tensor
+    {
+        const char* tc_name = "sum_high_rank_dim";
+        TensorShape s1 = {1, 2, 1, 2, 3};
+        float d1[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+        TensorShape exp_shape = {1, 2, 1, 3};
+        float exp_d[] = {5.0f, 7.0f, 9.0f, 17.0f, 19.0f, 21.0f};
+
+        Tensor t1 = create_test_tensor(s1, d1, false);
+        Tensor expected_res = create_test_tensor(exp_shape, exp_d, false);
+        Tensor actual_res = Tensor_sum(t1, 3);
+
+        compare_tensors(&actual_res, &expected_res, op_name, tc_name, 1, TEST_FLOAT_TOLERANCE);
+    }
+
+    // Test Case 7: Long sums stay accurate and give the same bits on every call
+    {
+        const char* tc_name = "sum_all_long_accurate_deterministic";
+        const int n = 1 << 21;
+        Tensor t = Tensor_new((TensorShape){n}, false);
+        for(int i = 0; i < n; i++) {
+            t.data->flex[i] = 0.1f;
+        }
+        // a serial float sum drifts by ~1e-2 relative here, a pairwise one stays within ~1e-6
+        double exact = (double)n * 0.1f;
+        float first = Tensor_sum(t).data->flex[0];
+        float second = Tensor_sum(t).data->flex[0];
+        bool accurate = fabs(first - exact) <= 1e-5 * exact;
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   1,
+                                   accurate ? "/" : "inaccurate/" PLATFORM_NAME);
+        csv_reporter_record_result(op_name,
+                                   tc_name,
+                                   2,
+                                   first == second ? "/" : "nondeterministic/" PLATFORM_NAME);
+    }
+
     cten_free(pool_id);
 }
@@ -0,0 +1,162 @@
+#include "../../include/cten.h"
+#include "../test_utils.h"
+#include "../csv_reporter.h"
+#include "../test_config.h"
+#include <stdio.h>
+#include <string.h>
+
+// Every op is sized above its threading threshold and run on one thread and on four; the pool
+// splits work so that each element is computed exactly as on one thread, so results must match
+// bit for bit.
+#define THREADS 4
+
+static Tensor filled_tensor(TensorShape shape, int seed, bool requires_grad) {
+    Tensor t = Tensor_new(shape, requires_grad);
+    for(size_t i = 0; i < t.numel; i++) {
+        t.data->flex[i] = (float)((i * 7919 + seed * 104729) % 1013) / 1013.0f - 0.5f;
+    }
+    return t;
+}
+
+static void record_same_bits(const char* op_name,
+                             const char* tc_name,
+                             int sub_test,
+                             Tensor serial,
+                             Tensor threaded) {
+    bool same = serial.numel == threaded.numel &&
+                memcmp(serial.data->flex, threaded.data->flex, sizeof(float) * serial.numel) == 0;
+    csv_reporter_record_result(op_name,
+                               tc_name,
+                               sub_test,
+                               same ? "/" : "threaded_result_differs/" PLATFORM_NAME);
+}
+
+void test_threads_operator() {
+    const char* op_name = "threads";
+    PoolId pool_id = 0;
+    cten_begin_malloc(pool_id);
+    int saved_threads = cten_num_threads();
+
+    // Test Case 1: The requested thread count is the one reported
+    {
+        const char* tc_name = "set_num_threads";
+        int got = cten_set_num_threads(THREADS);
+        bool ok = got == THREADS && cten_num_threads() == THREADS;
+        csv_reporter_record_result(op_name, tc_name, 1, ok ? "/" : "count_mismatch/" PLATFORM_NAME);
+    }
+
+    // Test Case 2: Elementwise ops
+    {
+        const char* tc_name = "elementwise_matches_serial";
+        Tensor x = filled_tensor((TensorShape){200000}, 1, false);
+        Tensor y = filled_tensor((TensorShape){200000}, 2, false);
+        Tensor res[2][2];
+        for(int t = 0; t < 2; t++) {
+            cten_set_num_threads(t == 0 ? 1 : THREADS);
+            res[t][0] = Tensor_add(x, y);
+            res[t][1] = nn_sigmoid(x);
+        }
+        record_same_bits(op_name, tc_name, 1, res[0][0], res[1][0]);
+        record_same_bits(op_name, tc_name, 2, res[0][1], res[1][1]);
+    }
+
+    // Test Case 3: Matrix product with a ragged row count, and its gradient
+    {
+        const char* tc_name = "matmul_matches_serial";
+        Tensor a = filled_tensor((TensorShape){149, 128}, 3, true);
+        Tensor b = filled_tensor((TensorShape){128, 160}, 4, false);
+        Tensor res[2], grad[2];
+        for(int t = 0; t < 2; t++) {
+            cten_set_num_threads(t == 0 ? 1 : THREADS);
+            a.node->grad = (Tensor){0};
+            res[t] = Tensor_matmul(a, b);
+            Tensor_backward(Tensor_sum(res[t]), (Tensor){0});
+            grad[t] = a.node->grad;
+        }
+        record_same_bits(op_name, tc_name, 1, res[0], res[1]);
+        record_same_bits(op_name, tc_name, 2, grad[0], grad[1]);
+    }
+
+    // Test Case 4: Reductions split by output rows and by columns
+    {
+        const char* tc_name = "reduce_matches_serial";
+        Tensor x = filled_tensor((TensorShape){256, 512}, 5, false);
+        int dims[] = {1, 0};
+        Tensor res[2][3];
+        for(int t = 0; t < 2; t++) {
+            cten_set_num_threads(t == 0 ? 1 : THREADS);
+            res[t][0] = Tensor_reduce(x, TensorReduceOp_Sum, &dims[0], 1, false);
+            res[t][1] = Tensor_reduce(x, TensorReduceOp_Sum, &dims[1], 1, false);
+            res[t][2] = Tensor_reduce(x, TensorReduceOp_LogSumExp, &dims[0], 1, false);
+        }
+        for(int k = 0; k < 3; k++) {
+            record_same_bits(op_name, tc_name, k + 1, res[0][k], res[1][k]);
+        }
+    }
+
+    // Test Case 5: Softmax, log-softmax and the fused loss, forward and backward
+    {
+        const char* tc_name = "softmax_matches_serial";
+        Tensor logits = filled_tensor((TensorShape){64, 1000}, 6, true);
+        Tensor labels = Tensor_new((TensorShape){64}, false);
+        for(int i = 0; i < 64; i++) {
+            labels.data->flex[i] = (float)((i * 37) % 1000);
+        }
+        labels = Tensor_to(labels, TensorDType_I32);
+        Tensor res[2][3];
+        for(int t = 0; t < 2; t++) {
+            cten_set_num_threads(t == 0 ? 1 : THREADS);
+            res[t][0] = nn_softmax(logits, 1);
+            res[t][1] = nn_log_softmax(logits, 1);
+            logits.node->grad = (Tensor){0};
+            Tensor_backward(nn_softmax_crossentropy(labels, logits), (Tensor){0});
+            res[t][2] = logits.node->grad;
+        }
+        for(int k = 0; k < 3; k++) {
+            record_same_bits(op_name, tc_name, k + 1, res[0][k], res[1][k]);
+        }
+    }
+
+    // Test Case 6: Optimizer step
+    {
+        const char* tc_name = "adam_matches_serial";
+        Tensor params[2];
+        for(int t = 0; t < 2; t++) {
+            cten_set_num_threads(t == 0 ? 1 : THREADS);
+            params[t] = filled_tensor((TensorShape){100000}, 7, true);
+            params[t].node->grad = filled_tensor((TensorShape){100000}, 8, false);
+            optim_adam* optim = optim_adam_new(1, &params[t], 0.01f, 0.9f, 0.999f, 1e-8f, 0.01f);
+            optim_adam_step(optim);
+            optim_adam_step(optim);
+        }
+        record_same_bits(op_name, tc_name, 1, params[0], params[1]);
+    }
+
+    // Test Case 7: Batched products split by whole products, and by rows when there are few
+    {
+        const char* tc_name = "batched_matmul_matches_serial";
+        // {batch, m, k, n}
+        const int shapes[][4] = {
+            {64, 32, 64, 32},
+            {2, 128, 128, 96},
+        };
+        for(int s = 0; s < 2; s++) {
+            int bs = shapes[s][0], m = shapes[s][1], k = shapes[s][2], n = shapes[s][3];
+            Tensor a = filled_tensor((TensorShape){bs, m, k}, 7 + s, true);
+            Tensor b = filled_tensor((TensorShape){bs, k, n}, 9 + s, true);
+            Tensor res[2], grad[2];
+            for(int t = 0; t < 2; t++) {
+                cten_set_num_threads(t == 0 ? 1 : THREADS);
+                b.node->grad = (Tensor){0};
+                res[t] = Tensor_matmul(a, b);
+                Tensor_backward(Tensor_sum(res[t]), (Tensor){0});
+                grad[t] = b.node->grad;
+            }
+            record_same_bits(op_name, tc_name, s * 2 + 1, res[0], res[1]);
+            record_same_bits(op_name, tc_name, s * 2 + 2, grad[0], grad[1]);
+        }
+    }
+
+    cten_set_num_threads(saved_threads);
+    cten_free(pool_id);
+}
@@ -29,6 +29,17 @@ void test_max_operator();
 void test_min_operator();
 void test_abs_operator();
 void test_softmax_operator();
+void test_from_buffer_operator();
+void test_dtype_operator();
+void test_quantize_operator();
+void test_crossentropy_operator();
+void test_simd_operator();
+void test_reduce_operator();
+void test_log_softmax_operator();
+void test_threads_operator();
+void test_context_operator();
+void test_data_parallel_operator();
+void test_hogwild_operator();
 
 // Backward tests
 void test_add_backward();
@@ -45,6 +56,8 @@ void test_div_backward();
 void test_pow_backward();
 void test_abs_backward();
 void test_softmax_backward();
+void test_reduce_backward();
+void test_log_softmax_backward();
 
 int main() {
     printf("Starting cTensor Test Suite on %s...\n", PLATFORM_NAME);
@@ -125,6 +138,39 @@ int main() {
     test_softmax_operator();
     printf("Softmax operator tests finished.\n");
 
+    test_from_buffer_operator();
+    printf("From-buffer operator tests finished.\n");
+
+    test_dtype_operator();
+    printf("Dtype operator tests finished.\n");
+
+    test_quantize_operator();
+    printf("Quantize operator tests finished.\n");
+
+    test_crossentropy_operator();
+    printf("Crossentropy operator tests finished.\n");
+
+    test_simd_operator();
+    printf("SIMD operator tests finished.\n");
+
+    test_reduce_operator();
+    printf("Reduce operator tests finished.\n");
+
+    test_log_softmax_operator();
+    printf("Log-softmax operator tests finished.\n");
+
+    test_threads_operator();
+    printf("Thread pool tests finished.\n");
+
+    test_context_operator();
+    printf("Context tests finished.\n");
+
+    test_data_parallel_operator();
+    printf("Data-parallel tests finished.\n");
+
+    test_hogwild_operator();
+    printf("Hogwild tests finished.\n");
+
     // Backward tests
     test_add_backward();
     printf("Add backward tests finished.\n");
@@ -168,6 +214,12 @@ int main() {
     test_softmax_backward();
     printf("Softmax backward tests finished.\n");
 
+    test_reduce_backward();
+    printf("Reduce backward tests finished.\n");
+
+    test_log_softmax_backward();
+    printf("Log-softmax backward tests finished.\n");
+
     // other tests
 
     csv_reporter_close();
@@ -13,6 +13,6 @@
 #define PLATFORM_NAME "unknown"
 #endif
 
-#define CTENSOR_MAX_DIMS 4
+#define CTENSOR_MAX_DIMS 8
 
 #endif
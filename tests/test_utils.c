@@ -178,16 +178,19 @@ bool compare_tensors(const Tensor* t_observed,
     // tensors of same shape)
     if(numel_obs == 0) { return true; }
 
-    // 4. Compare data element-wise (only if data buffers are not NULL and numel > 0)
+    // 4. Compare data element-wise (only if data buffers are not NULL and numel > 0), reading
+    // int32 and reduced-precision storage as float32
+    const float* obs_vals = Tensor_to(*t_observed, TensorDType_F32).data->flex;
+    const float* exp_vals = Tensor_to(*t_expected, TensorDType_F32).data->flex;
     for(size_t i = 0; i < numel_obs; ++i) {
-        if(!compare_floats(t_observed->data->flex[i], t_expected->data->flex[i], tolerance)) {
+        if(!compare_floats(obs_vals[i], exp_vals[i], tolerance)) {
             snprintf(failure_detail_buffer,
                      sizeof(failure_detail_buffer),
                      "%.*g/%.*g/%s",
                      15,
-                     t_observed->data->flex[i],
+                     obs_vals[i],
                      15,
-                     t_expected->data->flex[i],
+                     exp_vals[i],
                      PLATFORM_NAME);
             csv_reporter_record_result(operator_name,
                                        test_point_name,
@@ -201,3 +204,22 @@ bool compare_tensors(const Tensor* t_observed,
     csv_reporter_record_result(operator_name, test_point_name, sub_test_index, "/");
     return true;
 }
+
+TestMlp create_test_mlp(uint64_t seed, int n_in, int n_hidden, int n_out) {
+    cten_seed(seed);
+    TestMlp m;
+    m.w1 = Glorot_init((TensorShape){n_in, n_hidden}, true);
+    m.b1 = Tensor_zeros((TensorShape){1, n_hidden}, true);
+    m.w2 = Glorot_init((TensorShape){n_hidden, n_out}, true);
+    m.b2 = Tensor_zeros((TensorShape){1, n_out}, true);
+    return m;
+}
+
+void create_test_sine_data(Tensor* x, Tensor* y, int n) {
+    *x = Tensor_new((TensorShape){n, 1}, false);
+    *y = Tensor_new((TensorShape){n, 1}, false);
+    for(int i = 0; i < n; i++) {
+        x->data->flex[i] = (float)((i * 37) % 101) / 101.0f * 6.0f - 3.0f;
+        y->data->flex[i] = sinf(x->data->flex[i]);
+    }
+}
@@ -14,4 +14,15 @@ bool compare_tensors(const Tensor* t_observed,
 Tensor create_test_tensor(TensorShape shape, float* data, bool requires_grad);
 void print_tensor(const Tensor* t, const char* name);
 
+// A two-layer model for the trainer tests; its address doubles as an array of 4 parameters
+typedef struct {
+    Tensor w1, b1;
+    Tensor w2, b2;
+} TestMlp;
+
+// Glorot weights drawn after cten_seed(seed), zero biases
+TestMlp create_test_mlp(uint64_t seed, int n_in, int n_hidden, int n_out);
+// n samples of y = sin(x) for x spread over [-3, 3), as [n, 1] tensors in a fixed order
+void create_test_sine_data(Tensor* x, Tensor* y, int n);
+
 #endif